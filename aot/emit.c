@@ -0,0 +1,447 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <inttypes.h>
+
+#include "aot.h"
+
+// Everything the blocks need besides the interface itself. Division has to
+// give exactly what psycho_cpu_step() gives, including for the cases C leaves
+// undefined.
+static const char prelude[] =
+	"// Generated by psycho-aot; do not edit.\n"
+	"\n"
+	"#include \"core/ir.h\"\n"
+	"\n"
+	"#define HI v[PSYCHO_IR_VREG_HI]\n"
+	"#define LO v[PSYCHO_IR_VREG_LO]\n"
+	"\n"
+	"static inline void div_signed(u32 *const v, const u32 a,\n"
+	"\t\t\t\t      const u32 b)\n"
+	"{\n"
+	"\tif (!b) {\n"
+	"\t\tLO = ((s32)a < 0) ? 0x00000001 : UINT32_MAX;\n"
+	"\t\tHI = a;\n"
+	"\t} else if ((a == 0x80000000) && (b == UINT32_MAX)) {\n"
+	"\t\tLO = a;\n"
+	"\t\tHI = 0x00000000;\n"
+	"\t} else {\n"
+	"\t\tLO = (s32)a / (s32)b;\n"
+	"\t\tHI = (s32)a % (s32)b;\n"
+	"\t}\n"
+	"}\n"
+	"\n"
+	"static inline void div_unsigned(u32 *const v, const u32 a,\n"
+	"\t\t\t\t\tconst u32 b)\n"
+	"{\n"
+	"\tif (!b) {\n"
+	"\t\tLO = UINT32_MAX;\n"
+	"\t\tHI = a;\n"
+	"\t} else {\n"
+	"\t\tLO = a / b;\n"
+	"\t\tHI = a % b;\n"
+	"\t}\n"
+	"}\n";
+
+// The C operators of the operations which map onto one directly.
+static const char *const binary_ops[] = {
+	// clang-format off
+
+	[PSYCHO_IR_OP_ADD]	= "+",
+	[PSYCHO_IR_OP_SUB]	= "-",
+	[PSYCHO_IR_OP_AND]	= "&",
+	[PSYCHO_IR_OP_OR]	= "|",
+	[PSYCHO_IR_OP_XOR]	= "^",
+	[PSYCHO_IR_OP_SLTU]	= "<",
+	[PSYCHO_IR_OP_SEQ]	= "==",
+	[PSYCHO_IR_OP_SNE]	= "!="
+
+	// clang-format on
+};
+
+static const char *const imm_ops[] = {
+	// clang-format off
+
+	[PSYCHO_IR_OP_ADDI]	= "+",
+	[PSYCHO_IR_OP_ANDI]	= "&",
+	[PSYCHO_IR_OP_ORI]	= "|",
+	[PSYCHO_IR_OP_XORI]	= "^",
+	[PSYCHO_IR_OP_SLTIU]	= "<",
+	[PSYCHO_IR_OP_SLL]	= "<<",
+	[PSYCHO_IR_OP_SRL]	= ">>"
+
+	// clang-format on
+};
+
+static const char *const zero_cmp_ops[] = {
+	// clang-format off
+
+	[PSYCHO_IR_OP_SLEZ]	= "<=",
+	[PSYCHO_IR_OP_SGTZ]	= ">",
+	[PSYCHO_IR_OP_SLTZ]	= "<",
+	[PSYCHO_IR_OP_SGEZ]	= ">="
+
+	// clang-format on
+};
+
+// Looks up the C operator of an operation in one of the tables above.
+static const char *c_op(const char *const *const table, const size_t num,
+			const uint code)
+{
+	return (code < num) ? table[code] : NULL;
+}
+
+static void emit_op(FILE *const out, const struct psycho_ir_block *const block,
+		    const struct psycho_ir_op *const op)
+{
+	const uint d = op->dst;
+	const uint a = op->a;
+	const uint b = op->b;
+	const u32 imm = op->imm;
+
+	const char *c;
+
+	c = c_op(binary_ops, sizeof(binary_ops) / sizeof(binary_ops[0]),
+		 op->code);
+
+	if (c) {
+		fprintf(out, "\tv[%u] = v[%u] %s v[%u];\n", d, a, c, b);
+		return;
+	}
+
+	c = c_op(imm_ops, sizeof(imm_ops) / sizeof(imm_ops[0]), op->code);
+
+	if (c) {
+		fprintf(out, "\tv[%u] = v[%u] %s 0x%08" PRIX32 "U;\n", d, a, c,
+			imm);
+		return;
+	}
+
+	c = c_op(zero_cmp_ops, sizeof(zero_cmp_ops) / sizeof(zero_cmp_ops[0]),
+		 op->code);
+
+	if (c) {
+		fprintf(out, "\tv[%u] = (s32)v[%u] %s 0;\n", d, a, c);
+		return;
+	}
+
+	switch (op->code) {
+	case PSYCHO_IR_OP_NOP:
+		return;
+
+	case PSYCHO_IR_OP_CONST:
+		fprintf(out, "\tv[%u] = 0x%08" PRIX32 "U;\n", d, imm);
+		return;
+
+	case PSYCHO_IR_OP_MOV:
+		fprintf(out, "\tv[%u] = v[%u];\n", d, a);
+		return;
+
+	case PSYCHO_IR_OP_NOR:
+		fprintf(out, "\tv[%u] = ~(v[%u] | v[%u]);\n", d, a, b);
+		return;
+
+	case PSYCHO_IR_OP_SLT:
+		fprintf(out, "\tv[%u] = (s32)v[%u] < (s32)v[%u];\n", d, a, b);
+		return;
+
+	case PSYCHO_IR_OP_SLTI:
+		fprintf(out, "\tv[%u] = (s32)v[%u] < (s32)0x%08" PRIX32 "U;\n",
+			d, a, imm);
+		return;
+
+	case PSYCHO_IR_OP_SRA:
+		fprintf(out, "\tv[%u] = (s32)v[%u] >> %" PRIu32 ";\n", d, a,
+			imm);
+		return;
+
+	case PSYCHO_IR_OP_SLLV:
+		fprintf(out, "\tv[%u] = v[%u] << (v[%u] & 31);\n", d, a, b);
+		return;
+
+	case PSYCHO_IR_OP_SRLV:
+		fprintf(out, "\tv[%u] = v[%u] >> (v[%u] & 31);\n", d, a, b);
+		return;
+
+	case PSYCHO_IR_OP_SRAV:
+		fprintf(out, "\tv[%u] = (s32)v[%u] >> (v[%u] & 31);\n", d, a,
+			b);
+		return;
+
+	case PSYCHO_IR_OP_MULT:
+		fprintf(out,
+			"\t{\n"
+			"\t\tconst u64 prod = (u64)((s64)(s32)v[%u] * "
+			"(s32)v[%u]);\n"
+			"\t\tLO = (u32)prod;\n"
+			"\t\tHI = prod >> 32;\n"
+			"\t}\n",
+			a, b);
+		return;
+
+	case PSYCHO_IR_OP_MULTU:
+		fprintf(out,
+			"\t{\n"
+			"\t\tconst u64 prod = (u64)v[%u] * v[%u];\n"
+			"\t\tLO = (u32)prod;\n"
+			"\t\tHI = prod >> 32;\n"
+			"\t}\n",
+			a, b);
+		return;
+
+	case PSYCHO_IR_OP_DIV:
+		fprintf(out, "\tdiv_signed(v, v[%u], v[%u]);\n", a, b);
+		return;
+
+	case PSYCHO_IR_OP_DIVU:
+		fprintf(out, "\tdiv_unsigned(v, v[%u], v[%u]);\n", a, b);
+		return;
+
+	case PSYCHO_IR_OP_LB:
+		fprintf(out,
+			"\tv[%u] = (s8)bus->load_byte(ctx, v[%u] + "
+			"0x%08" PRIX32 "U);\n",
+			d, a, imm);
+		return;
+
+	case PSYCHO_IR_OP_LBU:
+		fprintf(out,
+			"\tv[%u] = bus->load_byte(ctx, v[%u] + "
+			"0x%08" PRIX32 "U);\n",
+			d, a, imm);
+		return;
+
+	case PSYCHO_IR_OP_LH:
+		fprintf(out,
+			"\tv[%u] = (s16)bus->load_halfword(ctx, v[%u] + "
+			"0x%08" PRIX32 "U);\n",
+			d, a, imm);
+		return;
+
+	case PSYCHO_IR_OP_LHU:
+		fprintf(out,
+			"\tv[%u] = bus->load_halfword(ctx, v[%u] + "
+			"0x%08" PRIX32 "U);\n",
+			d, a, imm);
+		return;
+
+	case PSYCHO_IR_OP_LW:
+		fprintf(out,
+			"\tv[%u] = bus->load_word(ctx, v[%u] + "
+			"0x%08" PRIX32 "U);\n",
+			d, a, imm);
+		return;
+
+	case PSYCHO_IR_OP_SB:
+		fprintf(out,
+			"\tbus->store_byte(ctx, v[%u] + 0x%08" PRIX32
+			"U, (u8)v[%u]);\n",
+			a, imm, b);
+		return;
+
+	case PSYCHO_IR_OP_SH:
+		fprintf(out,
+			"\tbus->store_halfword(ctx, v[%u] + 0x%08" PRIX32
+			"U, (u16)v[%u]);\n",
+			a, imm, b);
+		return;
+
+	case PSYCHO_IR_OP_SW:
+		fprintf(out,
+			"\tbus->store_word(ctx, v[%u] + 0x%08" PRIX32
+			"U, v[%u]);\n",
+			a, imm, b);
+		return;
+
+	case PSYCHO_IR_OP_LWL:
+		fprintf(out,
+			"\t{\n"
+			"\t\tconst u32 addr = v[%u] + 0x%08" PRIX32 "U;\n"
+			"\t\tconst u32 shift = (addr & 3) * 8;\n"
+			"\t\tconst u32 word = "
+			"bus->load_word(ctx, addr & ~3U);\n"
+			"\t\tv[%u] = (v[%u] & (0x00FFFFFFU >> shift)) |\n"
+			"\t\t\t(word << (24 - shift));\n"
+			"\t}\n",
+			a, imm, d, b);
+		return;
+
+	case PSYCHO_IR_OP_LWR:
+		fprintf(out,
+			"\t{\n"
+			"\t\tconst u32 addr = v[%u] + 0x%08" PRIX32 "U;\n"
+			"\t\tconst u32 shift = (addr & 3) * 8;\n"
+			"\t\tconst u32 word = "
+			"bus->load_word(ctx, addr & ~3U);\n"
+			"\t\tv[%u] = (v[%u] & "
+			"(0xFFFFFF00U << (24 - shift))) |\n"
+			"\t\t\t(word >> shift);\n"
+			"\t}\n",
+			a, imm, d, b);
+		return;
+
+	case PSYCHO_IR_OP_SWL:
+		fprintf(out,
+			"\t{\n"
+			"\t\tconst u32 addr = v[%u] + 0x%08" PRIX32 "U;\n"
+			"\t\tconst u32 shift = (addr & 3) * 8;\n"
+			"\t\tconst u32 word = "
+			"bus->load_word(ctx, addr & ~3U);\n"
+			"\t\tbus->store_word(ctx, addr & ~3U,\n"
+			"\t\t\t(word & (0xFFFFFF00U << shift)) |\n"
+			"\t\t\t(v[%u] >> (24 - shift)));\n"
+			"\t}\n",
+			a, imm, b);
+		return;
+
+	case PSYCHO_IR_OP_SWR:
+		fprintf(out,
+			"\t{\n"
+			"\t\tconst u32 addr = v[%u] + 0x%08" PRIX32 "U;\n"
+			"\t\tconst u32 shift = (addr & 3) * 8;\n"
+			"\t\tconst u32 word = "
+			"bus->load_word(ctx, addr & ~3U);\n"
+			"\t\tbus->store_word(ctx, addr & ~3U,\n"
+			"\t\t\t(word & (0x00FFFFFFU >> (24 - shift))) |\n"
+			"\t\t\t(v[%u] << shift));\n"
+			"\t}\n",
+			a, imm, b);
+		return;
+
+	case PSYCHO_IR_OP_GUARD_ADD:
+		fprintf(out,
+			"\tif (__builtin_add_overflow((s32)v[%u], (s32)v[%u], "
+			"&(s32){ 0 }))\n"
+			"\t\treturn %u;\n",
+			a, b, d);
+		return;
+
+	case PSYCHO_IR_OP_GUARD_ADDI:
+		fprintf(out,
+			"\tif (__builtin_add_overflow((s32)v[%u], "
+			"(s32)0x%08" PRIX32 "U, &(s32){ 0 }))\n"
+			"\t\treturn %u;\n",
+			a, imm, d);
+		return;
+
+	case PSYCHO_IR_OP_GUARD_SUB:
+		fprintf(out,
+			"\tif (__builtin_sub_overflow((s32)v[%u], (s32)v[%u], "
+			"&(s32){ 0 }))\n"
+			"\t\treturn %u;\n",
+			a, b, d);
+		return;
+
+	case PSYCHO_IR_OP_GUARD_ALIGN2:
+		fprintf(out,
+			"\tif ((v[%u] + 0x%08" PRIX32 "U) & 1)\n"
+			"\t\treturn %u;\n",
+			a, imm, d);
+		return;
+
+	case PSYCHO_IR_OP_GUARD_ALIGN4:
+		fprintf(out,
+			"\tif ((v[%u] + 0x%08" PRIX32 "U) & 3)\n"
+			"\t\treturn %u;\n",
+			a, imm, d);
+		return;
+
+	case PSYCHO_IR_OP_GUARD_CODE:
+		fprintf(out,
+			"\tif (((bus->paddr(v[%u] + 0x%08" PRIX32
+			"U) & ~3U) - 0x%08" PRIX32 "U) < %zuU)\n"
+			"\t\treturn %u;\n",
+			a, imm, block->paddr,
+			block->instrs_num * sizeof(u32), d);
+		return;
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+static void emit_block(FILE *const out,
+		       const struct psycho_ir_block *const block)
+{
+	fprintf(out,
+		"\nstatic const u32 words_%08" PRIX32 "[] = {",
+		block->pc);
+
+	for (uint i = 0; i < block->instrs_num; ++i) {
+		const char *const sep = !i ? "\n\t" : (i % 6) ? ", " : ",\n\t";
+		fprintf(out, "%s0x%08" PRIX32, sep, block->words[i]);
+	}
+
+	fprintf(out,
+		"\n};\n"
+		"\n"
+		"static uint block_%08" PRIX32
+		"(struct psycho_ctx *const ctx,\n"
+		"\tconst struct psycho_ir_native_bus *const bus,\n"
+		"\tu32 *const v)\n"
+		"{\n"
+		"\t(void)ctx;\n"
+		"\t(void)bus;\n"
+		"\n",
+		block->pc);
+
+	for (uint i = 0; i < block->ops_num; ++i)
+		emit_op(out, block, &block->ops[i]);
+
+	fprintf(out, "\treturn %u;\n}\n", block->instrs_num);
+}
+
+bool aot_emit(FILE *const out, const struct aot_program *const prog)
+{
+	fputs(prelude, out);
+
+	for (size_t i = 0; i < prog->blocks_num; ++i)
+		emit_block(out, &prog->blocks[i]);
+
+	fputs("\nstatic const struct psycho_ir_native natives[] = {\n", out);
+
+	for (size_t i = 0; i < prog->blocks_num; ++i) {
+		const struct psycho_ir_block *const block = &prog->blocks[i];
+
+		fprintf(out,
+			"\t{ 0x%08" PRIX32 ", words_%08" PRIX32 ", %u, %u, "
+			"block_%08" PRIX32 " },\n",
+			block->pc, block->pc, block->instrs_num,
+			block->ops_num, block->pc);
+	}
+
+	fprintf(out,
+		"};\n"
+		"\n"
+		"const struct psycho_ir_native_module %s;\n"
+		"\n"
+		"const struct psycho_ir_native_module %s = {\n"
+		"\t.abi_version = %u,\n"
+		"\t.natives = natives,\n"
+		"\t.natives_num = %zu\n"
+		"};\n",
+		PSYCHO_IR_NATIVE_MODULE_SYMBOL, PSYCHO_IR_NATIVE_MODULE_SYMBOL,
+		(uint)PSYCHO_IR_NATIVE_ABI_VERSION, prog->blocks_num);
+
+	fflush(out);
+	return !ferror(out);
+}
@@ -0,0 +1,392 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "aot.h"
+#include "core/ctx.h"
+#include "core/ir.h"
+#include "frontend/fmap.h"
+
+enum {
+	// clang-format off
+
+	AOT_EXE_OFF_DEST_ADDR	= 0x018,
+	AOT_EXE_OFF_FILE_SIZE	= 0x01C
+
+	// clang-format on
+};
+
+static struct {
+	char *out_file;
+	char *src_file;
+	char *cc;
+	const char *include_dir;
+} aot = {
+	// clang-format off
+
+	.include_dir	= PSYCHO_AOT_INCLUDE_DIR
+
+	// clang-format on
+};
+
+// The discovered blocks, and the addresses still to be looked at.
+static struct {
+	struct aot_program prog;
+	size_t blocks_capacity;
+
+	u32 *pending;
+	size_t pending_num;
+	size_t pending_capacity;
+
+	u8 *visited;
+	u32 text_start;
+	u32 text_size;
+} disc;
+
+static bool pending_push(const u32 pc)
+{
+	// Only the code the EXE brought along is worth compiling; anything
+	// else is either the BIOS, or code which does not exist yet.
+	const u32 off = pc - disc.text_start;
+
+	if ((pc & 3) || (off >= disc.text_size))
+		return true;
+
+	const u32 idx = off / sizeof(u32);
+
+	if (disc.visited[idx / 8] & (1U << (idx % 8)))
+		return true;
+
+	disc.visited[idx / 8] |= 1U << (idx % 8);
+
+	if (disc.pending_num == disc.pending_capacity) {
+		const size_t capacity =
+			disc.pending_capacity ? (disc.pending_capacity * 2) :
+						256;
+		u32 *const pending =
+			realloc(disc.pending, capacity * sizeof(*pending));
+
+		if (!pending)
+			return false;
+
+		disc.pending = pending;
+		disc.pending_capacity = capacity;
+	}
+
+	disc.pending[disc.pending_num++] = pc;
+	return true;
+}
+
+static struct psycho_ir_block *block_alloc(void)
+{
+	struct aot_program *const prog = &disc.prog;
+
+	if (prog->blocks_num == disc.blocks_capacity) {
+		const size_t capacity =
+			disc.blocks_capacity ? (disc.blocks_capacity * 2) : 64;
+		struct psycho_ir_block *const blocks =
+			realloc(prog->blocks, capacity * sizeof(*blocks));
+
+		if (!blocks)
+			return NULL;
+
+		prog->blocks = blocks;
+		disc.blocks_capacity = capacity;
+	}
+	return &prog->blocks[prog->blocks_num];
+}
+
+// Every way out of a block leads to more code: the branch targets, the
+// instruction following the block (where a call returns to), and the
+// instructions following the side exits, which are stepped one at a time.
+static bool successors_push(const struct psycho_ir_block *const block)
+{
+	bool ok = pending_push(block->exits[block->instrs_num].pc);
+
+	if (block->target_kind == PSYCHO_IR_TARGET_COND)
+		ok = ok && pending_push(block->target_alt);
+
+	if ((block->target_kind == PSYCHO_IR_TARGET_CONST) ||
+	    (block->target_kind == PSYCHO_IR_TARGET_COND))
+		ok = ok && pending_push(block->target);
+
+	for (uint i = 0; ok && (i < block->ops_num); ++i) {
+		const struct psycho_ir_op *const op = &block->ops[i];
+
+		if (op->code >= PSYCHO_IR_OP_GUARD_ADD)
+			ok = pending_push(block->exits[op->dst].pc +
+					  sizeof(u32));
+	}
+	return ok;
+}
+
+static bool discover(struct psycho_ctx *const ctx)
+{
+	if (!pending_push(ctx->cpu.pc))
+		return false;
+
+	while (disc.pending_num) {
+		const u32 pc = disc.pending[--disc.pending_num];
+		struct psycho_ir_block *const block = block_alloc();
+
+		if (!block)
+			return false;
+
+		psycho_ir_translate(ctx, block, pc);
+
+		// Whatever cannot be translated is left to the interpreter,
+		// which carries on with the next instruction.
+		if (!block->instrs_num) {
+			if (!pending_push(pc + sizeof(u32)))
+				return false;
+
+			continue;
+		}
+
+		disc.prog.blocks_num++;
+
+		if (!successors_push(block))
+			return false;
+	}
+	return true;
+}
+
+static int block_cmp(const void *const a, const void *const b)
+{
+	const u32 pc_a = ((const struct psycho_ir_block *)a)->pc;
+	const u32 pc_b = ((const struct psycho_ir_block *)b)->pc;
+
+	return (pc_a > pc_b) - (pc_a < pc_b);
+}
+
+static bool compile(char *const src_file)
+{
+	static char shared[] = "-shared";
+	static char pic[] = "-fPIC";
+	static char opt[] = "-O2";
+	static char out[] = "-o";
+
+	char include[4096];
+	snprintf(include, sizeof(include), "-I%s", aot.include_dir);
+
+	char *const args[] = {
+		aot.cc, shared, pic, opt, include, out, aot.out_file, src_file,
+		NULL
+	};
+
+	pid_t pid;
+	const int err = posix_spawnp(&pid, aot.cc, NULL, NULL, args, environ);
+
+	if (err) {
+		errno = err;
+		return false;
+	}
+
+	int status;
+
+	if (waitpid(pid, &status, 0) < 0)
+		return false;
+
+	if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+		errno = ECHILD;
+		return false;
+	}
+	return true;
+}
+
+static bool source_write(const char *const path)
+{
+	FILE *const out = fopen(path, "w");
+
+	if (!out)
+		return false;
+
+	const bool ok = aot_emit(out, &disc.prog);
+	return (fclose(out) == 0) && ok;
+}
+
+static void usage(const char *const argv0)
+{
+	fprintf(stderr,
+		"syntax: %s [options] <exe_file>\n"
+		"\n"
+		"options:\n"
+		"  -o, --output FILE       write the native module to FILE\n"
+		"  -c, --source FILE       write the generated C to FILE\n"
+		"  -C, --cc CC             the C compiler to build with "
+		"(default $CC or cc)\n"
+		"  -I, --include DIR       the psycho core headers\n"
+		"                          (default %s)\n",
+		argv0, PSYCHO_AOT_INCLUDE_DIR);
+}
+
+static bool args_parse(const int argc, char **const argv)
+{
+	static const struct option opts[] = {
+		// clang-format off
+
+		{ "output",	required_argument,	NULL, 'o' },
+		{ "source",	required_argument,	NULL, 'c' },
+		{ "cc",		required_argument,	NULL, 'C' },
+		{ "include",	required_argument,	NULL, 'I' },
+		{ NULL,		0,			NULL, 0 }
+
+		// clang-format on
+	};
+
+	int opt;
+
+	while ((opt = getopt_long(argc, argv, "o:c:C:I:", opts, NULL)) != -1) {
+		switch (opt) {
+		case 'o':
+			aot.out_file = optarg;
+			break;
+
+		case 'c':
+			aot.src_file = optarg;
+			break;
+
+		case 'C':
+			aot.cc = optarg;
+			break;
+
+		case 'I':
+			aot.include_dir = optarg;
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	if (!aot.cc)
+		aot.cc = getenv("CC");
+
+	if (!aot.cc || !aot.cc[0]) {
+		static char cc_default[] = "cc";
+		aot.cc = cc_default;
+	}
+
+	return ((argc - optind) == 1) && (aot.out_file || aot.src_file);
+}
+
+int main(int argc, char **argv)
+{
+	if (!args_parse(argc, argv)) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *const exe_file = argv[optind];
+	struct fmap exe;
+
+	if (!fmap_open(&exe, exe_file)) {
+		fprintf(stderr, "%s: unable to load %s: %s\n", argv[0],
+			exe_file, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	// The BIOS never runs; it only has to exist for the bus.
+	u8 *const ram = calloc(1, RAM_SIZE);
+	u8 *const bios = calloc(1, BIOS_SIZE);
+
+	if (!ram || !bios) {
+		fprintf(stderr, "%s: out of memory\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	static struct psycho_ctx ctx;
+
+	psycho_init(&ctx, &(struct psycho_ctx_cfg){ .ram_data = ram,
+						    .bios_data = bios });
+
+	if (psycho_exe_load(&ctx, exe.data, exe.size) != PSYCHO_OK) {
+		fprintf(stderr, "%s: %s is not a valid PS-X EXE\n", argv[0],
+			exe_file);
+		return EXIT_FAILURE;
+	}
+
+	memcpy(&disc.text_start, &exe.data[AOT_EXE_OFF_DEST_ADDR],
+	       sizeof(u32));
+	memcpy(&disc.text_size, &exe.data[AOT_EXE_OFF_FILE_SIZE],
+	       sizeof(u32));
+
+	disc.visited = calloc(((disc.text_size / sizeof(u32)) + 7) / 8, 1);
+
+	if (!disc.visited || !discover(&ctx)) {
+		fprintf(stderr, "%s: out of memory\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	qsort(disc.prog.blocks, disc.prog.blocks_num,
+	      sizeof(*disc.prog.blocks), block_cmp);
+
+	char tmp_file[] = "/tmp/psycho-aot-XXXXXX.c";
+	char *src_file = aot.src_file;
+
+	if (!src_file) {
+		const int fd = mkstemps(tmp_file, 2);
+
+		if (fd < 0) {
+			fprintf(stderr, "%s: unable to create %s: %s\n",
+				argv[0], tmp_file, strerror(errno));
+			return EXIT_FAILURE;
+		}
+
+		close(fd);
+		src_file = tmp_file;
+	}
+
+	if (!source_write(src_file)) {
+		fprintf(stderr, "%s: unable to write %s: %s\n", argv[0],
+			src_file, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	bool ok = true;
+
+	if (aot.out_file) {
+		ok = compile(src_file);
+
+		if (!ok)
+			fprintf(stderr, "%s: unable to compile %s: %s\n",
+				argv[0], aot.out_file, strerror(errno));
+	}
+
+	if (!aot.src_file)
+		unlink(tmp_file);
+
+	if (ok)
+		printf("%zu blocks\n", disc.prog.blocks_num);
+
+	fmap_close(&exe);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -24,10 +24,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
-#include <sys/stat.h>
+#include <inttypes.h>
+#include <unistd.h>
 
 #include "core/ctx.h"
 #include "core/types.h"
+#include "frontend/bios-image.h"
+#include "frontend/fmap.h"
+#include "frontend/gdb.h"
 
 //Regular bold text
 #define BBLK "\e[1;30m"
@@ -43,12 +47,18 @@
 
 struct {
 	u8 ram[RAM_SIZE];
-	u8 bios[BIOS_SIZE];
+	struct bios_image bios;
 	struct psycho_ctx ctx;
 } static emu;
 
-static u8 *exe_data;
-static size_t exe_size;
+struct watch_arg {
+	u32 addr;
+	u32 size;
+	u8 access;
+};
+
+static struct fmap exe;
+static u32 sideload_hook_id;
 
 static FILE *tty_file;
 
@@ -84,6 +94,25 @@ static void handle_tty_message(const char *const data)
 	fflush(tty_file);
 }
 
+static void handle_watchpoint(const struct psycho_watch_hit *const hit)
+{
+	static const char *const width_name[] = {
+		// clang-format off
+
+		[1]	= "byte",
+		[2]	= "halfword",
+		[4]	= "word"
+
+		// clang-format on
+	};
+
+	printf(BMAG "watchpoint %u: %s %s 0x%08X at pc=0x%08X: 0x%08X -> 0x%08X"
+		    "\n" COLOR_RESET,
+	       hit->id, width_name[hit->width],
+	       (hit->access == PSYCHO_WATCH_WRITE) ? "store to" : "load from",
+	       hit->addr, hit->pc, hit->old_val, hit->new_val);
+}
+
 static void ctx_event_handle(struct psycho_ctx *const ctx,
 			     const enum psycho_event event, void *const data)
 {
@@ -100,89 +129,197 @@ static void ctx_event_handle(struct psycho_ctx *const ctx,
 		handle_tty_message(data);
 		return;
 
+	case PSYCHO_EVENT_WATCHPOINT:
+		handle_watchpoint(data);
+		return;
+
+	case PSYCHO_EVENT_HANG:
+		return;
+
 	default:
 		UNREACHABLE;
 	}
 }
 
+static void sideload_hook(struct psycho_ctx *const ctx, const u32 pc,
+			  void *const udata)
+{
+	(void)pc;
+	(void)udata;
+
+	psycho_hook_remove(ctx, sideload_hook_id);
+
+	if (psycho_exe_load(ctx, exe.data, exe.size) != PSYCHO_OK)
+		__builtin_trap();
+
+	psycho_log_level_set_global(ctx, PSYCHO_LOG_LEVEL_TRACE);
+	psycho_disasm_trace_instruction_enable(ctx, true);
+}
+
 static bool load_bios_file(const char *const bios_file)
 {
-	struct stat st;
-	if (stat(bios_file, &st) < 0)
-		return false;
+	// A supervisor may have already validated the BIOS and handed it down
+	// to us, in which case there's no need to touch the file at all.
+	if (bios_image_inherited())
+		return bios_image_open_inherited(&emu.bios);
 
-	FILE *bios_file_handle = fopen(bios_file, "rb");
+	return bios_image_open(&emu.bios, bios_file);
+}
+
+static bool load_exe_file(const char *const exe_file)
+{
+	return fmap_open(&exe, exe_file);
+}
 
-	if (!bios_file_handle)
+static void usage(const char *const argv0)
+{
+	fprintf(stderr,
+		"syntax: %s [-g PORT|SOCKET] <bios_file> <exe_file|->\n",
+		argv0);
+	fputs("\noptions:\n"
+	      "  -b HASH          refuse a BIOS which does not have the hash "
+	      "HASH\n"
+	      "  -g PORT|SOCKET   wait for gdb on a localhost TCP port or a "
+	      "Unix socket\n"
+	      "  -w ADDR,SIZE[,r|w|rw]\n"
+	      "                   report accesses to a memory range (default: "
+	      "w); may be\n"
+	      "                   given more than once\n",
+	      stderr);
+}
+
+// Hands the emulator over to a debugger until it goes away; returns false if
+// no debugger could be served.
+static bool gdb_run(const char *const argv0, const char *const addr,
+		    bool *const killed)
+{
+	struct gdb gdb;
+
+	if (!gdb_listen(&gdb, &emu.ctx, addr)) {
+		fprintf(stderr, "%s: unable to listen for gdb on %s: %s\n",
+			argv0, addr, strerror(errno));
 		return false;
+	}
+
+	fprintf(stderr, "%s: waiting for gdb on %s\n", argv0, addr);
 
-	const size_t bytes_read =
-		fread(emu.bios, sizeof(u8), sizeof(emu.bios), bios_file_handle);
+	if (!gdb_accept(&gdb)) {
+		fprintf(stderr, "%s: unable to accept gdb: %s\n", argv0,
+			strerror(errno));
+		gdb_close(&gdb);
 
-	if ((bytes_read != sizeof(emu.bios)) || (ferror(bios_file_handle))) {
-		fclose(bios_file_handle);
 		return false;
 	}
+
+	*killed = gdb_serve(&gdb) == GDB_RESULT_KILLED;
+	gdb_close(&gdb);
+
 	return true;
 }
 
-static bool load_exe_file(const char *const exe_file)
+// Parses ADDR,SIZE[,r|w|rw].
+static bool watch_parse(const char *const arg, struct watch_arg *const watch)
 {
-	struct stat st;
-	if (stat(exe_file, &st) < 0)
-		return false;
+	char *end;
 
-	FILE *exe_file_handle = fopen(exe_file, "rb");
+	watch->addr = strtoul(arg, &end, 0);
 
-	if (!exe_file_handle)
+	if (*end++ != ',')
 		return false;
 
-	exe_data = malloc(st.st_size);
+	watch->size = strtoul(end, &end, 0);
+	watch->access = PSYCHO_WATCH_WRITE;
 
-	const size_t bytes_read =
-		fread(exe_data, sizeof(u8), st.st_size, exe_file_handle);
+	if (*end == '\0')
+		return true;
 
-	if ((bytes_read != st.st_size) || (ferror(exe_file_handle))) {
-		fclose(exe_file_handle);
-		free(exe_data);
+	if (*end++ != ',')
+		return false;
 
+	if (strcmp(end, "r") == 0)
+		watch->access = PSYCHO_WATCH_READ;
+	else if (strcmp(end, "rw") == 0)
+		watch->access = PSYCHO_WATCH_READ | PSYCHO_WATCH_WRITE;
+	else if (strcmp(end, "w") != 0)
 		return false;
-	}
-	exe_size = st.st_size;
+
 	return true;
 }
 
 int main(int argc, char **argv)
 {
-	if (argc < 3) {
+	struct watch_arg watches[PSYCHO_WATCHPOINTS_MAX];
+	uint num_watches = 0;
+
+	const char *bios_hash = NULL;
+	const char *gdb_addr = NULL;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "b:g:w:")) != -1) {
+		switch (opt) {
+		case 'b':
+			bios_hash = optarg;
+			break;
+
+		case 'g':
+			gdb_addr = optarg;
+			break;
+
+		case 'w':
+			if ((num_watches == PSYCHO_WATCHPOINTS_MAX) ||
+			    !watch_parse(optarg, &watches[num_watches])) {
+				fprintf(stderr, "%s: bad watchpoint: %s\n",
+					argv[0], optarg);
+				return EXIT_FAILURE;
+			}
+			num_watches++;
+			break;
+
+		default:
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if ((argc - optind) < 2) {
 		fprintf(stderr, "%s: missing required argument.\n", argv[0]);
-		fprintf(stderr, "syntax: %s <bios_file> <exe_file>\n", argv[0]);
+		usage(argv[0]);
 
 		return EXIT_FAILURE;
 	}
 
-	if (!load_bios_file(argv[1])) {
+	const char *const bios_file = argv[optind];
+	const char *const exe_file = argv[optind + 1];
+
+	if (!load_bios_file(bios_file)) {
 		fprintf(stderr,
 			"%s: error encountered loading bios file %s: %s\n",
-			argv[0], argv[1], strerror(errno));
+			argv[0], bios_file, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	if (bios_hash && !bios_image_expect(&emu.bios, bios_hash)) {
+		fprintf(stderr, "%s: bios file %s has the hash %016" PRIX64
+				", not %s\n",
+			argv[0], bios_file, emu.bios.hash, bios_hash);
 		return EXIT_FAILURE;
 	}
 
-	if (!load_exe_file(argv[2])) {
+	if (!load_exe_file(exe_file)) {
 		fprintf(stderr,
 			"%s: error encountered loading exe file %s: %s\n",
-			argv[0], argv[1], strerror(errno));
+			argv[0], exe_file, strerror(errno));
 		return EXIT_FAILURE;
 	}
 
 	tty_file = fopen("tty_file.txt", "w");
 
-	static const struct psycho_ctx_cfg cfg = {
+	const struct psycho_ctx_cfg cfg = {
 		// clang-format off
 
 		.event_cb	= ctx_event_handle,
 		.ram_data	= emu.ram,
-		.bios_data	= emu.bios,
+		.bios_data	= emu.bios.data,
 
 		// clang-format on
 	};
@@ -193,20 +330,25 @@ int main(int argc, char **argv)
 	psycho_log_level_set_global(&emu.ctx, PSYCHO_LOG_LEVEL_TRACE);
 	psycho_disasm_trace_instruction_enable(&emu.ctx, true);
 
-	for (;;) {
-		if (emu.ctx.cpu.pc == 0x80030000) {
-			if (!psycho_exe_load(&emu.ctx, exe_data, exe_size))
-				__builtin_trap();
+	sideload_hook_id = psycho_hook_add(&emu.ctx, EXE_SIDELOAD_PC,
+					   sideload_hook, NULL);
 
-			psycho_log_level_set_global(&emu.ctx,
-						    PSYCHO_LOG_LEVEL_TRACE);
-			psycho_disasm_trace_instruction_enable(&emu.ctx, true);
-		}
+	for (uint i = 0; i < num_watches; ++i)
+		psycho_watch_add(&emu.ctx, watches[i].addr, watches[i].size,
+				 watches[i].access);
 
-		if (emu.ctx.cpu.pc == 0x000000B0)
-			asm("nop");
+	if (gdb_addr) {
+		bool killed;
 
-		psycho_step(&emu.ctx);
+		if (!gdb_run(argv[0], gdb_addr, &killed))
+			return EXIT_FAILURE;
+
+		if (killed)
+			return EXIT_SUCCESS;
 	}
+
+	for (;;)
+		psycho_step(&emu.ctx);
+
 	return EXIT_FAILURE;
 }
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "asm.h"
+
+size_t asm_emit(struct bench_asm *const a, const u32 instr)
+{
+	if (a->len == a->capacity) {
+		const size_t capacity = a->capacity ? (a->capacity * 2) : 64;
+		u32 *const buf = realloc(a->buf, capacity * sizeof(u32));
+
+		if (!buf) {
+			fputs("out of memory assembling kernel\n", stderr);
+			abort();
+		}
+		a->buf = buf;
+		a->capacity = capacity;
+	}
+	a->buf[a->len] = instr;
+	return a->len++;
+}
+
+void asm_patch_here(struct bench_asm *const a, const size_t branch)
+{
+	const s16 off = (s16)((ptrdiff_t)a->len - (ptrdiff_t)(branch + 1));
+	a->buf[branch] = (a->buf[branch] & 0xFFFF0000) | (u16)off;
+}
+
+void asm_free(struct bench_asm *const a)
+{
+	free(a->buf);
+
+	a->buf = NULL;
+	a->len = 0;
+	a->capacity = 0;
+}
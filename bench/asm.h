@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file asm.h Defines a minimal in-tree MIPS I assembler.
+ *
+ * Only the instructions needed to build the benchmark kernels are provided.
+ * Each function returns the encoded instruction word; branch offsets are in
+ * instructions relative to the delay slot, exactly as encoded.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "core/compiler.h"
+#include "core/cpu-defs.h"
+#include "core/types.h"
+
+struct bench_asm {
+	u32 *buf;
+	size_t len;
+	size_t capacity;
+};
+
+ALWAYS_INLINE u32 asm_i(const uint op, const uint rs, const uint rt,
+			const u16 imm)
+{
+	return (op << 26) | (rs << 21) | (rt << 16) | imm;
+}
+
+ALWAYS_INLINE u32 asm_r(const uint rs, const uint rt, const uint rd,
+			const uint shamt, const uint funct)
+{
+	return (rs << 21) | (rt << 16) | (rd << 11) | (shamt << 6) | funct;
+}
+
+ALWAYS_INLINE u32 asm_nop(void)
+{
+	return 0x00000000;
+}
+
+ALWAYS_INLINE u32 asm_sll(const uint rd, const uint rt, const uint shamt)
+{
+	return asm_r(0, rt, rd, shamt, 0x00);
+}
+
+ALWAYS_INLINE u32 asm_srl(const uint rd, const uint rt, const uint shamt)
+{
+	return asm_r(0, rt, rd, shamt, 0x02);
+}
+
+ALWAYS_INLINE u32 asm_jr(const uint rs)
+{
+	return asm_r(rs, 0, 0, 0, 0x08);
+}
+
+ALWAYS_INLINE u32 asm_mflo(const uint rd)
+{
+	return asm_r(0, 0, rd, 0, 0x12);
+}
+
+ALWAYS_INLINE u32 asm_mult(const uint rs, const uint rt)
+{
+	return asm_r(rs, rt, 0, 0, 0x18);
+}
+
+ALWAYS_INLINE u32 asm_addu(const uint rd, const uint rs, const uint rt)
+{
+	return asm_r(rs, rt, rd, 0, 0x21);
+}
+
+ALWAYS_INLINE u32 asm_subu(const uint rd, const uint rs, const uint rt)
+{
+	return asm_r(rs, rt, rd, 0, 0x23);
+}
+
+ALWAYS_INLINE u32 asm_and(const uint rd, const uint rs, const uint rt)
+{
+	return asm_r(rs, rt, rd, 0, 0x24);
+}
+
+ALWAYS_INLINE u32 asm_or(const uint rd, const uint rs, const uint rt)
+{
+	return asm_r(rs, rt, rd, 0, 0x25);
+}
+
+ALWAYS_INLINE u32 asm_xor(const uint rd, const uint rs, const uint rt)
+{
+	return asm_r(rs, rt, rd, 0, 0x26);
+}
+
+ALWAYS_INLINE u32 asm_nor(const uint rd, const uint rs, const uint rt)
+{
+	return asm_r(rs, rt, rd, 0, 0x27);
+}
+
+ALWAYS_INLINE u32 asm_slt(const uint rd, const uint rs, const uint rt)
+{
+	return asm_r(rs, rt, rd, 0, 0x2A);
+}
+
+ALWAYS_INLINE u32 asm_sltu(const uint rd, const uint rs, const uint rt)
+{
+	return asm_r(rs, rt, rd, 0, 0x2B);
+}
+
+ALWAYS_INLINE u32 asm_bltz(const uint rs, const s16 off)
+{
+	return asm_i(0x01, rs, 0x00, off);
+}
+
+ALWAYS_INLINE u32 asm_bgez(const uint rs, const s16 off)
+{
+	return asm_i(0x01, rs, 0x01, off);
+}
+
+ALWAYS_INLINE u32 asm_jal(const u32 addr)
+{
+	return (0x03 << 26) | ((addr >> 2) & 0x03FFFFFF);
+}
+
+ALWAYS_INLINE u32 asm_beq(const uint rs, const uint rt, const s16 off)
+{
+	return asm_i(0x04, rs, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_bne(const uint rs, const uint rt, const s16 off)
+{
+	return asm_i(0x05, rs, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_blez(const uint rs, const s16 off)
+{
+	return asm_i(0x06, rs, 0, off);
+}
+
+ALWAYS_INLINE u32 asm_addiu(const uint rt, const uint rs, const s16 imm)
+{
+	return asm_i(0x09, rs, rt, imm);
+}
+
+ALWAYS_INLINE u32 asm_andi(const uint rt, const uint rs, const u16 imm)
+{
+	return asm_i(0x0C, rs, rt, imm);
+}
+
+ALWAYS_INLINE u32 asm_ori(const uint rt, const uint rs, const u16 imm)
+{
+	return asm_i(0x0D, rs, rt, imm);
+}
+
+ALWAYS_INLINE u32 asm_lui(const uint rt, const u16 imm)
+{
+	return asm_i(0x0F, 0, rt, imm);
+}
+
+ALWAYS_INLINE u32 asm_lb(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x20, base, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_lwl(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x22, base, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_lw(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x23, base, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_lhu(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x25, base, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_lwr(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x26, base, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_sb(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x28, base, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_sh(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x29, base, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_swl(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x2A, base, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_sw(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x2B, base, rt, off);
+}
+
+ALWAYS_INLINE u32 asm_swr(const uint rt, const s16 off, const uint base)
+{
+	return asm_i(0x2E, base, rt, off);
+}
+
+/**
+ * @brief Appends an instruction to the program being assembled.
+ *
+ * @returns The index of the instruction, for use as a branch target.
+ */
+size_t asm_emit(struct bench_asm *a, u32 instr);
+
+/**
+ * @brief Returns the index the next emitted instruction will have.
+ */
+ALWAYS_INLINE size_t asm_here(const struct bench_asm *const a)
+{
+	return a->len;
+}
+
+/**
+ * @brief Computes the offset of a branch emitted next to a target index.
+ */
+ALWAYS_INLINE s16 asm_off_to(const struct bench_asm *const a,
+			     const size_t target)
+{
+	// Branch offsets are relative to the delay slot, which is the
+	// instruction after the branch being emitted.
+	return (s16)((ptrdiff_t)target - (ptrdiff_t)(a->len + 1));
+}
+
+/**
+ * @brief Patches the offset of a previously emitted forward branch so that it
+ * lands on the next instruction to be emitted.
+ */
+void asm_patch_here(struct bench_asm *a, size_t branch);
+
+void asm_free(struct bench_asm *a);
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "core/lockstep.h"
+#include "asm.h"
+
+enum {
+	/** The virtual address every kernel is assembled to run from. */
+	BENCH_CODE_ADDR = 0x80010000,
+
+	/** The virtual address of the RAM buffer kernels stream over. */
+	BENCH_DATA_ADDR = 0x80100000,
+
+	/** The bytes at BENCH_DATA_ADDR which are filled in from the seed. */
+	BENCH_DATA_SIZE = 0x20000,
+
+	/** The number of blocks cached with --ir. */
+	BENCH_IR_BLOCKS_NUM = 4096
+};
+
+struct bench_kernel {
+	const char *name;
+	const char *desc;
+
+	/**
+	 * @brief Assembles the kernel.
+	 *
+	 * Kernels never terminate; they are run for a fixed number of
+	 * instructions instead. Each starts with a seed in $a0 and the
+	 * data buffer filled in from it; both are zero unless the kernel is
+	 * run on lanes.
+	 */
+	void (*build)(struct bench_asm *a);
+
+	/**
+	 * @brief Whether lanes seeded differently take different paths
+	 * through the kernel, and so have to split from and merge back into
+	 * the pack.
+	 */
+	bool diverges;
+};
+
+extern const struct bench_kernel bench_kernels[];
+extern const size_t bench_kernels_num;
+
+struct bench_boot_cfg {
+	/** @brief The BIOS to boot. */
+	const char *bios_file;
+
+	/** @brief The EXE to side-load, or NULL for the bundled one. */
+	const char *exe_file;
+
+	/** @brief How many instructions of the EXE to execute. */
+	u64 exe_instrs;
+
+	/** @brief How many instructions the BIOS may take to boot. */
+	u64 boot_instrs_max;
+
+	/**
+	 * @brief Whether to skip idle loops and run cache flush loops in bulk
+	 * rather than interpret them.
+	 */
+	bool idle_skip;
+
+	/** @brief Whether to execute through the IR. */
+	bool ir;
+
+	/**
+	 * @brief A native module built by psycho-aot for the EXE, or NULL;
+	 * implies @ref ir.
+	 */
+	const char *aot_file;
+
+	/**
+	 * @brief Where to keep the BIOS translated ahead of time, or NULL;
+	 * implies @ref ir.
+	 */
+	const char *bios_code_file;
+
+	/**
+	 * @brief Whether to check the IR against the interpreter in lockstep
+	 * rather than measuring; implies @ref ir.
+	 */
+	bool verify;
+
+	/** @brief How often to compare the two with @ref verify. */
+	enum psycho_lockstep_granularity granularity;
+
+	uint num_runs;
+	bool json;
+
+	/** @brief A previous JSON report to compare against, if any. */
+	const char *baseline_file;
+
+	/** @brief Where to save the JSON report of this run, if anywhere. */
+	const char *save_baseline_file;
+
+	/** @brief The largest tolerated throughput loss, in percent. */
+	double max_regression_pct;
+};
+
+/**
+ * @brief Builds the bundled test EXE from the in-tree assembler.
+ *
+ * @param size Receives the size of the EXE in bytes.
+ * @returns A heap allocated PS-X EXE image, or NULL if out of memory.
+ */
+u8 *bench_exe_build(size_t *size);
+
+/**
+ * @brief Runs the end-to-end boot benchmark.
+ *
+ * @returns The process exit status; failure if the throughput regressed by
+ * more than allowed against the baseline.
+ */
+int bench_boot(const struct bench_boot_cfg *cfg);
@@ -0,0 +1,547 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/ctx.h"
+#include "frontend/aot.h"
+#include "frontend/bios-code.h"
+#include "frontend/bios-image.h"
+#include "frontend/clock.h"
+#include "frontend/fmap.h"
+#include "frontend/lockstep.h"
+#include "bench.h"
+
+enum bench_boot_phase {
+	BENCH_BOOT_PHASE_BOOT,
+	BENCH_BOOT_PHASE_EXE,
+	BENCH_BOOT_PHASE_TOTAL,
+	BENCH_BOOT_PHASE_NUM
+};
+
+struct bench_boot_phase_result {
+	u64 instructions;
+	u64 median_ns;
+	u64 p99_ns;
+};
+
+static const char *const phase_name[BENCH_BOOT_PHASE_NUM] = {
+	// clang-format off
+
+	[BENCH_BOOT_PHASE_BOOT]		= "boot",
+	[BENCH_BOOT_PHASE_EXE]		= "exe",
+	[BENCH_BOOT_PHASE_TOTAL]	= "total"
+
+	// clang-format on
+};
+
+static struct {
+	struct psycho_ctx ctx;
+
+	// The interpreter which --ir-verify holds the IR against.
+	struct psycho_ctx ref_ctx;
+	struct psycho_lockstep lockstep;
+
+	struct bios_image bios;
+	struct bios_code bios_code;
+	struct aot_module aot;
+	const u8 *exe;
+	size_t exe_size;
+	u8 *ram;
+	u8 *ref_ram;
+	u64 shell_ns;
+	u64 idle_skipped;
+	u64 ir_instrs;
+	u64 native_blocks;
+	u64 ir_translated;
+	u64 ir_bios_copied;
+	enum psycho_return_code exe_status;
+	u32 sideload_hook;
+	u32 ref_sideload_hook;
+	bool at_shell;
+} boot;
+
+static void ctx_event_handle(struct psycho_ctx *const ctx,
+			     const enum psycho_event event, void *const data)
+{
+	(void)ctx;
+	(void)data;
+
+	switch (event) {
+	case PSYCHO_EVENT_CPU_ILLEGAL:
+		fputs("boot benchmark executed an illegal instruction\n",
+		      stderr);
+		abort();
+
+	case PSYCHO_EVENT_LOG_MESSAGE:
+	case PSYCHO_EVENT_TTY_MESSAGE:
+	case PSYCHO_EVENT_PROFILER_SAMPLE:
+	case PSYCHO_EVENT_WATCHPOINT:
+	case PSYCHO_EVENT_HANG:
+		return;
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+// The hook is handed the handle it was registered under.
+static void sideload_hook(struct psycho_ctx *const ctx, const u32 pc,
+			  void *const udata)
+{
+	(void)pc;
+
+	boot.shell_ns = clock_ns();
+	boot.at_shell = true;
+
+	psycho_hook_remove(ctx, *(const u32 *)udata);
+	boot.exe_status = psycho_exe_load(ctx, boot.exe, boot.exe_size);
+	psycho_hook_stop(ctx);
+}
+
+// Sets up a context to boot from reset and side-load the EXE at the shell,
+// executing through the IR if @p ir is set; returns the time it took from
+// when only the booting is left.
+static u64 ctx_boot_init(const struct bench_boot_cfg *const cfg,
+			 struct psycho_ctx *const ctx, u8 *const ram,
+			 u32 *const sideload_hook_id, const bool ir)
+{
+	const struct psycho_ctx_cfg ctx_cfg = {
+		// clang-format off
+
+		.event_cb	= ctx_event_handle,
+		.ram_data	= ram,
+		.bios_data	= boot.bios.data
+
+		// clang-format on
+	};
+
+	memset(ctx, 0, sizeof(*ctx));
+	memset(ram, 0, RAM_SIZE);
+
+	// Clearing the block cache is not part of booting.
+	if (ir) {
+		static struct psycho_ir_block blocks[BENCH_IR_BLOCKS_NUM];
+
+		const struct psycho_ir_cfg ir_cfg = {
+			// clang-format off
+
+			.blocks		= blocks,
+			.blocks_num	= BENCH_IR_BLOCKS_NUM,
+			.native		= boot.aot.native,
+			.bios		= cfg->bios_code_file ?
+						  &boot.bios_code.blocks :
+						  NULL
+
+			// clang-format on
+		};
+
+		psycho_ir_enable(ctx, &ir_cfg);
+	}
+
+	const u64 start = clock_ns();
+	psycho_init(ctx, &ctx_cfg);
+
+	*sideload_hook_id = psycho_hook_add(ctx, EXE_SIDELOAD_PC, sideload_hook,
+					    sideload_hook_id);
+	return start;
+}
+
+// Boots the BIOS to the shell, side-loads the EXE and runs it for a fixed
+// number of instructions, recording how long each phase took.
+static bool boot_run(const struct bench_boot_cfg *const cfg,
+		     u64 ns[BENCH_BOOT_PHASE_NUM], u64 *const boot_instrs)
+{
+	boot.at_shell = false;
+
+	const u64 start = ctx_boot_init(cfg, &boot.ctx, boot.ram,
+					&boot.sideload_hook, cfg->ir);
+
+	psycho_idle_skip_enable(&boot.ctx, cfg->idle_skip);
+	psycho_icache_loop_ffwd_enable(&boot.ctx, cfg->idle_skip);
+
+	// The side-load hook stops the run at the shell, so that the EXE starts
+	// off with a run of its own.
+	const u64 num_instrs = psycho_run(&boot.ctx, cfg->boot_instrs_max);
+
+	if (!boot.at_shell || (boot.exe_status != PSYCHO_OK))
+		return false;
+
+	const u64 shell = boot.shell_ns;
+
+	psycho_run(&boot.ctx, cfg->exe_instrs);
+	boot.idle_skipped = boot.ctx.idle.skipped;
+	boot.ir_instrs = boot.ctx.ir.instrs_run;
+	boot.native_blocks = boot.ctx.ir.native_run;
+	boot.ir_translated = boot.ctx.ir.translated;
+	boot.ir_bios_copied = boot.ctx.ir.bios_copied;
+
+	const u64 end = clock_ns();
+
+	ns[BENCH_BOOT_PHASE_BOOT] = shell - start;
+	ns[BENCH_BOOT_PHASE_EXE] = end - shell;
+	ns[BENCH_BOOT_PHASE_TOTAL] = end - start;
+
+	*boot_instrs = num_instrs;
+	return true;
+}
+
+// Boots the BIOS and runs the EXE through the IR and the interpreter in
+// lockstep, rather than measuring either.
+static int boot_verify(const struct bench_boot_cfg *const cfg)
+{
+	struct psycho_lockstep *const ls = &boot.lockstep;
+
+	boot.at_shell = false;
+
+	ctx_boot_init(cfg, &boot.ctx, boot.ram, &boot.sideload_hook, true);
+	ctx_boot_init(cfg, &boot.ref_ctx, boot.ref_ram,
+		      &boot.ref_sideload_hook, false);
+
+	psycho_lockstep_init(ls, &boot.ref_ctx, &boot.ctx, cfg->granularity);
+
+	// The side-load hook stops the candidate at the shell.
+	u64 boot_instrs = 0;
+
+	while (!boot.at_shell && !ls->diverged &&
+	       (boot_instrs < cfg->boot_instrs_max))
+		boot_instrs += psycho_lockstep_run(
+			ls, cfg->boot_instrs_max - boot_instrs);
+
+	if (!ls->diverged && boot.at_shell && (boot.exe_status == PSYCHO_OK))
+		psycho_lockstep_run(ls, cfg->exe_instrs);
+
+	psycho_lockstep_end(ls);
+
+	if (ls->diverged) {
+		lockstep_report(&ls->divergence, stderr);
+		return EXIT_FAILURE;
+	}
+
+	if (!boot.at_shell || (boot.exe_status != PSYCHO_OK)) {
+		fprintf(stderr,
+			"BIOS never reached the shell at 0x%08X or the EXE "
+			"could not be loaded\n",
+			EXE_SIDELOAD_PC);
+		return EXIT_FAILURE;
+	}
+
+	printf("ok, %" PRIu64 " instructions in lockstep, %" PRIu64
+	       " through the IR (%" PRIu64 " compared, %" PRIu64
+	       " native blocks, %" PRIu64 " copied from the BIOS code)\n",
+	       ls->instrs, boot.ctx.ir.instrs_run, ls->compares,
+	       boot.ctx.ir.native_run, boot.ctx.ir.bios_copied);
+	return EXIT_SUCCESS;
+}
+
+static int u64_cmp(const void *const a, const void *const b)
+{
+	const u64 lhs = *(const u64 *)a;
+	const u64 rhs = *(const u64 *)b;
+
+	return (lhs > rhs) - (lhs < rhs);
+}
+
+// Nearest-rank percentile of an already sorted set of samples.
+static u64 percentile(const u64 *const samples, const uint num_samples,
+		      const uint pct)
+{
+	const uint rank = ((num_samples * pct) + 99) / 100;
+	return samples[rank ? (rank - 1) : 0];
+}
+
+static double phase_mips(const struct bench_boot_phase_result *const res)
+{
+	return clock_mips(res->instructions, res->median_ns);
+}
+
+static void report_json(FILE *const out, const struct bench_boot_cfg *const cfg,
+			const struct bench_boot_phase_result *const res)
+{
+	fprintf(out,
+		"{\n\t\"mode\": \"boot\",\n\t\"runs\": %u,\n\t"
+		"\"bios_hash\": \"%016" PRIX64 "\",\n\t"
+		"\"idle_skipped\": %" PRIu64,
+		cfg->num_runs, boot.bios.hash, boot.idle_skipped);
+
+	for (size_t i = 0; i < BENCH_BOOT_PHASE_NUM; ++i) {
+		fprintf(out,
+			",\n\t\"%s\": { \"instructions\": %" PRIu64
+			", \"median_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64
+			", \"mips\": %.3f }",
+			phase_name[i], res[i].instructions, res[i].median_ns,
+			res[i].p99_ns, phase_mips(&res[i]));
+	}
+	fputs("\n}\n", out);
+}
+
+static void report_text(const struct bench_boot_cfg *const cfg,
+			const struct bench_boot_phase_result *const res)
+{
+	printf("%u runs, BIOS hash %016" PRIX64 "\n\n", cfg->num_runs,
+	       boot.bios.hash);
+
+	printf("%-8s %14s %12s %12s %10s\n", "phase", "instructions",
+	       "median (s)", "p99 (s)", "MIPS");
+
+	for (size_t i = 0; i < BENCH_BOOT_PHASE_NUM; ++i) {
+		printf("%-8s %14" PRIu64 " %12.6f %12.6f %10.2f\n",
+		       phase_name[i], res[i].instructions,
+		       clock_ns_to_secs(res[i].median_ns),
+		       clock_ns_to_secs(res[i].p99_ns), phase_mips(&res[i]));
+	}
+
+	if (cfg->idle_skip)
+		printf("\n%" PRIu64 " instructions skipped in idle loops\n",
+		       boot.idle_skipped);
+
+	if (cfg->ir)
+		printf("\n%" PRIu64 " instructions executed through the IR\n",
+		       boot.ir_instrs);
+
+	if (cfg->aot_file)
+		printf("%" PRIu64 " blocks executed as native code\n",
+		       boot.native_blocks);
+
+	if (cfg->bios_code_file)
+		printf("%" PRIu64 " blocks translated, %" PRIu64
+		       " copied from the BIOS code\n",
+		       boot.ir_translated, boot.ir_bios_copied);
+}
+
+// The baseline is simply the JSON report of an earlier run; only the overall
+// throughput is compared, so there's no need for a real JSON parser.
+static bool baseline_mips_read(const char *const path, double *const mips)
+{
+	struct fmap map;
+
+	if (!fmap_open(&map, path))
+		return false;
+
+	char *const json = malloc(map.size + 1);
+
+	if (!json) {
+		fmap_close(&map);
+		return false;
+	}
+
+	memcpy(json, map.data, map.size);
+	json[map.size] = '\0';
+	fmap_close(&map);
+
+	const char *total = strstr(json, "\"total\"");
+	const char *mips_str = total ? strstr(total, "\"mips\":") : NULL;
+
+	bool ret = false;
+
+	if (mips_str) {
+		char *end;
+		*mips = strtod(mips_str + sizeof("\"mips\":") - 1, &end);
+		ret = end != (mips_str + sizeof("\"mips\":") - 1);
+	}
+
+	if (!ret)
+		errno = EINVAL;
+
+	free(json);
+	return ret;
+}
+
+// Maps the BIOS code saved by an earlier run, translating and saving it first
+// if there is none for this BIOS yet.
+static bool bios_code_load(const char *const path)
+{
+	if (bios_code_open(&boot.bios_code, path, &boot.bios))
+		return true;
+
+	if ((errno != ENOENT) && (errno != ESTALE))
+		return false;
+
+	return bios_code_build(&boot.bios_code, &boot.bios) &&
+	       bios_code_save(&boot.bios_code, path);
+}
+
+static bool exe_load(const struct bench_boot_cfg *const cfg,
+		     struct fmap *const map)
+{
+	if (cfg->exe_file) {
+		if (!fmap_open(map, cfg->exe_file))
+			return false;
+
+		boot.exe = map->data;
+		boot.exe_size = map->size;
+
+		return true;
+	}
+
+	map->data = NULL;
+
+	u8 *const exe = bench_exe_build(&boot.exe_size);
+	boot.exe = exe;
+
+	return exe != NULL;
+}
+
+// Boots and runs the EXE once per run, then reports how long each phase took
+// and compares it against the baseline, if any.
+static int boot_measure(const struct bench_boot_cfg *const cfg,
+			u64 *const samples)
+{
+	struct bench_boot_phase_result res[BENCH_BOOT_PHASE_NUM];
+	u64 boot_instrs = 0;
+
+	for (uint run = 0; run < cfg->num_runs; ++run) {
+		u64 ns[BENCH_BOOT_PHASE_NUM];
+
+		if (!boot_run(cfg, ns, &boot_instrs)) {
+			fprintf(stderr,
+				"BIOS never reached the shell at 0x%08X or "
+				"the EXE could not be loaded\n",
+				EXE_SIDELOAD_PC);
+			return EXIT_FAILURE;
+		}
+
+		for (size_t i = 0; i < BENCH_BOOT_PHASE_NUM; ++i)
+			samples[(i * cfg->num_runs) + run] = ns[i];
+	}
+
+	res[BENCH_BOOT_PHASE_BOOT].instructions = boot_instrs;
+	res[BENCH_BOOT_PHASE_EXE].instructions = cfg->exe_instrs;
+	res[BENCH_BOOT_PHASE_TOTAL].instructions =
+		boot_instrs + cfg->exe_instrs;
+
+	for (size_t i = 0; i < BENCH_BOOT_PHASE_NUM; ++i) {
+		u64 *const phase_samples = &samples[i * cfg->num_runs];
+
+		qsort(phase_samples, cfg->num_runs, sizeof(u64), u64_cmp);
+
+		res[i].median_ns = percentile(phase_samples, cfg->num_runs, 50);
+		res[i].p99_ns = percentile(phase_samples, cfg->num_runs, 99);
+	}
+
+	if (cfg->json)
+		report_json(stdout, cfg, res);
+	else
+		report_text(cfg, res);
+
+	if (cfg->save_baseline_file) {
+		FILE *const out = fopen(cfg->save_baseline_file, "w");
+
+		if (!out) {
+			fprintf(stderr, "error saving baseline %s: %s\n",
+				cfg->save_baseline_file, strerror(errno));
+			return EXIT_FAILURE;
+		}
+		report_json(out, cfg, res);
+		fclose(out);
+	}
+
+	int ret = EXIT_SUCCESS;
+
+	if (cfg->baseline_file) {
+		double baseline_mips;
+
+		if (!baseline_mips_read(cfg->baseline_file, &baseline_mips)) {
+			fprintf(stderr, "error reading baseline %s: %s\n",
+				cfg->baseline_file, strerror(errno));
+			return EXIT_FAILURE;
+		}
+
+		const double mips = phase_mips(&res[BENCH_BOOT_PHASE_TOTAL]);
+		const double delta_pct =
+			((mips - baseline_mips) * 100) / baseline_mips;
+
+		const bool regressed = -delta_pct > cfg->max_regression_pct;
+
+		fprintf(stderr,
+			"baseline %.2f MIPS, current %.2f MIPS (%+.2f%%): %s "
+			"(limit -%.2f%%)\n",
+			baseline_mips, mips, delta_pct,
+			regressed ? "REGRESSION" : "ok",
+			cfg->max_regression_pct);
+
+		if (regressed)
+			ret = EXIT_FAILURE;
+	}
+	return ret;
+}
+
+int bench_boot(const struct bench_boot_cfg *const cfg)
+{
+	struct fmap exe_map;
+
+	if (!bios_image_open(&boot.bios, cfg->bios_file)) {
+		fprintf(stderr, "error loading bios file %s: %s\n",
+			cfg->bios_file, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	if (cfg->bios_code_file && !bios_code_load(cfg->bios_code_file)) {
+		fprintf(stderr, "error loading bios code %s: %s\n",
+			cfg->bios_code_file, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	if (cfg->aot_file && !aot_module_open(&boot.aot, cfg->aot_file)) {
+		fprintf(stderr, "error loading native module %s: %s\n",
+			cfg->aot_file, boot.aot.error);
+		return EXIT_FAILURE;
+	}
+
+	if (!exe_load(cfg, &exe_map)) {
+		fprintf(stderr, "error loading exe file %s: %s\n",
+			cfg->exe_file ? cfg->exe_file : "(bundled)",
+			strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	boot.ram = malloc(RAM_SIZE);
+	boot.ref_ram = cfg->verify ? malloc(RAM_SIZE) : NULL;
+	u64 *const samples =
+		calloc(BENCH_BOOT_PHASE_NUM * cfg->num_runs, sizeof(u64));
+
+	if (!boot.ram || (cfg->verify && !boot.ref_ram) || !samples) {
+		fputs("out of memory\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	const int ret = cfg->verify ? boot_verify(cfg) :
+				      boot_measure(cfg, samples);
+
+	if (exe_map.data)
+		fmap_close(&exe_map);
+	else
+		free((void *)(uintptr_t)boot.exe);
+
+	free(samples);
+	free(boot.ram);
+	free(boot.ref_ram);
+	bios_code_close(&boot.bios_code);
+	bios_image_close(&boot.bios);
+	aot_module_close(&boot.aot);
+
+	return ret;
+}
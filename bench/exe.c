@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/ctx.h"
+#include "bench.h"
+
+enum {
+	// clang-format off
+
+	ZERO	= CPU_GPR_ZERO,
+	T0	= CPU_GPR_T0,
+	T1	= CPU_GPR_T1,
+	T2	= CPU_GPR_T2,
+	T3	= CPU_GPR_T3,
+	T4	= CPU_GPR_T4,
+	T5	= CPU_GPR_T5,
+	T6	= CPU_GPR_T6,
+	S0	= CPU_GPR_S0,
+	RA	= CPU_GPR_RA
+
+	// clang-format on
+};
+
+enum {
+	// clang-format off
+
+	EXE_OFF_INITIAL_PC		= 0x010,
+	EXE_OFF_DEST_ADDR		= 0x018,
+	EXE_OFF_FILE_SIZE		= 0x01C,
+	EXE_OFF_INITIAL_SP_FP_BASE	= 0x030,
+
+	EXE_INITIAL_SP			= 0x801FFF00
+
+	// clang-format on
+};
+
+static void build_alu_func(struct bench_asm *const a)
+{
+	asm_emit(a, asm_addiu(T0, ZERO, 16));
+
+	const size_t loop = asm_here(a);
+
+	asm_emit(a, asm_addu(T1, T1, T0));
+	asm_emit(a, asm_xor(T2, T1, T0));
+	asm_emit(a, asm_sll(T3, T2, 2));
+	asm_emit(a, asm_subu(T4, T3, T1));
+	asm_emit(a, asm_addiu(T0, T0, -1));
+	asm_emit(a, asm_bne(T0, ZERO, asm_off_to(a, loop)));
+	asm_emit(a, asm_nop());
+
+	asm_emit(a, asm_jr(RA));
+	asm_emit(a, asm_nop());
+}
+
+static void build_mem_func(struct bench_asm *const a)
+{
+	asm_emit(a, asm_addiu(T0, ZERO, 16));
+	asm_emit(a, asm_addu(T5, S0, ZERO));
+
+	const size_t loop = asm_here(a);
+
+	asm_emit(a, asm_lw(T1, 0, T5));
+	asm_emit(a, asm_lw(T2, 4, T5));
+	asm_emit(a, asm_addu(T3, T1, T2));
+	asm_emit(a, asm_sw(T3, 8, T5));
+	asm_emit(a, asm_addiu(T5, T5, 16));
+	asm_emit(a, asm_addiu(T0, T0, -1));
+	asm_emit(a, asm_bne(T0, ZERO, asm_off_to(a, loop)));
+	asm_emit(a, asm_nop());
+
+	asm_emit(a, asm_jr(RA));
+	asm_emit(a, asm_nop());
+}
+
+static void build_unaligned_func(struct bench_asm *const a)
+{
+	asm_emit(a, asm_addiu(T0, ZERO, 8));
+	asm_emit(a, asm_addu(T5, S0, ZERO));
+	asm_emit(a, asm_lui(T6, (BENCH_DATA_ADDR >> 16) + 1));
+
+	const size_t loop = asm_here(a);
+
+	asm_emit(a, asm_lwr(T1, 1, T5));
+	asm_emit(a, asm_lwl(T1, 4, T5));
+	asm_emit(a, asm_addiu(T5, T5, 4));
+	asm_emit(a, asm_swr(T1, 3, T6));
+	asm_emit(a, asm_swl(T1, 6, T6));
+	asm_emit(a, asm_addiu(T6, T6, 4));
+	asm_emit(a, asm_addiu(T0, T0, -1));
+	asm_emit(a, asm_bne(T0, ZERO, asm_off_to(a, loop)));
+	asm_emit(a, asm_nop());
+
+	asm_emit(a, asm_jr(RA));
+	asm_emit(a, asm_nop());
+}
+
+static u32 func_addr(const size_t idx)
+{
+	return BENCH_CODE_ADDR + (idx * sizeof(u32));
+}
+
+u8 *bench_exe_build(size_t *const size)
+{
+	struct bench_asm a = { 0 };
+
+	asm_emit(&a, asm_lui(S0, BENCH_DATA_ADDR >> 16));
+
+	const size_t loop = asm_here(&a);
+	const size_t call_alu = asm_emit(&a, asm_nop());
+	asm_emit(&a, asm_nop());
+	const size_t call_mem = asm_emit(&a, asm_nop());
+	asm_emit(&a, asm_nop());
+	const size_t call_unaligned = asm_emit(&a, asm_nop());
+	asm_emit(&a, asm_nop());
+	asm_emit(&a, asm_beq(ZERO, ZERO, asm_off_to(&a, loop)));
+	asm_emit(&a, asm_nop());
+
+	a.buf[call_alu] = asm_jal(func_addr(asm_here(&a)));
+	build_alu_func(&a);
+
+	a.buf[call_mem] = asm_jal(func_addr(asm_here(&a)));
+	build_mem_func(&a);
+
+	a.buf[call_unaligned] = asm_jal(func_addr(asm_here(&a)));
+	build_unaligned_func(&a);
+
+	// The code section of an EXE is always a multiple of 2 KiB.
+	const size_t code_size =
+		((a.len * sizeof(u32)) + (EXE_MIN_SIZE - 1)) &
+		~(size_t)(EXE_MIN_SIZE - 1);
+
+	*size = EXE_MIN_SIZE + code_size;
+	u8 *const exe = calloc(1, *size);
+
+	if (exe) {
+		const u32 header[][2] = {
+			// clang-format off
+
+			{ EXE_OFF_INITIAL_PC,		BENCH_CODE_ADDR },
+			{ EXE_OFF_DEST_ADDR,		BENCH_CODE_ADDR },
+			{ EXE_OFF_FILE_SIZE,		code_size },
+			{ EXE_OFF_INITIAL_SP_FP_BASE,	EXE_INITIAL_SP }
+
+			// clang-format on
+		};
+
+		memcpy(exe, "PS-X EXE", sizeof("PS-X EXE") - 1);
+
+		for (size_t i = 0; i < (sizeof(header) / sizeof(header[0]));
+		     ++i)
+			memcpy(&exe[header[i][0]], &header[i][1], sizeof(u32));
+
+		memcpy(&exe[EXE_MIN_SIZE], a.buf, a.len * sizeof(u32));
+	}
+	asm_free(&a);
+
+	return exe;
+}
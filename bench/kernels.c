@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "core/bus.h"
+#include "bench.h"
+
+enum {
+	// clang-format off
+
+	ZERO	= CPU_GPR_ZERO,
+	A0	= CPU_GPR_A0,
+	T0	= CPU_GPR_T0,
+	T1	= CPU_GPR_T1,
+	T2	= CPU_GPR_T2,
+	T3	= CPU_GPR_T3,
+	T4	= CPU_GPR_T4,
+	T5	= CPU_GPR_T5,
+	T6	= CPU_GPR_T6,
+	T7	= CPU_GPR_T7,
+	S0	= CPU_GPR_S0,
+	S1	= CPU_GPR_S1,
+	S2	= CPU_GPR_S2,
+	S3	= CPU_GPR_S3,
+	S4	= CPU_GPR_S4,
+	RA	= CPU_GPR_RA
+
+	// clang-format on
+};
+
+static void build_alu(struct bench_asm *const a)
+{
+	asm_emit(a, asm_lui(T0, 0x1234));
+	asm_emit(a, asm_ori(T0, T0, 0x5678));
+	asm_emit(a, asm_addiu(T1, ZERO, 1));
+
+	const size_t loop = asm_here(a);
+
+	asm_emit(a, asm_addu(T2, T0, T1));
+	asm_emit(a, asm_xor(T3, T2, T0));
+	asm_emit(a, asm_sll(T4, T3, 3));
+	asm_emit(a, asm_srl(T5, T4, 7));
+	asm_emit(a, asm_or(T6, T5, T2));
+	asm_emit(a, asm_subu(T7, T6, T1));
+	asm_emit(a, asm_slt(S0, T7, T0));
+	asm_emit(a, asm_sltu(S1, T0, T7));
+	asm_emit(a, asm_and(S2, S0, S1));
+	asm_emit(a, asm_nor(S3, S2, T2));
+	asm_emit(a, asm_mult(T0, T1));
+	asm_emit(a, asm_mflo(S4));
+	asm_emit(a, asm_addiu(T1, T1, 3));
+	asm_emit(a, asm_beq(ZERO, ZERO, asm_off_to(a, loop)));
+	asm_emit(a, asm_nop());
+}
+
+// Streams loads and stores over a buffer, wrapping at `mask` bytes. The mask
+// must keep every access within the region the buffer lives in.
+static void build_stream(struct bench_asm *const a, const u16 base_hi,
+			 const u16 mask)
+{
+	asm_emit(a, asm_lui(S0, base_hi));
+	asm_emit(a, asm_addiu(S1, ZERO, 0));
+
+	const size_t loop = asm_here(a);
+
+	asm_emit(a, asm_addu(T0, S0, S1));
+	asm_emit(a, asm_lw(T1, 0, T0));
+	asm_emit(a, asm_lw(T2, 4, T0));
+	asm_emit(a, asm_lhu(T4, 6, T0));
+	asm_emit(a, asm_addu(T3, T1, T2));
+	asm_emit(a, asm_sw(T3, 8, T0));
+	asm_emit(a, asm_sh(T4, 12, T0));
+	asm_emit(a, asm_sb(T1, 15, T0));
+	asm_emit(a, asm_addiu(S1, S1, 16));
+	asm_emit(a, asm_andi(S1, S1, mask));
+	asm_emit(a, asm_beq(ZERO, ZERO, asm_off_to(a, loop)));
+	asm_emit(a, asm_nop());
+}
+
+static void build_ram_stream(struct bench_asm *const a)
+{
+	build_stream(a, BENCH_DATA_ADDR >> 16, 0xFFF0);
+}
+
+static void build_scratchpad_stream(struct bench_asm *const a)
+{
+	build_stream(a, SCRATCHPAD_ADDR_START >> 16, SCRATCHPAD_SIZE - 16);
+}
+
+// The counter starts at the seed, so that lanes seeded differently take the
+// branches differently.
+static void build_branchy(struct bench_asm *const a)
+{
+	asm_emit(a, asm_addu(S0, A0, ZERO));
+
+	const size_t loop = asm_here(a);
+
+	asm_emit(a, asm_addiu(S0, S0, 1));
+
+	// Taken every other iteration.
+	asm_emit(a, asm_andi(T0, S0, 1));
+	const size_t skip_odd = asm_emit(a, asm_beq(T0, ZERO, 0));
+	asm_emit(a, asm_nop());
+	asm_emit(a, asm_addiu(T1, T1, 1));
+	asm_patch_here(a, skip_odd);
+
+	// Taken two iterations out of four.
+	asm_emit(a, asm_andi(T2, S0, 2));
+	const size_t skip_two = asm_emit(a, asm_bne(T2, ZERO, 0));
+	asm_emit(a, asm_nop());
+	asm_emit(a, asm_addiu(T3, T3, 1));
+	asm_patch_here(a, skip_two);
+
+	// Practically never taken.
+	const size_t skip_neg = asm_emit(a, asm_bltz(S0, 0));
+	asm_emit(a, asm_nop());
+	asm_emit(a, asm_addiu(T4, T4, 1));
+	asm_patch_here(a, skip_neg);
+
+	// Practically always taken.
+	const size_t skip_pos = asm_emit(a, asm_bgez(S0, 0));
+	asm_emit(a, asm_nop());
+	asm_emit(a, asm_addiu(T5, T5, 1));
+	asm_patch_here(a, skip_pos);
+
+	asm_emit(a, asm_andi(T6, S0, 7));
+	const size_t skip_blez = asm_emit(a, asm_blez(T6, 0));
+	asm_emit(a, asm_nop());
+	asm_emit(a, asm_addiu(T7, T7, 1));
+	asm_patch_here(a, skip_blez);
+
+	asm_emit(a, asm_beq(ZERO, ZERO, asm_off_to(a, loop)));
+	asm_emit(a, asm_nop());
+}
+
+// Every branch and jump has useful work in its delay slot, and every load is
+// immediately followed by a use of its destination register.
+static void build_delay_slot(struct bench_asm *const a)
+{
+	asm_emit(a, asm_lui(S0, BENCH_DATA_ADDR >> 16));
+
+	const size_t loop = asm_here(a);
+	const size_t call = asm_emit(a, asm_nop());
+
+	asm_emit(a, asm_addiu(T0, T0, 1));
+	asm_emit(a, asm_lw(T1, 0, S0));
+	asm_emit(a, asm_addu(T2, T1, T0));
+	asm_emit(a, asm_sw(T2, 0, S0));
+	asm_emit(a, asm_lw(T3, 0, S0));
+	asm_emit(a, asm_bne(T3, T1, 1));
+	asm_emit(a, asm_addiu(T4, T4, 1));
+	asm_emit(a, asm_beq(ZERO, ZERO, asm_off_to(a, loop)));
+	asm_emit(a, asm_addiu(T5, T5, 1));
+
+	const size_t func = asm_here(a);
+
+	asm_emit(a, asm_jr(RA));
+	asm_emit(a, asm_addiu(T6, T6, 1));
+
+	a->buf[call] = asm_jal(BENCH_CODE_ADDR + (func * sizeof(u32)));
+}
+
+// Copies a buffer to a destination with a different misalignment, the way
+// memcpy() implementations built for the R3000A do.
+static void build_unaligned(struct bench_asm *const a)
+{
+	asm_emit(a, asm_lui(S0, BENCH_DATA_ADDR >> 16));
+	asm_emit(a, asm_lui(S1, (BENCH_DATA_ADDR >> 16) + 1));
+	asm_emit(a, asm_addiu(S2, ZERO, 0));
+
+	const size_t loop = asm_here(a);
+
+	asm_emit(a, asm_addu(T0, S0, S2));
+	asm_emit(a, asm_addu(T1, S1, S2));
+	asm_emit(a, asm_lwr(T2, 1, T0));
+	asm_emit(a, asm_lwl(T2, 4, T0));
+	asm_emit(a, asm_lwr(T3, 5, T0));
+	asm_emit(a, asm_lwl(T3, 8, T0));
+	asm_emit(a, asm_swr(T2, 3, T1));
+	asm_emit(a, asm_swl(T2, 6, T1));
+	asm_emit(a, asm_swr(T3, 7, T1));
+	asm_emit(a, asm_swl(T3, 10, T1));
+	asm_emit(a, asm_addiu(S2, S2, 8));
+	asm_emit(a, asm_andi(S2, S2, 0x7FF8));
+	asm_emit(a, asm_beq(ZERO, ZERO, asm_off_to(a, loop)));
+	asm_emit(a, asm_nop());
+}
+
+const struct bench_kernel bench_kernels[] = {
+	// clang-format off
+
+	{
+		.name	= "alu",
+		.desc	= "Register-to-register arithmetic loop",
+		.build	= build_alu
+	},
+
+	{
+		.name	= "ram-stream",
+		.desc	= "Load/store stream over 64 KiB of RAM",
+		.build	= build_ram_stream
+	},
+
+	{
+		.name	= "scratchpad-stream",
+		.desc	= "Load/store stream over the scratchpad",
+		.build	= build_scratchpad_stream
+	},
+
+	{
+		.name		= "branchy",
+		.desc		= "Taken and not-taken conditional branches",
+		.build		= build_branchy,
+		.diverges	= true
+	},
+
+	{
+		.name	= "delay-slot",
+		.desc	= "Calls, branches and loads with occupied delay slots",
+		.build	= build_delay_slot
+	},
+
+	{
+		.name	= "unaligned",
+		.desc	= "LWL/LWR/SWL/SWR misaligned copy",
+		.build	= build_unaligned
+	}
+
+	// clang-format on
+};
+
+const size_t bench_kernels_num =
+	sizeof(bench_kernels) / sizeof(bench_kernels[0]);
@@ -0,0 +1,939 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/ctx.h"
+#include "core/lanes.h"
+#include "frontend/clock.h"
+#include "frontend/lockstep.h"
+#include "frontend/timeline.h"
+#include "bench.h"
+
+enum bench_format {
+	BENCH_FORMAT_TEXT,
+	BENCH_FORMAT_JSON,
+	BENCH_FORMAT_CSV
+};
+
+enum {
+	BENCH_KERNELS_MAX = 32,
+
+	/** @brief The most scopes recorded per kernel with --trace. */
+	BENCH_TRACE_EVENTS_MAX = 262144
+};
+
+struct bench_result {
+	const struct bench_kernel *kernel;
+	double ns_per_instr_mean;
+	double ns_per_instr_stddev;
+	double ns_per_instr_min;
+	double ns_per_instr_max;
+
+	struct psycho_stats stats;
+
+	struct psycho_timer_totals timers[PSYCHO_TIMER_ZONE_NUM];
+	double ticks_per_ns;
+};
+
+static struct {
+	u8 ram[RAM_SIZE];
+	u8 bios[BIOS_SIZE];
+	struct psycho_ctx ctx;
+	struct psycho_ir_block ir_blocks[BENCH_IR_BLOCKS_NUM];
+} emu;
+
+// The interpreter which --ir-verify holds the IR against.
+static struct {
+	u8 ram[RAM_SIZE];
+	struct psycho_ctx ctx;
+} ref;
+
+// The contexts which --lanes runs side by side, each with RAM of its own.
+static struct {
+	u8 ram[PSYCHO_LANES_MAX][RAM_SIZE];
+	struct psycho_ctx ctx[PSYCHO_LANES_MAX];
+	struct psycho_lanes lanes;
+} lanes;
+
+static struct {
+	u64 num_instrs;
+	uint num_runs;
+	enum bench_format format;
+	bool stats;
+	bool timers;
+	bool ir_verify;
+
+	/** @brief How often --ir-verify compares the IR and the interpreter. */
+	enum psycho_lockstep_granularity granularity;
+
+	/** @brief How many contexts to run in lockstep, or 0 to run one. */
+	uint lanes_num;
+
+	/**
+	 * @brief Instructions to run on each lane before switching to the
+	 * next, or 0 to run the lanes in lockstep.
+	 */
+	u64 interleave;
+
+	const char *trace_file;
+	struct timeline trace;
+	struct psycho_timer_event *trace_events;
+
+	const char *filter[BENCH_KERNELS_MAX];
+	size_t filter_num;
+
+	struct bench_boot_cfg boot;
+} bench = {
+	// clang-format off
+
+	.num_instrs	= 20000000,
+	.num_runs	= 5,
+	.format		= BENCH_FORMAT_TEXT,
+	.granularity	= PSYCHO_LOCKSTEP_BLOCK,
+
+	.boot = {
+		.boot_instrs_max	= 500000000,
+		.max_regression_pct	= 5
+	}
+
+	// clang-format on
+};
+
+static void ctx_event_handle(struct psycho_ctx *const ctx,
+			     const enum psycho_event event, void *const data)
+{
+	(void)ctx;
+	(void)data;
+
+	switch (event) {
+	case PSYCHO_EVENT_CPU_ILLEGAL:
+		fputs("benchmark kernel executed an illegal instruction\n",
+		      stderr);
+		abort();
+
+	case PSYCHO_EVENT_LOG_MESSAGE:
+	case PSYCHO_EVENT_TTY_MESSAGE:
+	case PSYCHO_EVENT_PROFILER_SAMPLE:
+	case PSYCHO_EVENT_WATCHPOINT:
+	case PSYCHO_EVENT_HANG:
+		return;
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+// Fills the data buffer from @p seed with xorshift32, which leaves a zero
+// seed at zero; unseeded runs see the buffer cleared.
+static void kernel_data_fill(u8 *const ram, u32 seed)
+{
+	u8 *const data = &ram[BENCH_DATA_ADDR & (RAM_SIZE - 1)];
+
+	for (size_t i = 0; i < BENCH_DATA_SIZE; i += sizeof(seed)) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+
+		memcpy(&data[i], &seed, sizeof(seed));
+	}
+}
+
+static void kernel_load(const struct bench_kernel *const kernel,
+			struct psycho_ctx *const ctx, u8 *const ram,
+			const u32 seed)
+{
+	struct bench_asm a = { 0 };
+	kernel->build(&a);
+
+	memset(ctx, 0, sizeof(*ctx));
+	memset(ram, 0, RAM_SIZE);
+
+	memcpy(&ram[BENCH_CODE_ADDR & (RAM_SIZE - 1)], a.buf,
+	       a.len * sizeof(u32));
+	asm_free(&a);
+
+	kernel_data_fill(ram, seed);
+
+	const struct psycho_ctx_cfg cfg = {
+		// clang-format off
+
+		.event_cb	= ctx_event_handle,
+		.ram_data	= ram,
+		.bios_data	= emu.bios
+
+		// clang-format on
+	};
+
+	psycho_init(ctx, &cfg);
+
+	ctx->cpu.pc = BENCH_CODE_ADDR;
+	ctx->cpu.next_pc = BENCH_CODE_ADDR + sizeof(u32);
+	ctx->cpu.gpr[CPU_GPR_A0] = seed;
+}
+
+static void kernel_ir_enable(void)
+{
+	const struct psycho_ir_cfg cfg = {
+		// clang-format off
+
+		.blocks		= emu.ir_blocks,
+		.blocks_num	= BENCH_IR_BLOCKS_NUM
+
+		// clang-format on
+	};
+
+	psycho_ir_enable(&emu.ctx, &cfg);
+}
+
+// Lanes are seeded differently, so that they diverge the way fuzzing inputs
+// would rather than all taking the same path.
+static u32 kernel_lane_seed(const uint lane)
+{
+	return lane + 1;
+}
+
+static void kernel_lanes_load(const struct bench_kernel *const kernel)
+{
+	struct psycho_ctx *ctx[PSYCHO_LANES_MAX];
+
+	for (uint i = 0; i < bench.lanes_num; ++i) {
+		kernel_load(kernel, &lanes.ctx[i], lanes.ram[i],
+			    kernel_lane_seed(i));
+		ctx[i] = &lanes.ctx[i];
+	}
+	psycho_lanes_init(&lanes.lanes, ctx, bench.lanes_num);
+}
+
+// Runs each lane in turn for --interleave instructions at a time, as a host
+// juggling many guests would; every switch has the next context's state
+// brought back into the host caches.
+static u64 kernel_interleave(const u64 num_instrs)
+{
+	u64 ran = 0;
+
+	for (u64 left = num_instrs; left;) {
+		u64 quantum = bench.interleave;
+
+		if (quantum > left)
+			quantum = left;
+
+		for (uint i = 0; i < bench.lanes_num; ++i)
+			ran += psycho_run(&lanes.ctx[i], quantum);
+
+		left -= quantum;
+	}
+	return ran;
+}
+
+// Runs the kernel for @p num_instrs instructions, on every lane if there are
+// any; returns the number executed, summed across lanes.
+static u64 kernel_exec(const u64 num_instrs)
+{
+	if (bench.interleave)
+		return kernel_interleave(num_instrs);
+
+	if (bench.lanes_num)
+		return psycho_lanes_run(&lanes.lanes, num_instrs);
+
+	return psycho_run(&emu.ctx, num_instrs);
+}
+
+static void kernel_trace_write(const struct bench_result *const res,
+			       const uint tid)
+{
+	u64 dropped;
+	const size_t num = psycho_timers_recorded(&emu.ctx, &dropped);
+
+	timeline_track_name(&bench.trace, tid, res->kernel->name);
+	timeline_write(&bench.trace, tid, bench.trace_events, num,
+		       res->ticks_per_ns);
+
+	if (dropped)
+		fprintf(stderr,
+			"%s: %" PRIu64 " scopes did not fit in the trace\n",
+			res->kernel->name, dropped);
+}
+
+static void kernel_run(const struct bench_kernel *const kernel,
+		       struct bench_result *const res, const uint index)
+{
+	if (bench.lanes_num)
+		kernel_lanes_load(kernel);
+	else
+		kernel_load(kernel, &emu.ctx, emu.ram, 0);
+
+	if (bench.boot.ir)
+		kernel_ir_enable();
+
+	// Warm up the host caches and branch predictors before measuring.
+	kernel_exec(bench.num_instrs / 10);
+
+	psycho_timers_reset(&emu.ctx);
+
+	// Only the start of the first measured run is recorded; a timeline of
+	// every instruction would be enormous.
+	if (bench.trace_file)
+		psycho_timers_record(&emu.ctx, bench.trace_events,
+				     BENCH_TRACE_EVENTS_MAX);
+
+	struct timeline_calib calib;
+	timeline_calib_begin(&calib);
+
+	double sum = 0;
+	double sum_sq = 0;
+
+	res->kernel = kernel;
+	res->ns_per_instr_min = INFINITY;
+	res->ns_per_instr_max = 0;
+
+	for (uint run = 0; run < bench.num_runs; ++run) {
+		const u64 start = clock_ns();
+		const u64 ran = kernel_exec(bench.num_instrs);
+		const u64 elapsed = clock_ns() - start;
+
+		// With lanes, this is the aggregate rate across all of them.
+		const double ns_per_instr = (double)elapsed / (double)ran;
+
+		sum += ns_per_instr;
+		sum_sq += ns_per_instr * ns_per_instr;
+
+		res->ns_per_instr_min = fmin(res->ns_per_instr_min,
+					     ns_per_instr);
+		res->ns_per_instr_max = fmax(res->ns_per_instr_max,
+					     ns_per_instr);
+	}
+
+	const double mean = sum / bench.num_runs;
+	const double variance = (sum_sq / bench.num_runs) - (mean * mean);
+
+	res->ns_per_instr_mean = mean;
+	res->ns_per_instr_stddev = sqrt(fmax(variance, 0));
+
+	res->ticks_per_ns = timeline_calib_end(&calib);
+
+	psycho_stats_get(&emu.ctx, &res->stats);
+	psycho_timers_get(&emu.ctx, res->timers);
+
+	if (bench.trace_file) {
+		kernel_trace_write(res, index);
+		psycho_timers_record(&emu.ctx, NULL, 0);
+	}
+}
+
+static bool cpu_state_matches(const struct psycho_cpu *const a,
+			      const struct psycho_cpu *const b)
+{
+	return (memcmp(a->gpr, b->gpr, sizeof(a->gpr)) == 0) &&
+	       (memcmp(a->cop0, b->cop0, sizeof(a->cop0)) == 0) &&
+	       (a->hi == b->hi) && (a->lo == b->lo) && (a->pc == b->pc) &&
+	       (a->next_pc == b->next_pc) && (a->curr_pc == b->curr_pc) &&
+	       (a->instr == b->instr) && (a->ld_next.dst == b->ld_next.dst) &&
+	       (a->ld_next.val == b->ld_next.val) &&
+	       (a->ld_pend.dst == b->ld_pend.dst) &&
+	       (a->ld_pend.val == b->ld_pend.val) &&
+	       (a->in_branch_delay_slot == b->in_branch_delay_slot) &&
+	       (a->next_in_branch_delay_slot == b->next_in_branch_delay_slot);
+}
+
+static void cpu_state_print(const char *const name,
+			    const struct psycho_cpu *const cpu)
+{
+	fprintf(stderr, "%s: pc=%08X next_pc=%08X hi=%08X lo=%08X\n", name,
+		cpu->pc, cpu->next_pc, cpu->hi, cpu->lo);
+
+	for (uint i = 0; i < CPU_GPR_NUM; ++i)
+		fprintf(stderr, "  r%-2u=%08X%s", i, cpu->gpr[i],
+			((i % 4) == 3) ? "\n" : "");
+
+	fprintf(stderr,
+		"  ld_next=r%zu:%08X ld_pend=r%zu:%08X bds=%d next_bds=%d\n",
+		cpu->ld_next.dst, cpu->ld_next.val, cpu->ld_pend.dst,
+		cpu->ld_pend.val, cpu->in_branch_delay_slot,
+		cpu->next_in_branch_delay_slot);
+}
+
+// Runs the kernel through the IR and the interpreter in lockstep, comparing
+// them as often as --granularity has it, and the memory at the end.
+static bool kernel_verify(const struct bench_kernel *const kernel)
+{
+	static struct psycho_lockstep ls;
+
+	kernel_load(kernel, &emu.ctx, emu.ram, 0);
+	kernel_load(kernel, &ref.ctx, ref.ram, 0);
+	kernel_ir_enable();
+
+	psycho_lockstep_init(&ls, &ref.ctx, &emu.ctx, bench.granularity);
+	psycho_lockstep_run(&ls, bench.num_instrs);
+	psycho_lockstep_end(&ls);
+
+	if (ls.diverged) {
+		fprintf(stderr, "%s: ", kernel->name);
+		lockstep_report(&ls.divergence, stderr);
+		return false;
+	}
+
+	if ((memcmp(emu.ram, ref.ram, RAM_SIZE) != 0) ||
+	    (memcmp(emu.ctx.bus.scratchpad, ref.ctx.bus.scratchpad,
+		    SCRATCHPAD_SIZE) != 0)) {
+		fprintf(stderr, "%s: memory differs after %" PRIu64
+			" instructions\n", kernel->name, bench.num_instrs);
+		return false;
+	}
+
+	printf("%-20s ok, %" PRIu64 " of %" PRIu64
+	       " instructions in %" PRIu64 " blocks (%" PRIu64
+	       " translated, %" PRIu64 " side exits)\n",
+	       kernel->name, emu.ctx.ir.instrs_run, bench.num_instrs,
+	       emu.ctx.ir.blocks_run, emu.ctx.ir.translated,
+	       emu.ctx.ir.side_exits);
+	return true;
+}
+
+// Runs the kernel on every lane in lockstep, then each lane's seed on the
+// interpreter alone; every lane has to end up where its own run does.
+static bool kernel_lanes_verify(const struct bench_kernel *const kernel)
+{
+	kernel_lanes_load(kernel);
+	psycho_lanes_run(&lanes.lanes, bench.num_instrs);
+
+	for (uint i = 0; i < bench.lanes_num; ++i) {
+		kernel_load(kernel, &ref.ctx, ref.ram, kernel_lane_seed(i));
+
+		for (u64 j = 0; j < bench.num_instrs; ++j)
+			psycho_step(&ref.ctx);
+
+		if (!cpu_state_matches(&lanes.ctx[i].cpu, &ref.ctx.cpu)) {
+			fprintf(stderr,
+				"%s: CPU state of lane %u differs after "
+				"%" PRIu64 " instructions\n",
+				kernel->name, i, bench.num_instrs);
+			cpu_state_print("lane", &lanes.ctx[i].cpu);
+			cpu_state_print("interpreter", &ref.ctx.cpu);
+			return false;
+		}
+
+		if (memcmp(lanes.ram[i], ref.ram, RAM_SIZE) != 0) {
+			fprintf(stderr, "%s: memory of lane %u differs after %"
+				PRIu64 " instructions\n", kernel->name, i,
+				bench.num_instrs);
+			return false;
+		}
+	}
+
+	const struct psycho_lanes *const l = &lanes.lanes;
+
+	if (kernel->diverges && (bench.lanes_num > 1) &&
+	    (!l->splits || !l->merges)) {
+		fprintf(stderr, "%s: lanes never split and merged again\n",
+			kernel->name);
+		return false;
+	}
+
+	printf("%-20s ok, %" PRIu64 " packed and %" PRIu64
+	       " scalar instructions (%" PRIu64 " splits, %" PRIu64
+	       " merges)\n",
+	       kernel->name, l->packed_instrs, l->scalar_instrs, l->splits,
+	       l->merges);
+	return true;
+}
+
+static double result_mips(const struct bench_result *const res)
+{
+	return 1000 / res->ns_per_instr_mean;
+}
+
+static double result_cv_pct(const struct bench_result *const res)
+{
+	return (res->ns_per_instr_stddev * 100) / res->ns_per_instr_mean;
+}
+
+static void report_stats_row(const char *const name, const u64 count,
+			     const u64 total)
+{
+	printf("  %-12s %14" PRIu64 " %7.2f%%\n", name, count,
+	       total ? ((double)count * 100) / (double)total : 0);
+}
+
+static void report_stats(const struct bench_result *const res)
+{
+	const struct psycho_stats *const stats = &res->stats;
+	u64 total = 0;
+
+	for (uint op = 0; op < PSYCHO_STATS_OP_NUM; ++op)
+		total += stats->op[op];
+
+	printf("\n%s: %" PRIu64 " instructions\n", res->kernel->name, total);
+
+	for (uint op = 1; op < PSYCHO_STATS_OP_NUM; ++op) {
+		if (stats->op[op])
+			report_stats_row(psycho_stats_op_name(op),
+					 stats->op[op], total);
+	}
+
+	for (uint funct = 0; funct < PSYCHO_STATS_OP_NUM; ++funct) {
+		if (stats->special[funct])
+			report_stats_row(psycho_stats_special_name(funct),
+					 stats->special[funct], total);
+	}
+
+	for (uint region = 0; region < PSYCHO_STATS_REGION_NUM; ++region) {
+		const char *const name = psycho_stats_region_name(region);
+
+		if (stats->fetches[region] || stats->loads[region] ||
+		    stats->stores[region])
+			printf("  %-12s %14" PRIu64 " fetches %14" PRIu64
+			       " loads %14" PRIu64 " stores\n",
+			       name, stats->fetches[region],
+			       stats->loads[region], stats->stores[region]);
+	}
+
+	printf("  load delay cancellations: %" PRIu64
+	       ", branches in delay slots: %" PRIu64 "\n",
+	       stats->load_delay_cancels, stats->branch_in_delay_slot);
+}
+
+static void report_text(const struct bench_result *const results,
+			const size_t num_results)
+{
+	printf("%" PRIu64 " instructions x %u runs per kernel\n\n",
+	       bench.num_instrs, bench.num_runs);
+
+	printf("%-20s %10s %10s %10s %8s\n", "kernel", "MIPS", "ns/instr",
+	       "stddev", "cv%");
+
+	for (size_t i = 0; i < num_results; ++i) {
+		const struct bench_result *const res = &results[i];
+
+		printf("%-20s %10.2f %10.3f %10.4f %8.2f\n", res->kernel->name,
+		       result_mips(res), res->ns_per_instr_mean,
+		       res->ns_per_instr_stddev, result_cv_pct(res));
+	}
+
+	for (size_t i = 0; bench.stats && (i < num_results); ++i)
+		report_stats(&results[i]);
+
+	for (size_t i = 0; bench.timers && (i < num_results); ++i) {
+		printf("\n%s: host time per zone\n", results[i].kernel->name);
+		timeline_write_totals(stdout, results[i].timers,
+				      results[i].ticks_per_ns);
+	}
+}
+
+static void report_json(const struct bench_result *const results,
+			const size_t num_results)
+{
+	printf("{\n\t\"instructions_per_run\": %" PRIu64
+	       ",\n\t\"runs\": %u,\n\t\"kernels\": [",
+	       bench.num_instrs, bench.num_runs);
+
+	for (size_t i = 0; i < num_results; ++i) {
+		const struct bench_result *const res = &results[i];
+
+		printf("%s\n\t\t{ \"name\": \"%s\", \"instructions_per_sec\": "
+		       "%.0f, \"ns_per_instr\": %.6f, "
+		       "\"ns_per_instr_stddev\": %.6f, "
+		       "\"ns_per_instr_min\": %.6f, "
+		       "\"ns_per_instr_max\": %.6f }",
+		       (i == 0) ? "" : ",", res->kernel->name,
+		       result_mips(res) * 1000000, res->ns_per_instr_mean,
+		       res->ns_per_instr_stddev, res->ns_per_instr_min,
+		       res->ns_per_instr_max);
+	}
+	printf("\n\t]\n}\n");
+}
+
+static void report_csv(const struct bench_result *const results,
+		       const size_t num_results)
+{
+	printf("kernel,instructions_per_sec,ns_per_instr,ns_per_instr_stddev,"
+	       "ns_per_instr_min,ns_per_instr_max\n");
+
+	for (size_t i = 0; i < num_results; ++i) {
+		const struct bench_result *const res = &results[i];
+
+		printf("%s,%.0f,%.6f,%.6f,%.6f,%.6f\n", res->kernel->name,
+		       result_mips(res) * 1000000, res->ns_per_instr_mean,
+		       res->ns_per_instr_stddev, res->ns_per_instr_min,
+		       res->ns_per_instr_max);
+	}
+}
+
+static bool kernel_selected(const struct bench_kernel *const kernel)
+{
+	if (!bench.filter_num)
+		return true;
+
+	for (size_t i = 0; i < bench.filter_num; ++i) {
+		if (strcmp(bench.filter[i], kernel->name) == 0)
+			return true;
+	}
+	return false;
+}
+
+static void usage(const char *const argv0)
+{
+	fprintf(stderr,
+		"syntax: %s [options]\n"
+		"\n"
+		"options:\n"
+		"  -n, --instructions N  instructions per run (default %" PRIu64
+		")\n"
+		"  -r, --runs N          measured runs per kernel "
+		"(default %u)\n"
+		"  -k, --kernel NAME     only run NAME; may be repeated\n"
+		"  -f, --format FORMAT   output format: text, json or csv\n"
+		"  -l, --list            list the available kernels\n"
+		"  -S, --stats           print the instruction mix and bus "
+		"traffic of each\n"
+		"                        kernel; needs PSYCHO_ENABLE_STATS\n"
+		"  -T, --timers          print the host time spent in each "
+		"subsystem;\n"
+		"                        needs PSYCHO_ENABLE_TIMERS\n"
+		"  -t, --trace FILE      write a Perfetto timeline of each "
+		"kernel to FILE;\n"
+		"                        needs PSYCHO_ENABLE_TIMERS\n"
+		"  -I, --ir              execute through the IR\n"
+		"  -V, --ir-verify       check the IR against the interpreter "
+		"on each kernel\n"
+		"                        instead of measuring; with -L, check "
+		"the lanes, and\n"
+		"                        with -B, the boot\n"
+		"  -G, --granularity G   compare after every instr or block "
+		"with -V\n"
+		"                        (default block)\n"
+		"  -L, --lanes N         run N copies of each kernel in "
+		"lockstep (at most %u)\n"
+		"                        with different seeds, and report "
+		"their aggregate MIPS\n"
+		"  -x, --interleave N    with -L, run the copies one after "
+		"another for N\n"
+		"                        instructions at a time instead\n"
+		"\n"
+		"boot mode options:\n"
+		"  -B, --boot BIOS       boot BIOS to the shell, then run an "
+		"EXE for -n\n"
+		"                        instructions instead of the kernels\n"
+		"  -e, --exe FILE        EXE to run (default: bundled EXE)\n"
+		"  -i, --idle-skip       skip idle loops and run cache flush "
+		"loops in bulk\n"
+		"                        instead of interpreting them\n"
+		"  -A, --aot FILE        execute through the IR with the "
+		"native module\n"
+		"                        FILE built by psycho-aot for the EXE\n"
+		"  -c, --bios-code FILE  execute through the IR, copying BIOS "
+		"blocks from\n"
+		"                        FILE; translated into it first if "
+		"need be\n"
+		"  -b, --baseline FILE   compare against a saved JSON report\n"
+		"  -s, --save-baseline FILE\n"
+		"                        save the JSON report to FILE\n"
+		"  -m, --max-regression PCT\n"
+		"                        fail if MIPS drop more than PCT "
+		"(default %.1f)\n",
+		argv0, bench.num_instrs, bench.num_runs, (uint)PSYCHO_LANES_MAX,
+		bench.boot.max_regression_pct);
+}
+
+static void kernels_list(void)
+{
+	for (size_t i = 0; i < bench_kernels_num; ++i)
+		printf("%-20s %s\n", bench_kernels[i].name,
+		       bench_kernels[i].desc);
+}
+
+int main(int argc, char **argv)
+{
+	static const struct option opts[] = {
+		// clang-format off
+
+		{ "instructions",	required_argument,	NULL, 'n' },
+		{ "runs",		required_argument,	NULL, 'r' },
+		{ "kernel",		required_argument,	NULL, 'k' },
+		{ "format",		required_argument,	NULL, 'f' },
+		{ "list",		no_argument,		NULL, 'l' },
+		{ "stats",		no_argument,		NULL, 'S' },
+		{ "timers",		no_argument,		NULL, 'T' },
+		{ "trace",		required_argument,	NULL, 't' },
+		{ "ir",			no_argument,		NULL, 'I' },
+		{ "ir-verify",		no_argument,		NULL, 'V' },
+		{ "granularity",	required_argument,	NULL, 'G' },
+		{ "lanes",		required_argument,	NULL, 'L' },
+		{ "interleave",		required_argument,	NULL, 'x' },
+		{ "boot",		required_argument,	NULL, 'B' },
+		{ "exe",		required_argument,	NULL, 'e' },
+		{ "idle-skip",		no_argument,		NULL, 'i' },
+		{ "aot",		required_argument,	NULL, 'A' },
+		{ "bios-code",		required_argument,	NULL, 'c' },
+		{ "baseline",		required_argument,	NULL, 'b' },
+		{ "save-baseline",	required_argument,	NULL, 's' },
+		{ "max-regression",	required_argument,	NULL, 'm' },
+		{ NULL,			0,			NULL, 0 }
+
+		// clang-format on
+	};
+
+	int opt;
+
+	while ((opt = getopt_long(argc, argv,
+				  "n:r:k:f:lSTt:IVG:L:x:B:e:iA:c:b:s:m:", opts,
+				  NULL)) != -1) {
+		switch (opt) {
+		case 'n':
+			bench.num_instrs = strtoull(optarg, NULL, 0);
+			break;
+
+		case 'r':
+			bench.num_runs = strtoul(optarg, NULL, 0);
+			break;
+
+		case 'k':
+			if (bench.filter_num < BENCH_KERNELS_MAX)
+				bench.filter[bench.filter_num++] = optarg;
+			break;
+
+		case 'f':
+			if (strcmp(optarg, "text") == 0) {
+				bench.format = BENCH_FORMAT_TEXT;
+			} else if (strcmp(optarg, "json") == 0) {
+				bench.format = BENCH_FORMAT_JSON;
+			} else if (strcmp(optarg, "csv") == 0) {
+				bench.format = BENCH_FORMAT_CSV;
+			} else {
+				usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+
+		case 'l':
+			kernels_list();
+			return EXIT_SUCCESS;
+
+		case 'S':
+			bench.stats = true;
+			break;
+
+		case 'T':
+			bench.timers = true;
+			break;
+
+		case 't':
+			bench.trace_file = optarg;
+			break;
+
+		case 'I':
+			bench.boot.ir = true;
+			break;
+
+		case 'V':
+			bench.ir_verify = true;
+			break;
+
+		case 'G':
+			if (strcmp(optarg, "instr") == 0) {
+				bench.granularity = PSYCHO_LOCKSTEP_INSTR;
+			} else if (strcmp(optarg, "block") == 0) {
+				bench.granularity = PSYCHO_LOCKSTEP_BLOCK;
+			} else {
+				usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+
+		case 'L':
+			bench.lanes_num = strtoul(optarg, NULL, 0);
+			break;
+
+		case 'x':
+			bench.interleave = strtoull(optarg, NULL, 0);
+			break;
+
+		case 'B':
+			bench.boot.bios_file = optarg;
+			break;
+
+		case 'e':
+			bench.boot.exe_file = optarg;
+			break;
+
+		case 'i':
+			bench.boot.idle_skip = true;
+			break;
+
+		case 'A':
+			bench.boot.aot_file = optarg;
+			bench.boot.ir = true;
+			break;
+
+		case 'c':
+			bench.boot.bios_code_file = optarg;
+			bench.boot.ir = true;
+			break;
+
+		case 'b':
+			bench.boot.baseline_file = optarg;
+			break;
+
+		case 's':
+			bench.boot.save_baseline_file = optarg;
+			break;
+
+		case 'm':
+			bench.boot.max_regression_pct = strtod(optarg, NULL);
+			break;
+
+		default:
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// The lanes run on the interpreter alone, and have no one context to
+	// measure.
+	if (!bench.num_instrs || !bench.num_runs ||
+	    (bench.lanes_num > PSYCHO_LANES_MAX) ||
+	    (bench.interleave && (!bench.lanes_num || bench.ir_verify)) ||
+	    (bench.lanes_num && (bench.boot.ir || bench.stats ||
+				 bench.timers || bench.trace_file ||
+				 bench.boot.bios_file))) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (bench.stats) {
+		struct psycho_stats stats;
+
+		if (!psycho_stats_get(&emu.ctx, &stats)) {
+			fprintf(stderr,
+				"%s: --stats needs psycho to be configured "
+				"with -DPSYCHO_ENABLE_STATS=ON\n",
+				argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (bench.timers || bench.trace_file) {
+		struct psycho_timer_totals totals[PSYCHO_TIMER_ZONE_NUM];
+
+		if (!psycho_timers_get(&emu.ctx, totals)) {
+			fprintf(stderr,
+				"%s: --timers and --trace need psycho to be "
+				"configured with -DPSYCHO_ENABLE_TIMERS=ON\n",
+				argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (bench.boot.bios_file) {
+		if ((bench.format == BENCH_FORMAT_CSV) || bench.stats ||
+		    bench.timers || bench.trace_file) {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+
+		bench.boot.verify = bench.ir_verify;
+		bench.boot.granularity = bench.granularity;
+		bench.boot.ir |= bench.ir_verify;
+		bench.boot.exe_instrs = bench.num_instrs;
+		bench.boot.num_runs = bench.num_runs;
+		bench.boot.json = bench.format == BENCH_FORMAT_JSON;
+
+		return bench_boot(&bench.boot);
+	}
+
+	if (bench.ir_verify) {
+		bool ok = true;
+
+		for (size_t i = 0; i < bench_kernels_num; ++i) {
+			if (!kernel_selected(&bench_kernels[i]))
+				continue;
+
+			if (bench.lanes_num)
+				ok &= kernel_lanes_verify(&bench_kernels[i]);
+			else
+				ok &= kernel_verify(&bench_kernels[i]);
+		}
+		return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (bench.trace_file) {
+		bench.trace_events = malloc(BENCH_TRACE_EVENTS_MAX *
+					    sizeof(*bench.trace_events));
+
+		if (!bench.trace_events ||
+		    !timeline_open(&bench.trace, bench.trace_file)) {
+			fprintf(stderr, "%s: unable to create %s: %s\n",
+				argv[0], bench.trace_file, strerror(errno));
+			return EXIT_FAILURE;
+		}
+	}
+
+	static struct bench_result results[BENCH_KERNELS_MAX];
+	size_t num_results = 0;
+
+	for (size_t i = 0; i < bench_kernels_num; ++i) {
+		if (kernel_selected(&bench_kernels[i])) {
+			kernel_run(&bench_kernels[i], &results[num_results],
+				   num_results);
+			num_results++;
+		}
+	}
+
+	if (bench.trace_file) {
+		free(bench.trace_events);
+
+		if (!timeline_close(&bench.trace)) {
+			fprintf(stderr, "%s: unable to write %s: %s\n",
+				argv[0], bench.trace_file, strerror(errno));
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (!num_results) {
+		fprintf(stderr, "%s: no kernels selected\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	switch (bench.format) {
+	case BENCH_FORMAT_TEXT:
+		report_text(results, num_results);
+		break;
+
+	case BENCH_FORMAT_JSON:
+		report_json(results, num_results);
+		break;
+
+	case BENCH_FORMAT_CSV:
+		report_csv(results, num_results);
+		break;
+
+	default:
+		UNREACHABLE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -25,7 +25,10 @@
 
 #include "core/ctx.h"
 #include "bios-trace.h"
+#include "event.h"
+#include "hooks.h"
 #include "log.h"
+#include "watchdog.h"
 
 LOG_MODULE(PSYCHO_LOG_MODULE_ID_BIOS);
 
@@ -58,8 +61,8 @@ static void handle_tty_output(struct psycho_ctx *const ctx)
 	ctx->bios_trace.tty_stdout.data[ctx->bios_trace.tty_stdout.len++] = c;
 
 	if (c == '\n') {
-		ctx->event_cb(ctx, PSYCHO_EVENT_TTY_MESSAGE,
-			      ctx->bios_trace.tty_stdout.data);
+		psycho_event_raise(ctx, PSYCHO_EVENT_TTY_MESSAGE,
+				   ctx->bios_trace.tty_stdout.data);
 
 		psycho_log_message_dispatch(ctx,
 					    PSYCHO_LOG_MODULE_ID_TTY_STDOUT,
@@ -120,21 +123,31 @@ static void process_prototype(struct psycho_ctx *const ctx)
 #undef SPECIFIER_LEN
 }
 
-void psycho_bios_trace_begin(struct psycho_ctx *const ctx)
+static void b0_hook(struct psycho_ctx *const ctx, const u32 pc,
+		    void *const udata)
 {
-	const u32 func = ctx->cpu.gpr[CPU_GPR_T1];
+	(void)pc;
+	(void)udata;
 
-	if ((ctx->cpu.pc == 0x000000B0) && func == 0x3D) {
-		ctx->bios_trace.curr_func = &b0_funcs[func];
+	const u32 func = ctx->cpu.gpr[CPU_GPR_T1];
 
-		if (ctx->bios_trace.enable_tty_output)
-			handle_tty_output(ctx);
-	} else
+	if (func != 0x3D)
 		return;
 
+	ctx->bios_trace.curr_func = &b0_funcs[func];
+	psycho_watchdog_on_progress(ctx);
+
+	if (ctx->bios_trace.enable_tty_output)
+		handle_tty_output(ctx);
+
 	process_prototype(ctx);
 }
 
+void psycho_bios_trace_init(struct psycho_ctx *const ctx)
+{
+	psycho_hook_add(ctx, 0x000000B0, b0_hook, NULL);
+}
+
 void psycho_bios_trace_end(struct psycho_ctx *const ctx)
 {
 	if ((ctx->bios_trace.curr_func) &&
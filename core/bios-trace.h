@@ -23,8 +23,14 @@
 #pragma once
 
 #include "core/bios-trace.h"
+#include "core/compiler.h"
+#include "core/ctx.h"
 
-struct psycho_ctx;
-
-void psycho_bios_trace_begin(struct psycho_ctx *ctx);
+void psycho_bios_trace_init(struct psycho_ctx *ctx);
 void psycho_bios_trace_end(struct psycho_ctx *ctx);
+
+ALWAYS_INLINE void psycho_bios_trace_on_step_end(struct psycho_ctx *const ctx)
+{
+	if (unlikely(ctx->bios_trace.curr_func != NULL))
+		psycho_bios_trace_end(ctx);
+}
@@ -23,21 +23,20 @@
 #include <string.h>
 
 #include "bus.h"
+#include "lockstep.h"
 #include "log.h"
+#include "stats.h"
+#include "timers.h"
+#include "watch.h"
 
 LOG_MODULE(PSYCHO_LOG_MODULE_ID_BUS);
 
-u32 psycho_bus_peek_word(struct psycho_ctx *const ctx, const u32 paddr)
-{
-	return psycho_bus_load_word(ctx, paddr);
-}
-
-u32 psycho_bus_load_word(struct psycho_ctx *const ctx, const u32 paddr)
+static u32 load_word(struct psycho_ctx *const ctx, const u32 paddr)
 {
 	u32 word;
 
 	switch (paddr) {
-	case RAM_ADDR_START ... RAM_ADDR_END:
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
 		memcpy(&word, &ctx->bus.ram[paddr], sizeof(u32));
 		return word;
 
@@ -50,6 +49,9 @@ u32 psycho_bus_load_word(struct psycho_ctx *const ctx, const u32 paddr)
 		memcpy(&word, &ctx->bus.bios[paddr & 0x000FFFFF], sizeof(u32));
 		return word;
 
+	case CACHE_CONTROL_ADDR:
+		return ctx->bus.cache_control;
+
 	default:
 		LOG_WARN(ctx,
 			 "Unknown word load: 0x%08X; returning 0xFFFF'FFFF",
@@ -58,12 +60,12 @@ u32 psycho_bus_load_word(struct psycho_ctx *const ctx, const u32 paddr)
 	}
 }
 
-u16 psycho_bus_load_halfword(struct psycho_ctx *const ctx, const u32 paddr)
+static u16 load_halfword(struct psycho_ctx *const ctx, const u32 paddr)
 {
 	u16 halfword;
 
 	switch (paddr) {
-	case RAM_ADDR_START ... RAM_ADDR_END:
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
 		memcpy(&halfword, &ctx->bus.ram[paddr], sizeof(u16));
 		return halfword;
 
@@ -80,10 +82,10 @@ u16 psycho_bus_load_halfword(struct psycho_ctx *const ctx, const u32 paddr)
 	return 0xFFFF;
 }
 
-u8 psycho_bus_load_byte(struct psycho_ctx *const ctx, const u32 paddr)
+static u8 load_byte(struct psycho_ctx *const ctx, const u32 paddr)
 {
 	switch (paddr) {
-	case RAM_ADDR_START ... RAM_ADDR_END:
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
 		return ctx->bus.ram[paddr];
 
 	case SCRATCHPAD_ADDR_START ... SCRATCHPAD_ADDR_END:
@@ -99,11 +101,12 @@ u8 psycho_bus_load_byte(struct psycho_ctx *const ctx, const u32 paddr)
 	return 0xFF;
 }
 
-void psycho_bus_store_word(struct psycho_ctx *const ctx, const u32 paddr,
-			   const u32 word)
+static void store_word(struct psycho_ctx *const ctx, const u32 paddr,
+		       const u32 word)
 {
 	switch (paddr) {
-	case RAM_ADDR_START ... RAM_ADDR_END:
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
+		psycho_bus_ram_dirty(ctx, paddr);
 		memcpy(&ctx->bus.ram[paddr], &word, sizeof(u32));
 		return;
 
@@ -112,6 +115,10 @@ void psycho_bus_store_word(struct psycho_ctx *const ctx, const u32 paddr,
 		       sizeof(u32));
 		return;
 
+	case CACHE_CONTROL_ADDR:
+		ctx->bus.cache_control = word;
+		return;
+
 	default:
 		break;
 	}
@@ -120,11 +127,12 @@ void psycho_bus_store_word(struct psycho_ctx *const ctx, const u32 paddr,
 		 word);
 }
 
-void psycho_bus_store_halfword(struct psycho_ctx *const ctx, const u32 paddr,
-			       const u16 halfword)
+static void store_halfword(struct psycho_ctx *const ctx, const u32 paddr,
+			   const u16 halfword)
 {
 	switch (paddr) {
-	case RAM_ADDR_START ... RAM_ADDR_END:
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
+		psycho_bus_ram_dirty(ctx, paddr);
 		memcpy(&ctx->bus.ram[paddr], &halfword, sizeof(u16));
 		return;
 
@@ -141,11 +149,12 @@ void psycho_bus_store_halfword(struct psycho_ctx *const ctx, const u32 paddr,
 		 paddr, halfword);
 }
 
-void psycho_bus_store_byte(struct psycho_ctx *const ctx, const u32 paddr,
-			   const u8 byte)
+static void store_byte(struct psycho_ctx *const ctx, const u32 paddr,
+		       const u8 byte)
 {
 	switch (paddr) {
-	case RAM_ADDR_START ... RAM_ADDR_END:
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
+		psycho_bus_ram_dirty(ctx, paddr);
 		ctx->bus.ram[paddr] = byte;
 		return;
 
@@ -160,3 +169,220 @@ void psycho_bus_store_byte(struct psycho_ctx *const ctx, const u32 paddr,
 	LOG_WARN(ctx, "Unknown byte store: 0x%08X <- 0x%02X; ignoring", paddr,
 		 byte);
 }
+
+void psycho_bus_ram_dirty_range(struct psycho_ctx *const ctx, const u32 paddr,
+				const size_t size)
+{
+	if (!size)
+		return;
+
+	const u32 first = paddr >> RAM_PAGE_SHIFT;
+	const u32 last = (paddr + size - 1) >> RAM_PAGE_SHIFT;
+
+	for (u32 page = first; (page <= last) && (page < RAM_PAGE_NUM); ++page)
+		ctx->bus.ram_dirty[page / 64] |= UINT64_C(1) << (page % 64);
+}
+
+u32 psycho_bus_peek_word(struct psycho_ctx *const ctx, const u32 paddr)
+{
+	return load_word(ctx, paddr);
+}
+
+void psycho_bus_page_flags_set(struct psycho_ctx *const ctx, const u32 vaddr,
+			       const u32 mask, const u8 flag)
+{
+	// Every address matching vaddr under mask lies on one of the pages
+	// spanned by the page number bits left free by the mask.
+	const u32 page_mask = ~((UINT32_C(1) << BUS_PAGE_SHIFT) - 1);
+	const u32 free = ~mask & page_mask;
+
+	if (__builtin_popcount(free) >= __builtin_ctz(BUS_PAGE_SLOTS)) {
+		for (uint i = 0; i < BUS_PAGE_SLOTS; ++i)
+			ctx->bus.page_flags[i] |= flag;
+
+		return;
+	}
+
+	const u32 base = vaddr & ~free & page_mask;
+	u32 sub = 0;
+
+	do {
+		ctx->bus.page_flags[psycho_bus_page_slot(base | sub)] |= flag;
+		sub = (sub - free) & free;
+	} while (sub);
+}
+
+void psycho_bus_page_flags_clear(struct psycho_ctx *const ctx, const u8 flag)
+{
+	for (uint i = 0; i < BUS_PAGE_SLOTS; ++i)
+		ctx->bus.page_flags[i] &= (u8)~flag;
+}
+
+// Returns the byte of host memory backing a physical address for a debugger
+// read, or `NULL` if there is none.
+static const u8 *debug_src(const struct psycho_ctx *const ctx, const u32 paddr)
+{
+	switch (paddr) {
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
+		return &ctx->bus.ram[paddr];
+
+	case SCRATCHPAD_ADDR_START ... SCRATCHPAD_ADDR_END:
+		return &ctx->bus.scratchpad[paddr & 0x00000FFF];
+
+	case BIOS_ADDR_START ... BIOS_ADDR_END:
+		return &ctx->bus.bios[paddr & 0x000FFFFF];
+
+	default:
+		return NULL;
+	}
+}
+
+// As debug_src(), but for a debugger write.
+static u8 *debug_dst(struct psycho_ctx *const ctx, const u32 paddr)
+{
+	switch (paddr) {
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
+		psycho_bus_ram_dirty(ctx, paddr);
+		return &ctx->bus.ram[paddr];
+
+	case SCRATCHPAD_ADDR_START ... SCRATCHPAD_ADDR_END:
+		return &ctx->bus.scratchpad[paddr & 0x00000FFF];
+
+	default:
+		return NULL;
+	}
+}
+
+bool psycho_bus_peek(struct psycho_ctx *const ctx, const u32 vaddr,
+		     u8 *const dst, const size_t size)
+{
+	for (size_t i = 0; i < size; ++i) {
+		const u8 *const src = debug_src(ctx, vaddr_to_paddr(vaddr + i));
+
+		if (!src)
+			return false;
+
+		dst[i] = *src;
+	}
+	return true;
+}
+
+bool psycho_bus_poke(struct psycho_ctx *const ctx, const u32 vaddr,
+		     const u8 *const src, const size_t size)
+{
+	for (size_t i = 0; i < size; ++i) {
+		u8 *const dst = debug_dst(ctx, vaddr_to_paddr(vaddr + i));
+
+		if (!dst)
+			return false;
+
+		*dst = src[i];
+	}
+	return true;
+}
+
+u32 psycho_bus_fetch_word(struct psycho_ctx *const ctx, const u32 paddr)
+{
+	psycho_stats_on_fetch(ctx, paddr);
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_BUS);
+
+	const u32 word = load_word(ctx, paddr);
+
+	psycho_timer_end(ctx);
+	return word;
+}
+
+u32 psycho_bus_fetch_refill(struct psycho_ctx *const ctx, const u32 vaddr)
+{
+	const u32 paddr = vaddr_to_paddr(vaddr);
+
+	// Within a segment, virtual addresses map onto physical ones in a
+	// straight line, so the window covers the whole of RAM or the BIOS as
+	// seen from the segment of the fetch. Fetches from anywhere else are
+	// rare enough to leave the window as it is.
+	if (paddr < RAM_SIZE) {
+		ctx->bus.fetch.host = ctx->bus.ram;
+		ctx->bus.fetch.base = vaddr - paddr;
+		ctx->bus.fetch.size = RAM_SIZE;
+	} else if ((paddr >= BIOS_ADDR_START) && (paddr <= BIOS_ADDR_END)) {
+		ctx->bus.fetch.host = ctx->bus.bios;
+		ctx->bus.fetch.base = vaddr - (paddr - BIOS_ADDR_START);
+		ctx->bus.fetch.size = BIOS_SIZE;
+	}
+	return psycho_bus_fetch_word(ctx, paddr);
+}
+
+u32 psycho_bus_load_word(struct psycho_ctx *const ctx, const u32 paddr)
+{
+	psycho_stats_on_load(ctx, paddr);
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_BUS);
+
+	const u32 word = load_word(ctx, paddr);
+	psycho_watch_on_load(ctx, paddr, sizeof(u32), word);
+
+	psycho_timer_end(ctx);
+	return word;
+}
+
+u16 psycho_bus_load_halfword(struct psycho_ctx *const ctx, const u32 paddr)
+{
+	psycho_stats_on_load(ctx, paddr);
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_BUS);
+
+	const u16 halfword = load_halfword(ctx, paddr);
+	psycho_watch_on_load(ctx, paddr, sizeof(u16), halfword);
+
+	psycho_timer_end(ctx);
+	return halfword;
+}
+
+u8 psycho_bus_load_byte(struct psycho_ctx *const ctx, const u32 paddr)
+{
+	psycho_stats_on_load(ctx, paddr);
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_BUS);
+
+	const u8 byte = load_byte(ctx, paddr);
+	psycho_watch_on_load(ctx, paddr, sizeof(u8), byte);
+
+	psycho_timer_end(ctx);
+	return byte;
+}
+
+void psycho_bus_store_word(struct psycho_ctx *const ctx, const u32 paddr,
+			   const u32 word)
+{
+	psycho_stats_on_store(ctx, paddr);
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_BUS);
+
+	psycho_watch_on_store(ctx, paddr, sizeof(u32), word);
+	psycho_lockstep_on_store(ctx, paddr, sizeof(u32), word);
+	store_word(ctx, paddr, word);
+
+	psycho_timer_end(ctx);
+}
+
+void psycho_bus_store_halfword(struct psycho_ctx *const ctx, const u32 paddr,
+			       const u16 halfword)
+{
+	psycho_stats_on_store(ctx, paddr);
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_BUS);
+
+	psycho_watch_on_store(ctx, paddr, sizeof(u16), halfword);
+	psycho_lockstep_on_store(ctx, paddr, sizeof(u16), halfword);
+	store_halfword(ctx, paddr, halfword);
+
+	psycho_timer_end(ctx);
+}
+
+void psycho_bus_store_byte(struct psycho_ctx *const ctx, const u32 paddr,
+			   const u8 byte)
+{
+	psycho_stats_on_store(ctx, paddr);
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_BUS);
+
+	psycho_watch_on_store(ctx, paddr, sizeof(u8), byte);
+	psycho_lockstep_on_store(ctx, paddr, sizeof(u8), byte);
+	store_byte(ctx, paddr, byte);
+
+	psycho_timer_end(ctx);
+}
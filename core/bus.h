@@ -22,9 +22,17 @@
 
 #pragma once
 
+#include <string.h>
+
 #include "core/bus.h"
+#include "core/compiler.h"
 #include "core/ctx.h"
+#include "cpu-defs.h"
+#include "stats.h"
+#include "timers.h"
 
+u32 psycho_bus_fetch_word(struct psycho_ctx *ctx, u32 paddr);
+u32 psycho_bus_fetch_refill(struct psycho_ctx *ctx, u32 vaddr);
 u32 psycho_bus_load_word(struct psycho_ctx *ctx, u32 paddr);
 u16 psycho_bus_load_halfword(struct psycho_ctx *ctx, u32 paddr);
 u8 psycho_bus_load_byte(struct psycho_ctx *ctx, u32 paddr);
@@ -32,3 +40,66 @@ u8 psycho_bus_load_byte(struct psycho_ctx *ctx, u32 paddr);
 void psycho_bus_store_word(struct psycho_ctx *ctx, u32 paddr, u32 word);
 void psycho_bus_store_halfword(struct psycho_ctx *ctx, u32 paddr, u16 halfword);
 void psycho_bus_store_byte(struct psycho_ctx *ctx, u32 paddr, u8 byte);
+
+void psycho_bus_ram_dirty_range(struct psycho_ctx *ctx, u32 paddr, size_t size);
+
+void psycho_bus_page_flags_set(struct psycho_ctx *ctx, u32 vaddr, u32 mask,
+			       u8 flag);
+void psycho_bus_page_flags_clear(struct psycho_ctx *ctx, u8 flag);
+
+/**
+ * Fetches the instruction at @p vaddr. Code runs from one mapping for long
+ * stretches at a time, so while the fetch stays within the fetch window it is
+ * a bounds check and a read; only leaving the window takes the whole way
+ * through the bus. Either way the fetch is timed in the bus zone, as
+ * psycho_bus_fetch_word() would time it.
+ */
+ALWAYS_INLINE u32 psycho_bus_fetch(struct psycho_ctx *const ctx,
+				   const u32 vaddr)
+{
+	const u32 off = vaddr - ctx->bus.fetch.base;
+
+	if (unlikely(off >= ctx->bus.fetch.size))
+		return psycho_bus_fetch_refill(ctx, vaddr);
+
+	psycho_stats_on_fetch(ctx, vaddr_to_paddr(vaddr));
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_BUS);
+
+	u32 word;
+	memcpy(&word, &ctx->bus.fetch.host[off], sizeof(u32));
+
+	psycho_timer_end(ctx);
+	return word;
+}
+
+/**
+ * Empties the fetch window, for when @ref psycho_bus.ram or
+ * @ref psycho_bus.bios is pointed at other memory; psycho_init() is the only
+ * place either is set.
+ */
+ALWAYS_INLINE void psycho_bus_fetch_flush(struct psycho_ctx *const ctx)
+{
+	ctx->bus.fetch.host = NULL;
+	ctx->bus.fetch.base = 0;
+	ctx->bus.fetch.size = 0;
+}
+
+/** Folds the page of a virtual address onto its page flags entry. */
+ALWAYS_INLINE uint psycho_bus_page_slot(const u32 vaddr)
+{
+	const u32 page = vaddr >> BUS_PAGE_SHIFT;
+	return (page ^ (page >> 10)) & (BUS_PAGE_SLOTS - 1);
+}
+
+ALWAYS_INLINE bool psycho_bus_page_flagged(const struct psycho_ctx *const ctx,
+					   const u32 vaddr, const u8 flag)
+{
+	return ctx->bus.page_flags[psycho_bus_page_slot(vaddr)] & flag;
+}
+
+ALWAYS_INLINE void psycho_bus_ram_dirty(struct psycho_ctx *const ctx,
+					const u32 paddr)
+{
+	const uint page = (paddr & (RAM_SIZE - 1)) >> RAM_PAGE_SHIFT;
+	ctx->bus.ram_dirty[page / 64] |= UINT64_C(1) << (page % 64);
+}
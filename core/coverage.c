@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "coverage.h"
+#include "cpu.h"
+
+void psycho_coverage_enable(struct psycho_ctx *const ctx,
+			    const struct psycho_coverage_cfg *const cfg)
+{
+	memset(&ctx->coverage, 0, sizeof(ctx->coverage));
+
+	if (cfg) {
+		ctx->coverage.cfg = *cfg;
+
+		if (!cfg->edges_size) {
+			ctx->coverage.cfg.edges = NULL;
+		} else {
+			// Edges are indexed by masking, so any other size would
+			// leave part of the map unused.
+			u64 size = 1;
+
+			while ((size < (UINT64_C(1) << 32)) &&
+			       ((size * 2) <= cfg->edges_size))
+				size *= 2;
+
+			ctx->coverage.cfg.edges_size = size;
+			ctx->coverage.edges_mask = (u32)(size - 1);
+		}
+
+		ctx->coverage.enable = true;
+	}
+
+	psycho_cpu_step_select(ctx);
+}
+
+void psycho_coverage_edge(struct psycho_ctx *const ctx, const u32 dst)
+{
+	u8 *const edges = ctx->coverage.cfg.edges;
+
+	if (!edges)
+		return;
+
+	// AFL assigns each block a random ID at compile time; we don't know
+	// where the blocks are in advance, so a hash of the address stands in.
+	u32 loc = (dst >> 2) * 0x9E3779B1;
+	loc ^= loc >> 16;
+
+	u8 *const counter = &edges[(loc ^ ctx->coverage.prev_loc) &
+				   ctx->coverage.edges_mask];
+
+	// Never let a counter wrap around to zero, as that would make a hot
+	// edge look like it was never taken at all.
+	*counter += 1 + (*counter == UINT8_MAX);
+
+	// Shifting keeps A->B distinct from B->A, and A->A from B->B.
+	ctx->coverage.prev_loc = loc >> 1;
+}
+
+void psycho_coverage_exec(struct psycho_ctx *const ctx, const u32 paddr)
+{
+	u8 *bitmap;
+	u32 word;
+
+	switch (paddr) {
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
+		bitmap = ctx->coverage.cfg.exec_ram;
+		word = (paddr & (RAM_SIZE - 1)) / sizeof(u32);
+		break;
+
+	case BIOS_ADDR_START ... BIOS_ADDR_END:
+		bitmap = ctx->coverage.cfg.exec_bios;
+		word = (paddr - BIOS_ADDR_START) / sizeof(u32);
+		break;
+
+	default:
+		return;
+	}
+
+	if (bitmap)
+		bitmap[word / 8] |= 1 << (word % 8);
+}
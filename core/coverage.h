@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "core/compiler.h"
+#include "core/coverage.h"
+#include "core/ctx.h"
+
+void psycho_coverage_edge(struct psycho_ctx *ctx, u32 dst);
+void psycho_coverage_exec(struct psycho_ctx *ctx, u32 paddr);
+
+ALWAYS_INLINE void psycho_coverage_on_edge(struct psycho_ctx *const ctx,
+					   const u32 dst)
+{
+	if (unlikely(ctx->coverage.enable))
+		psycho_coverage_edge(ctx, dst);
+}
+
+ALWAYS_INLINE void psycho_coverage_on_exec(struct psycho_ctx *const ctx,
+					   const u32 paddr)
+{
+	if (unlikely(ctx->coverage.enable))
+		psycho_coverage_exec(ctx, paddr);
+}
@@ -26,10 +26,27 @@
 #include "core/types.h"
 #include "util.h"
 
-#define CPU_DCIC_DR
-#define CPU_DCIC_PC
-#define CPU_DCIC_DE (1 << 23)
-#define CPU_DCIC_DAE (1 << 25)
+enum cpu_dcic {
+	// clang-format off
+
+	CPU_DCIC_DB	= 1 << 0,	// Any break (status)
+	CPU_DCIC_PC	= 1 << 1,	// BPC code break (status)
+	CPU_DCIC_DA	= 1 << 2,	// BDA data break (status)
+	CPU_DCIC_R	= 1 << 3,	// BDA data read break (status)
+	CPU_DCIC_W	= 1 << 4,	// BDA data write break (status)
+	CPU_DCIC_DE	= 1 << 23,	// Super-master enable 1
+	CPU_DCIC_PCE	= 1 << 24,	// Execution breakpoint enable
+	CPU_DCIC_DAE	= 1 << 25,	// Data access breakpoint enable
+	CPU_DCIC_DR	= 1 << 26,	// Break on data read
+	CPU_DCIC_DW	= 1 << 27,	// Break on data write
+	CPU_DCIC_ME	= 1 << 30,	// Master enable
+	CPU_DCIC_SME	= 1U << 31,	// Super-master enable 2
+
+	// Bits 6-11 and 16-22 always read back as zero.
+	CPU_DCIC_WRITE_MASK	= 0xFF80F03F
+
+	// clang-format on
+};
 
 enum instr_group_op {
 	INSTR_GROUP_SPECIAL = 0x00,
@@ -193,3 +210,13 @@ ALWAYS_INLINE u32 vaddr_to_paddr(const u32 vaddr)
 
 	return vaddr & 0x1FFFFFFF;
 }
+
+/** Translates the virtual address of a load or store. */
+ALWAYS_INLINE u32 data_vaddr_to_paddr(u32 vaddr)
+{
+	// Dirty filthy hack!
+	if (vaddr <= 0x00FFFFFF)
+		vaddr &= 0x000FFFFF;
+
+	return vaddr_to_paddr(vaddr);
+}
@@ -27,17 +27,30 @@
 
 #include "cpu.h"
 #include "bus.h"
+#include "coverage.h"
+#include "event.h"
+#include "icache.h"
+#include "idle.h"
 #include "log.h"
+#include "profiler.h"
+#include "stats.h"
 
 LOG_MODULE(PSYCHO_LOG_MODULE_ID_CPU);
 
+// What a variant of the CPU step is built to support; see cpu-step.inc.
+enum cpu_step_feature {
+	/** COP0 breakpoints, cache isolation, coverage and the profiler. */
+	CPU_STEP_DEBUG = 1 << 0
+};
+
 static void illegal(struct psycho_ctx *const ctx)
 {
 	LOG_ERROR(ctx, "Illegal instruction trapped: 0x%08X", ctx->cpu.instr);
-	ctx->event_cb(ctx, PSYCHO_EVENT_CPU_ILLEGAL, NULL);
+	psycho_event_raise(ctx, PSYCHO_EVENT_CPU_ILLEGAL, NULL);
 }
 
-static void branch_if(struct psycho_ctx *const ctx, const bool cond_met)
+ALWAYS_INLINE void branch_if(struct psycho_ctx *const ctx, const bool cond_met,
+			    const bool debug)
 {
 	ctx->cpu.next_in_branch_delay_slot = true;
 	u32 adjust = 0;
@@ -45,23 +58,38 @@ static void branch_if(struct psycho_ctx *const ctx, const bool cond_met)
 	if (unlikely(ctx->cpu.in_branch_delay_slot)) {
 		LOG_WARN(ctx,
 			 "Conditional branch in a branch delay slot detected");
+		psycho_stats_on_branch_in_delay_slot(ctx);
 		adjust = sizeof(u32) * 3;
 	}
 
-	if (cond_met)
+	if (cond_met) {
 		ctx->cpu.next_pc = calc_branch_addr(ctx->cpu.instr,
 						    ctx->cpu.curr_pc + adjust);
+		psycho_idle_on_branch(ctx, ctx->cpu.next_pc);
+	}
+
+	// Either way, a new block starts once the delay slot has executed.
+	if (debug)
+		psycho_coverage_on_edge(ctx, ctx->cpu.next_pc);
 }
 
-static void jmp(struct psycho_ctx *const ctx, const u32 val)
+ALWAYS_INLINE void jmp(struct psycho_ctx *const ctx, const u32 val,
+		       const bool debug)
 {
-	if (unlikely(ctx->cpu.in_branch_delay_slot))
+	if (unlikely(ctx->cpu.in_branch_delay_slot)) {
 		LOG_WARN(
 			ctx,
 			"Unconditional branch in a branch delay slot detected");
+		psycho_stats_on_branch_in_delay_slot(ctx);
+	}
 
 	ctx->cpu.next_in_branch_delay_slot = true;
 	ctx->cpu.next_pc = val;
+
+	if (debug)
+		psycho_coverage_on_edge(ctx, val);
+
+	psycho_idle_on_branch(ctx, val);
 }
 
 static void gpr_set_delayed(struct psycho_ctx *const ctx, const size_t dst,
@@ -75,8 +103,10 @@ static void gpr_set_delayed(struct psycho_ctx *const ctx, const size_t dst,
 	ctx->cpu.ld_pend.dst = dst;
 	ctx->cpu.ld_pend.val = val;
 
-	if (unlikely(ctx->cpu.ld_next.dst == dst))
+	if (unlikely(ctx->cpu.ld_next.dst == dst)) {
+		psycho_stats_on_load_delay_cancel(ctx);
 		memset(&ctx->cpu.ld_next, 0, sizeof(ctx->cpu.ld_next));
+	}
 }
 
 static void load_delay_process(struct psycho_ctx *const ctx)
@@ -104,6 +134,7 @@ static void raise_exception(struct psycho_ctx *const ctx,
 	};
 
 	LOG_WARN(ctx, "%s exception raised", exc_name[exc]);
+	psycho_stats_on_exception(ctx, exc);
 
 	// 1) sets up EPC to point to the restart location.
 	ctx->cpu.cop0[CPU_COP0_EPC] = ctx->cpu.curr_pc;
@@ -125,35 +156,114 @@ static void raise_exception(struct psycho_ctx *const ctx,
 	ctx->cpu.next_pc = 0x00000084;
 }
 
-static void dbg_data_bp_chk(struct psycho_ctx *const ctx, const u32 vaddr)
+// Whether @p enable is set in DCIC, along with every master enable.
+static bool dcic_enabled(const u32 dcic, const u32 enable)
 {
-	if (likely(!(ctx->cpu.cop0[CPU_COP0_DCIC] &
-		     (CPU_DCIC_DE | CPU_DCIC_DAE))))
-		return;
+	const u32 bits = CPU_DCIC_DE | CPU_DCIC_ME | CPU_DCIC_SME | enable;
+	return (dcic & bits) == bits;
+}
 
+// Flags the pages the COP0 breakpoints may match on. Only fetches and accesses
+// on those pages look at the breakpoints at all, and a flag is only ever set
+// while its breakpoint is enabled.
+static void dbg_arm(struct psycho_ctx *const ctx)
+{
+	const u32 *const cop0 = ctx->cpu.cop0;
+	const u32 dcic = cop0[CPU_COP0_DCIC];
+
+	psycho_bus_page_flags_clear(ctx, PSYCHO_BUS_PAGE_DBG_EXEC |
+						 PSYCHO_BUS_PAGE_DBG_READ |
+						 PSYCHO_BUS_PAGE_DBG_WRITE);
+
+	if (dcic_enabled(dcic, CPU_DCIC_PCE))
+		psycho_bus_page_flags_set(ctx, cop0[CPU_COP0_BPC],
+					  cop0[CPU_COP0_BPCM],
+					  PSYCHO_BUS_PAGE_DBG_EXEC);
+
+	if (dcic_enabled(dcic, CPU_DCIC_DAE | CPU_DCIC_DR))
+		psycho_bus_page_flags_set(ctx, cop0[CPU_COP0_BDA],
+					  cop0[CPU_COP0_BDAM],
+					  PSYCHO_BUS_PAGE_DBG_READ);
+
+	if (dcic_enabled(dcic, CPU_DCIC_DAE | CPU_DCIC_DW))
+		psycho_bus_page_flags_set(ctx, cop0[CPU_COP0_BDA],
+					  cop0[CPU_COP0_BDAM],
+					  PSYCHO_BUS_PAGE_DBG_WRITE);
+}
+
+// Unlike other exceptions, a debug break is taken at 0x80000040.
+static void dbg_break(struct psycho_ctx *const ctx, const u32 status)
+{
+	ctx->cpu.cop0[CPU_COP0_DCIC] |= CPU_DCIC_DB | status;
+
+	raise_exception(ctx, EXCEPTION_BP);
+	ctx->cpu.pc = 0x80000040;
+	ctx->cpu.next_pc = 0x80000044;
+}
+
+// Called for fetches from a flagged page; returns true if the breakpoint hit.
+static bool dbg_exec_bp_chk(struct psycho_ctx *const ctx)
+{
+	const u32 bpc = ctx->cpu.cop0[CPU_COP0_BPC];
+	const u32 bpcm = ctx->cpu.cop0[CPU_COP0_BPCM];
+
+	if ((ctx->cpu.curr_pc ^ bpc) & bpcm)
+		return false;
+
+	dbg_break(ctx, CPU_DCIC_PC);
+	return true;
+}
+
+// Called for accesses to a flagged page. As on the real thing, the access
+// itself still completes.
+static void dbg_data_bp_chk(struct psycho_ctx *const ctx, const u32 vaddr,
+			    const enum psycho_bus_page_flag access)
+{
 	const u32 bda = ctx->cpu.cop0[CPU_COP0_BDA];
 	const u32 bdam = ctx->cpu.cop0[CPU_COP0_BDAM];
 
-	if (unlikely(!((vaddr ^ bda) & bdam))) {
-		raise_exception(ctx, EXCEPTION_BP);
-		ctx->cpu.pc = 0x80000040;
-		ctx->cpu.next_pc = 0x80000044;
-	}
+	if ((vaddr ^ bda) & bdam)
+		return;
+
+	dbg_break(ctx, CPU_DCIC_DA | ((access == PSYCHO_BUS_PAGE_DBG_WRITE) ?
+						      CPU_DCIC_W :
+						      CPU_DCIC_R));
 }
 
-static u32 get_phys_addr(struct psycho_ctx *const ctx)
+ALWAYS_INLINE u32 get_phys_addr(struct psycho_ctx *const ctx,
+				const enum psycho_bus_page_flag access,
+				const bool debug)
 {
 	const u16 off = instr_off(ctx->cpu.instr);
 	const uint base = instr_rs(ctx->cpu.instr);
-	u32 vaddr = get_vaddr(off, ctx->cpu.gpr[base]);
+	const u32 vaddr = get_vaddr(off, ctx->cpu.gpr[base]);
 
-	dbg_data_bp_chk(ctx, vaddr);
+	if (debug && unlikely(psycho_bus_page_flagged(ctx, vaddr, access)))
+		dbg_data_bp_chk(ctx, vaddr, access);
+
+	return data_vaddr_to_paddr(vaddr);
+}
+
+ALWAYS_INLINE u32 get_load_addr(struct psycho_ctx *const ctx,
+				const bool debug)
+{
+	return get_phys_addr(ctx, PSYCHO_BUS_PAGE_DBG_READ, debug);
+}
 
-	// Dirty filthy hack!
-	if (vaddr <= 0x00FFFFFF)
-		vaddr &= 0x000FFFFF;
+ALWAYS_INLINE u32 get_store_addr(struct psycho_ctx *const ctx,
+				 const bool debug)
+{
+	return get_phys_addr(ctx, PSYCHO_BUS_PAGE_DBG_WRITE, debug);
+}
 
-	return vaddr_to_paddr(vaddr);
+// While the cache is isolated, stores go to the I-cache instead of memory.
+// The BIOS isolates it to flush it, storing to every line in a tight loop,
+// which is run in one go when possible.
+static void store_isolated(struct psycho_ctx *const ctx, const u32 paddr,
+			   const u32 val, const u32 mask)
+{
+	if (!psycho_icache_loop_run(ctx))
+		psycho_icache_store(ctx, paddr, val, mask);
 }
 
 static void gpr_set(struct psycho_ctx *const ctx, const size_t reg,
@@ -161,8 +271,14 @@ static void gpr_set(struct psycho_ctx *const ctx, const size_t reg,
 {
 	// If the instruction following a load writes to the same destination
 	// register, the load’s delay slot is canceled.
-	if (unlikely(ctx->cpu.ld_next.dst == reg))
+	if (unlikely(ctx->cpu.ld_next.dst == reg)) {
+		// Writes to $zero end up here whenever no load is pending,
+		// which isn't a cancellation at all.
+		if (reg)
+			psycho_stats_on_load_delay_cancel(ctx);
+
 		memset(&ctx->cpu.ld_next, 0, sizeof(ctx->cpu.ld_next));
+	}
 
 	// Don't bother putting a check for a write to gpr[0] here; it's already
 	// bad enough that we have a branch. gpr[0] is unconditionally set to
@@ -170,6 +286,25 @@ static void gpr_set(struct psycho_ctx *const ctx, const size_t reg,
 	ctx->cpu.gpr[reg] = val;
 }
 
+#define CPU_STEP_NAME cpu_step_fast
+#define CPU_STEP_FEATURES 0
+#include "cpu-step.inc"
+
+#define CPU_STEP_NAME cpu_step_debug
+#define CPU_STEP_FEATURES CPU_STEP_DEBUG
+#include "cpu-step.inc"
+
+// Anything the fast variant leaves out has to be off for it to be picked.
+void psycho_cpu_step_select(struct psycho_ctx *const ctx)
+{
+	const u32 *const cop0 = ctx->cpu.cop0;
+	const bool debug = dcic_enabled(cop0[CPU_COP0_DCIC], 0) ||
+			   (cop0[CPU_COP0_SR] & CPU_SR_ISC) ||
+			   ctx->coverage.enable || ctx->profiler.enable;
+
+	ctx->cpu.step = debug ? cpu_step_debug : cpu_step_fast;
+}
+
 void psycho_cpu_reset(struct psycho_ctx *const ctx)
 {
 	ctx->cpu.pc = RESET_PC;
@@ -180,511 +315,72 @@ void psycho_cpu_reset(struct psycho_ctx *const ctx)
 
 	memset(&ctx->cpu.ld_next, 0, sizeof(ctx->cpu.ld_next));
 	memset(&ctx->cpu.ld_pend, 0, sizeof(ctx->cpu.ld_pend));
+
+	dbg_arm(ctx);
+	psycho_cpu_step_select(ctx);
 }
 
-void psycho_cpu_step(struct psycho_ctx *const ctx)
+void psycho_cpu_cop0_set(struct psycho_ctx *const ctx, const uint reg,
+			 const u32 val)
 {
-#define op (instr_op(ctx->cpu.instr))
-#define rt (instr_rt(ctx->cpu.instr))
-#define rd (instr_rd(ctx->cpu.instr))
-#define rs (instr_rs(ctx->cpu.instr))
-#define funct (instr_funct(ctx->cpu.instr))
-#define shamt (instr_shamt(ctx->cpu.instr))
-#define imm (instr_imm(ctx->cpu.instr))
-#define gpr (ctx->cpu.gpr)
-
-	ctx->cpu.in_branch_delay_slot = ctx->cpu.next_in_branch_delay_slot;
-	ctx->cpu.next_in_branch_delay_slot = false;
-
-	load_delay_process(ctx);
-
-	if (unlikely(ctx->cpu.pc & 0x00000003))
-		raise_exception(ctx, EXCEPTION_ADEL);
-
-	ctx->cpu.curr_pc = ctx->cpu.pc;
-	const u32 paddr = vaddr_to_paddr(ctx->cpu.curr_pc);
-	ctx->cpu.instr = psycho_bus_load_word(ctx, paddr);
-
-	ctx->cpu.pc = ctx->cpu.next_pc;
-	ctx->cpu.next_pc = ctx->cpu.pc + sizeof(u32);
-
-	switch (op) {
-	case INSTR_GROUP_SPECIAL:
-		switch (funct) {
-		case INSTR_SLL:
-			gpr_set(ctx, rd, gpr[rt] << shamt);
-			break;
-
-		case INSTR_SRL:
-			gpr_set(ctx, rd, gpr[rt] >> shamt);
-			break;
-
-		case INSTR_SRA:
-			gpr_set(ctx, rd, (s32)gpr[rt] >> shamt);
-			break;
-
-		case INSTR_SLLV:
-			gpr_set(ctx, rd, gpr[rt] << (gpr[rs] & 0x0000001F));
-			break;
-
-		case INSTR_SRLV:
-			gpr_set(ctx, rd, gpr[rt] >> (gpr[rs] & 0x0000001F));
-			break;
-
-		case INSTR_SRAV:
-			gpr_set(ctx, rd,
-				(s32)gpr[rt] >> (gpr[rs] & 0x0000001F));
-			break;
-
-		case INSTR_JR:
-			jmp(ctx, gpr[rs]);
-			break;
-
-		case INSTR_JALR: {
-			const u32 target = gpr[rs];
-
-			gpr_set(ctx, rd, ctx->cpu.curr_pc + (sizeof(u32) * 2));
-
-			if (unlikely(target & 0x00000003)) {
-				raise_exception(ctx, EXCEPTION_ADEL);
-				break;
-			}
-			jmp(ctx, target);
-			break;
-		}
-
-		case INSTR_SYSCALL:
-			raise_exception(ctx, EXCEPTION_SYS);
-			break;
-
-		case INSTR_BREAK:
-			raise_exception(ctx, EXCEPTION_BP);
-			break;
-
-		case INSTR_MFHI:
-			gpr_set(ctx, rd, ctx->cpu.hi);
-			break;
-
-		case INSTR_MTHI:
-			ctx->cpu.hi = gpr[rs];
-			break;
-
-		case INSTR_MFLO:
-			gpr_set(ctx, rd, ctx->cpu.lo);
-			break;
-
-		case INSTR_MTLO:
-			ctx->cpu.lo = gpr[rs];
-			break;
-
-		case INSTR_MULT: {
-			const u64 prod = sign_ext_32_64(gpr[rs]) *
-					 sign_ext_32_64(gpr[rt]);
-
-			ctx->cpu.lo = prod & UINT32_MAX;
-			ctx->cpu.hi = prod >> 32;
-
-			break;
-		}
-
-		case INSTR_MULTU: {
-			const u64 prod = zero_ext_32_64(gpr[rs]) *
-					 zero_ext_32_64(gpr[rt]);
-
-			ctx->cpu.lo = prod & UINT32_MAX;
-			ctx->cpu.hi = prod >> 32;
-
-			break;
-		}
-
-		case INSTR_DIV: {
-			// The result of a division by zero is consistent with
-			// the result of a simple radix-2 (“one bit at a time”)
-			// implementation.
-
-			const s32 divisor = (s32)gpr[rt];
-			const s32 dividend = (s32)gpr[rs];
-
-			if (unlikely(!divisor)) {
-				// That is, if the dividend is negative, the
-				// quotient is 1 (0x00000001), and if the
-				// dividend is positive or zero, the quotient is
-				// -1 (0xFFFFFFFF).
-				ctx->cpu.lo = (dividend < 0) ? 0x000000001 :
-							       UINT32_MAX;
-
-				// In both cases the remainder equals the
-				// dividend.
-				ctx->cpu.hi = dividend;
-			} else if (unlikely(((u32)dividend == 0x80000000) &&
-					    ((u32)divisor == UINT32_MAX))) {
-				ctx->cpu.lo = dividend;
-				ctx->cpu.hi = 0x00000000;
-			} else {
-				ctx->cpu.lo = dividend / divisor;
-				ctx->cpu.hi = dividend % divisor;
-			}
-			break;
-		}
-
-		case INSTR_DIVU: {
-			if (unlikely(!gpr[rt])) {
-				// In the case of unsigned division, the
-				// dividend can't be negative and thus the
-				// quotient is always -1 (0xFFFFFFFF) and the
-				// remainder equals the dividend.
-				ctx->cpu.lo = UINT32_MAX;
-				ctx->cpu.hi = gpr[rs];
-			} else {
-				ctx->cpu.lo = gpr[rs] / gpr[rt];
-				ctx->cpu.hi = gpr[rs] % gpr[rt];
-			}
-			break;
-		}
-
-		case INSTR_ADD: {
-			int sum;
-
-			if (unlikely(__builtin_sadd_overflow(gpr[rs], gpr[rt],
-							     &sum))) {
-				raise_exception(ctx, EXCEPTION_OV);
-				break;
-			}
-			gpr_set(ctx, rd, sum);
-			break;
-		}
-
-		case INSTR_ADDU:
-			gpr_set(ctx, rd, gpr[rs] + gpr[rt]);
-			break;
-
-		case INSTR_SUB: {
-			int diff;
-
-			if (unlikely(__builtin_ssub_overflow(gpr[rs], gpr[rt],
-							     &diff))) {
-				raise_exception(ctx, EXCEPTION_OV);
-				break;
-			}
-			gpr_set(ctx, rd, diff);
-			break;
-		}
-
-		case INSTR_SUBU:
-			gpr_set(ctx, rd, gpr[rs] - gpr[rt]);
-			break;
-
-		case INSTR_AND:
-			gpr_set(ctx, rd, gpr[rs] & gpr[rt]);
-			break;
-
-		case INSTR_OR:
-			gpr_set(ctx, rd, gpr[rs] | gpr[rt]);
-			break;
-
-		case INSTR_XOR:
-			gpr_set(ctx, rd, gpr[rs] ^ gpr[rt]);
-			break;
-
-		case INSTR_NOR:
-			gpr_set(ctx, rd, ~(gpr[rs] | gpr[rt]));
-			break;
-
-		case INSTR_SLT:
-			gpr_set(ctx, rd, (s32)gpr[rs] < (s32)gpr[rt]);
-			break;
-
-		case INSTR_SLTU:
-			gpr_set(ctx, rd, gpr[rs] < gpr[rt]);
-			break;
-
-		default:
-			illegal(ctx);
-			return;
-		}
-		break;
-
-	case INSTR_GROUP_BCOND: {
-		const bool link = (rt & 0x1E) == 0x10;
-		const bool branch = (s32)(gpr[rs] ^ (rt << 31)) < 0;
-
-		if (link)
-			gpr_set(ctx, CPU_GPR_RA,
-				ctx->cpu.curr_pc + (sizeof(u32) * 2));
-
-		branch_if(ctx, branch);
-		break;
-	}
-
-	case INSTR_GROUP_COP0:
-		switch (rs) {
-		case INSTR_COP_MF:
-			gpr_set(ctx, rt, ctx->cpu.cop0[rd]);
-			break;
-
-		case INSTR_COP_MT:
-			ctx->cpu.cop0[rd] = gpr[rt];
-			break;
-
-		default:
-			switch (funct) {
-			case INSTR_RFE:
-				ctx->cpu.cop0[CPU_COP0_SR] =
-					(ctx->cpu.cop0[CPU_COP0_SR] &
-					 0xFFFFFFF0) |
-					((ctx->cpu.cop0[CPU_COP0_SR] &
-					  0x0000003C) >>
-					 2);
-
-				break;
-
-			default:
-				illegal(ctx);
-				return;
-			}
-			break;
-		}
-		break;
-
-	case INSTR_J:
-		jmp(ctx, calc_jmp_addr(ctx->cpu.instr, ctx->cpu.curr_pc));
-		break;
-
-	case INSTR_JAL:
-		gpr_set(ctx, CPU_GPR_RA, ctx->cpu.curr_pc + (sizeof(u32) * 2));
-		jmp(ctx, calc_jmp_addr(ctx->cpu.instr, ctx->cpu.curr_pc));
-
-		break;
-
-	case INSTR_BEQ:
-		branch_if(ctx, gpr[rs] == gpr[rt]);
-		break;
-
-	case INSTR_BNE:
-		branch_if(ctx, gpr[rs] != gpr[rt]);
-		break;
-
-	case INSTR_BLEZ:
-		branch_if(ctx, (s32)gpr[rs] <= 0);
-		break;
-
-	case INSTR_BGTZ:
-		branch_if(ctx, (s32)gpr[rs] > 0);
-		break;
-
-	case INSTR_ADDI: {
-		int sum;
-
-		if (unlikely(__builtin_sadd_overflow(sign_ext_16_32(imm),
-						     gpr[rs], &sum))) {
-			raise_exception(ctx, EXCEPTION_OV);
-			break;
-		}
-		gpr_set(ctx, rt, sum);
-		break;
-	}
-
-	case INSTR_ADDIU:
-		gpr_set(ctx, rt, sign_ext_16_32(imm) + gpr[rs]);
+	switch (reg) {
+	case CPU_COP0_DCIC:
+		ctx->cpu.cop0[reg] = val & CPU_DCIC_WRITE_MASK;
+		dbg_arm(ctx);
 		break;
 
-	case INSTR_SLTI:
-		gpr_set(ctx, rt, (s32)gpr[rs] < (s32)sign_ext_16_32(imm));
+	case CPU_COP0_BPC:
+	case CPU_COP0_BPCM:
+	case CPU_COP0_BDA:
+	case CPU_COP0_BDAM:
+		ctx->cpu.cop0[reg] = val;
+		dbg_arm(ctx);
 		break;
 
-	case INSTR_SLTIU:
-		gpr_set(ctx, rt, gpr[rs] < sign_ext_16_32(imm));
-		break;
-
-	case INSTR_ANDI:
-		gpr_set(ctx, rt, gpr[rs] & imm);
-		break;
-
-	case INSTR_ORI:
-		gpr_set(ctx, rt, gpr[rs] | imm);
-		break;
-
-	case INSTR_XORI:
-		gpr_set(ctx, rt, gpr[rs] ^ imm);
-		break;
-
-	case INSTR_LUI:
-		gpr_set(ctx, rt, imm << 16);
-		break;
-
-	case INSTR_LB: {
-		const u32 m_paddr = get_phys_addr(ctx);
-
-		const u32 val =
-			sign_ext_8_32(psycho_bus_load_byte(ctx, m_paddr));
-
-		gpr_set_delayed(ctx, rt, val);
-		break;
-	}
-
-	case INSTR_LH: {
-		const u32 m_paddr = get_phys_addr(ctx);
-
-		if (unlikely(m_paddr & 1)) {
-			raise_exception(ctx, EXCEPTION_ADEL);
-			break;
-		}
-
-		const u32 val =
-			sign_ext_16_32(psycho_bus_load_halfword(ctx, m_paddr));
-
-		gpr_set_delayed(ctx, rt, val);
-		break;
-	}
-
-	case INSTR_LWL: {
-		const u32 m_paddr = get_phys_addr(ctx);
-		const u32 aligned_paddr = m_paddr & ~3;
-
-		const u32 word = psycho_bus_load_word(ctx, aligned_paddr);
-
-		const uint shift = (m_paddr & 3) * 8;
-		const uint mask = 0x00FFFFFF >> shift;
-
-		const u32 val = (ctx->cpu.ld_next.dst == rt) ?
-					ctx->cpu.ld_next.val :
-					gpr[rt];
-
-		const u32 res = (val & mask) | (word << (24 - shift));
-
-		gpr_set_delayed(ctx, rt, res);
-		break;
-	}
-
-	case INSTR_LW: {
-		const u32 m_paddr = get_phys_addr(ctx);
-
-		if (unlikely(m_paddr & 0x3)) {
-			raise_exception(ctx, EXCEPTION_ADEL);
-			break;
-		}
-
-		const u32 val = psycho_bus_load_word(ctx, m_paddr);
-
-		gpr_set_delayed(ctx, rt, val);
-		break;
-	}
-
-	case INSTR_LBU: {
-		const u32 m_paddr = get_phys_addr(ctx);
-		const u32 val = psycho_bus_load_byte(ctx, m_paddr);
-
-		gpr_set_delayed(ctx, rt, val);
-		break;
-	}
-
-	case INSTR_LHU: {
-		const u32 m_paddr = get_phys_addr(ctx);
-
-		if (unlikely(m_paddr & 1)) {
-			raise_exception(ctx, EXCEPTION_ADEL);
-			break;
-		}
-
-		const u16 val = psycho_bus_load_halfword(ctx, m_paddr);
-		gpr_set_delayed(ctx, rt, val);
-
-		break;
-	}
-
-	case INSTR_LWR: {
-		const u32 m_paddr = get_phys_addr(ctx);
-		const u32 aligned_paddr = m_paddr & ~3;
-
-		const u32 word = psycho_bus_load_word(ctx, aligned_paddr);
-
-		const uint shift = (m_paddr & 3) * 8;
-		const uint mask = 0xFFFFFF00 << (24 - shift);
-
-		const u32 val = (ctx->cpu.ld_next.dst == rt) ?
-					ctx->cpu.ld_next.val :
-					gpr[rt];
-
-		const u32 res = (val & mask) | (word >> shift);
-
-		gpr_set_delayed(ctx, rt, res);
-		break;
-	}
-
-	case INSTR_SB: {
-		const u32 m_paddr = get_phys_addr(ctx);
-
-		psycho_bus_store_byte(ctx, m_paddr, gpr[rt] & UINT8_MAX);
-		break;
-	}
-
-	case INSTR_SH: {
-		const u32 m_paddr = get_phys_addr(ctx);
-
-		if (unlikely(m_paddr & 1)) {
-			raise_exception(ctx, EXCEPTION_ADES);
-			break;
-		}
-
-		psycho_bus_store_halfword(ctx, m_paddr, gpr[rt] & UINT16_MAX);
-		break;
-	}
-
-	case INSTR_SWL: {
-		const u32 m_paddr = get_phys_addr(ctx);
-		const u32 aligned_paddr = m_paddr & ~3;
-
-		const uint shift = (m_paddr & 3) * 8;
-		const uint mask = 0xFFFFFF00 << shift;
-
-		u32 word = psycho_bus_load_word(ctx, aligned_paddr);
-		word = (word & mask) | (gpr[rt] >> (24 - shift));
-		psycho_bus_store_word(ctx, aligned_paddr, word);
-
-		break;
-	}
-
-	case INSTR_SW: {
-		if (ctx->cpu.cop0[CPU_COP0_SR] & CPU_SR_ISC)
-			break;
-
-		const u32 m_paddr = get_phys_addr(ctx);
-
-		if (unlikely(m_paddr & 0x3)) {
-			raise_exception(ctx, EXCEPTION_ADES);
-			break;
-		}
-		psycho_bus_store_word(ctx, m_paddr, gpr[rt]);
-		break;
-	}
-
-	case INSTR_SWR: {
-		const u32 m_paddr = get_phys_addr(ctx);
-		const u32 aligned_paddr = m_paddr & ~3;
-
-		const uint shift = (m_paddr & 3) * 8;
-		const uint mask = 0x00FFFFFF >> (24 - shift);
-
-		u32 word = psycho_bus_load_word(ctx, aligned_paddr);
-		word = (word & mask) | (gpr[rt] << shift);
-		psycho_bus_store_word(ctx, aligned_paddr, word);
-
+	default:
+		ctx->cpu.cop0[reg] = val;
 		break;
 	}
 
-	default:
-		illegal(ctx);
-		return;
-	}
+	psycho_cpu_step_select(ctx);
+}
 
-	gpr[0] = 0x00000000;
+void psycho_cpu_sample_take(const struct psycho_ctx *const ctx,
+			    struct psycho_cpu_sample *const sample)
+{
+	const struct psycho_cpu *const cpu = &ctx->cpu;
+
+	memcpy(sample->gpr, cpu->gpr, sizeof(cpu->gpr));
+	memcpy(sample->cop0, cpu->cop0, sizeof(cpu->cop0));
+
+	sample->hi = cpu->hi;
+	sample->lo = cpu->lo;
+	sample->pc = cpu->pc;
+	sample->next_pc = cpu->next_pc;
+	sample->ld_next_dst = cpu->ld_next.dst;
+	sample->ld_next_val = cpu->ld_next.val;
+	sample->ld_pend_dst = cpu->ld_pend.dst;
+	sample->ld_pend_val = cpu->ld_pend.val;
+	sample->in_branch_delay_slot = cpu->in_branch_delay_slot;
+	sample->next_in_branch_delay_slot = cpu->next_in_branch_delay_slot;
+}
 
-#undef op
-#undef rt
-#undef rd
-#undef rs
-#undef funct
-#undef shamt
-#undef imm
-#undef gpr
+// The PC is checked first, as it is by far the most likely to differ.
+bool psycho_cpu_sample_matches(const struct psycho_ctx *const ctx,
+			       const struct psycho_cpu_sample *const sample)
+{
+	const struct psycho_cpu *const cpu = &ctx->cpu;
+
+	return (sample->pc == cpu->pc) && (sample->next_pc == cpu->next_pc) &&
+	       (sample->hi == cpu->hi) && (sample->lo == cpu->lo) &&
+	       (sample->ld_next_dst == cpu->ld_next.dst) &&
+	       (sample->ld_next_val == cpu->ld_next.val) &&
+	       (sample->ld_pend_dst == cpu->ld_pend.dst) &&
+	       (sample->ld_pend_val == cpu->ld_pend.val) &&
+	       (sample->in_branch_delay_slot == cpu->in_branch_delay_slot) &&
+	       (sample->next_in_branch_delay_slot ==
+		cpu->next_in_branch_delay_slot) &&
+	       (memcmp(sample->gpr, cpu->gpr, sizeof(cpu->gpr)) == 0) &&
+	       (memcmp(sample->cop0, cpu->cop0, sizeof(cpu->cop0)) == 0);
 }
+
@@ -22,7 +22,22 @@
 
 #pragma once
 
+#include "core/compiler.h"
 #include "core/cpu.h"
+#include "core/ctx.h"
 
 void psycho_cpu_reset(struct psycho_ctx *ctx);
-void psycho_cpu_step(struct psycho_ctx *ctx);
+
+// Picks the variant of the step to run from whatever is currently enabled;
+// called whenever any of it changes.
+void psycho_cpu_step_select(struct psycho_ctx *ctx);
+
+void psycho_cpu_sample_take(const struct psycho_ctx *ctx,
+			    struct psycho_cpu_sample *sample);
+PURE_FN bool psycho_cpu_sample_matches(const struct psycho_ctx *ctx,
+				       const struct psycho_cpu_sample *sample);
+
+ALWAYS_INLINE void psycho_cpu_step(struct psycho_ctx *const ctx)
+{
+	ctx->cpu.step(ctx);
+}
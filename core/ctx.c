@@ -23,10 +23,19 @@
 #include <string.h>
 
 #include "bios-trace.h"
+#include "bus.h"
 #include "cpu-defs.h"
 #include "cpu.h"
 #include "disasm.h"
+#include "hooks.h"
+#include "icache.h"
+#include "idle.h"
+#include "ir.h"
 #include "log.h"
+#include "profiler.h"
+#include "timers.h"
+#include "watch.h"
+#include "watchdog.h"
 
 enum {
 	// clang-format off
@@ -49,7 +58,13 @@ void psycho_init(struct psycho_ctx *const ctx,
 {
 	ctx->bus.bios = cfg->bios_data;
 	ctx->bus.ram = cfg->ram_data;
+	psycho_bus_fetch_flush(ctx);
 	ctx->event_cb = cfg->event_cb;
+	ctx->udata = cfg->udata;
+
+	psycho_hooks_reset(ctx);
+	psycho_watch_reset(ctx);
+	psycho_bios_trace_init(ctx);
 
 	psycho_reset(ctx);
 }
@@ -57,21 +72,67 @@ void psycho_init(struct psycho_ctx *const ctx,
 void psycho_reset(struct psycho_ctx *const ctx)
 {
 	psycho_cpu_reset(ctx);
+	psycho_icache_reset(ctx);
 }
 
-void psycho_step(struct psycho_ctx *const ctx)
+bool psycho_step(struct psycho_ctx *const ctx)
 {
-	if (ctx->disasm.trace_instruction)
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_STEP);
+
+	if (psycho_hooks_on_step(ctx)) {
+		psycho_timer_end(ctx);
+		return false;
+	}
+
+	if (ctx->disasm.trace_instruction) {
+		psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_DISASM);
 		psycho_disasm_trace_begin(ctx);
+		psycho_timer_end(ctx);
+	}
 
-	psycho_bios_trace_begin(ctx);
+	psycho_profiler_on_step(ctx);
+	psycho_watchdog_on_step(ctx);
 
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_CPU);
 	psycho_cpu_step(ctx);
+	psycho_timer_end(ctx);
 
-	if (ctx->disasm.trace_instruction)
+	if (ctx->disasm.trace_instruction) {
+		psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_DISASM);
 		psycho_disasm_trace_end(ctx);
+		psycho_timer_end(ctx);
+	}
+
+	psycho_bios_trace_on_step_end(ctx);
 
-	psycho_bios_trace_end(ctx);
+	psycho_timer_end(ctx);
+	return true;
+}
+
+u64 psycho_run(struct psycho_ctx *const ctx, const u64 num_instrs)
+{
+	psycho_idle_on_run_begin(ctx);
+
+	for (u64 i = 0; i < num_instrs; ++i) {
+		const u64 ran = psycho_ir_on_run_step(ctx, num_instrs - i);
+
+		if (ran) {
+			i += ran - 1;
+			continue;
+		}
+
+		psycho_icache_on_run_step_begin(ctx, num_instrs - i - 1);
+
+		const bool stepped = psycho_step(ctx);
+
+		i += psycho_icache_on_run_step_end(ctx);
+
+		if (unlikely(!stepped))
+			return i;
+
+		i += psycho_idle_on_run_step(ctx, num_instrs - i - 1);
+	}
+	return num_instrs;
 }
 
 void psycho_tty_stdout_enable(struct psycho_ctx *const ctx, const bool enable)
@@ -96,16 +157,24 @@ enum psycho_return_code psycho_exe_load(struct psycho_ctx *const ctx,
 	if (memcmp(&exe_data[0], "PS-X EXE", sizeof("PS-X EXE") - 1) != 0)
 		return PSYCHO_EXE_ID_BAD;
 
+	u32 dst_addr = extract_u32(EXE_OFF_DEST_ADDR);
+	dst_addr = vaddr_to_paddr(dst_addr);
+
+	const u32 file_size = extract_u32(EXE_OFF_FILE_SIZE);
+
+	// The EXE may well be a mapping of a file rather than a copy of it, so
+	// never trust the header to describe what was actually handed to us.
+	if ((file_size > (exe_size - EXE_OFF_CODE)) ||
+	    (dst_addr >= RAM_SIZE) || (file_size > (RAM_SIZE - dst_addr)))
+		return PSYCHO_EXE_SIZE_BAD;
+
 	ctx->cpu.pc = extract_u32(EXE_OFF_INITIAL_PC);
 	ctx->cpu.next_pc = ctx->cpu.pc + sizeof(u32);
 
 	ctx->cpu.gpr[CPU_GPR_GP] = extract_u32(EXE_OFF_INITIAL_GP);
 
-	u32 dst_addr = extract_u32(EXE_OFF_DEST_ADDR);
-	dst_addr = vaddr_to_paddr(dst_addr);
-
-	const u32 file_size = extract_u32(EXE_OFF_FILE_SIZE);
 	memcpy(&ctx->bus.ram[dst_addr], &exe_data[EXE_OFF_CODE], file_size);
+	psycho_bus_ram_dirty_range(ctx, dst_addr, file_size);
 
 	ctx->cpu.gpr[CPU_GPR_FP] = extract_u32(EXE_OFF_INITIAL_SP_FP_BASE);
 
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "hooks.h"
+#include "timers.h"
+
+static uint slot_of(const u32 paddr)
+{
+	const uint bits = __builtin_ctz(PSYCHO_HOOKS_SLOTS);
+	return ((paddr >> 2) * 0x9E3779B1) >> (32 - bits);
+}
+
+static uint slot_next(const uint slot)
+{
+	return (slot + 1) & (PSYCHO_HOOKS_SLOTS - 1);
+}
+
+static void page_update(struct psycho_hooks *const hooks, const uint page)
+{
+	bool used = false;
+
+	for (uint i = 0; i < PSYCHO_HOOKS_SLOTS; ++i) {
+		const struct psycho_hook *const hook = &hooks->slots[i];
+
+		if (hook->fn && (psycho_hooks_page(hook->paddr) == page)) {
+			used = true;
+			break;
+		}
+	}
+
+	if (used)
+		hooks->pages[page / 64] |= UINT64_C(1) << (page % 64);
+	else
+		hooks->pages[page / 64] &= ~(UINT64_C(1) << (page % 64));
+}
+
+void psycho_hooks_reset(struct psycho_ctx *const ctx)
+{
+	memset(&ctx->hooks, 0, sizeof(ctx->hooks));
+}
+
+u32 psycho_hook_add(struct psycho_ctx *const ctx, const u32 pc,
+		    const psycho_hook_fn fn, void *const udata)
+{
+	struct psycho_hooks *const hooks = &ctx->hooks;
+
+	if (hooks->num >= PSYCHO_HOOKS_MAX)
+		return 0;
+
+	const u32 paddr = vaddr_to_paddr(pc);
+	uint slot = slot_of(paddr);
+
+	while (hooks->slots[slot].fn)
+		slot = slot_next(slot);
+
+	// Zero is reserved to signal failure.
+	if (++hooks->next_id == 0)
+		++hooks->next_id;
+
+	hooks->slots[slot] = (struct psycho_hook){
+		// clang-format off
+
+		.fn	= fn,
+		.udata	= udata,
+		.paddr	= paddr,
+		.id	= hooks->next_id
+
+		// clang-format on
+	};
+
+	hooks->num++;
+	page_update(hooks, psycho_hooks_page(paddr));
+
+	return hooks->next_id;
+}
+
+bool psycho_hook_remove(struct psycho_ctx *const ctx, const u32 id)
+{
+	struct psycho_hooks *const hooks = &ctx->hooks;
+	uint slot;
+
+	for (slot = 0; slot < PSYCHO_HOOKS_SLOTS; ++slot) {
+		if (hooks->slots[slot].fn && (hooks->slots[slot].id == id))
+			break;
+	}
+
+	if (slot == PSYCHO_HOOKS_SLOTS)
+		return false;
+
+	const uint page = psycho_hooks_page(hooks->slots[slot].paddr);
+
+	// Backward shift deletion: pull later entries of the probe sequence
+	// into the hole, so that lookups never need tombstones to know when to
+	// stop.
+	uint hole = slot;
+
+	for (uint next = slot_next(hole); hooks->slots[next].fn;
+	     next = slot_next(next)) {
+		const uint home = slot_of(hooks->slots[next].paddr);
+
+		// Leave the entry be if its home is cyclically in (hole, next].
+		if (((next - home) & (PSYCHO_HOOKS_SLOTS - 1)) <
+		    ((next - hole) & (PSYCHO_HOOKS_SLOTS - 1)))
+			continue;
+
+		hooks->slots[hole] = hooks->slots[next];
+		hole = next;
+	}
+
+	memset(&hooks->slots[hole], 0, sizeof(hooks->slots[hole]));
+	hooks->num--;
+	page_update(hooks, page);
+
+	return true;
+}
+
+void psycho_hook_stop(struct psycho_ctx *const ctx)
+{
+	ctx->hooks.stop = true;
+}
+
+static void hooks_call(struct psycho_ctx *const ctx, const u32 paddr,
+		       const u32 pc)
+{
+	// Hooks are free to change the table under us, so gather the matches
+	// up front.
+	struct psycho_hook matches[PSYCHO_HOOKS_MAX];
+	uint num_matches = 0;
+
+	for (uint slot = slot_of(paddr); ctx->hooks.slots[slot].fn;
+	     slot = slot_next(slot)) {
+		if (ctx->hooks.slots[slot].paddr == paddr)
+			matches[num_matches++] = ctx->hooks.slots[slot];
+	}
+
+	for (uint i = 0; i < num_matches; ++i)
+		matches[i].fn(ctx, pc, matches[i].udata);
+}
+
+bool psycho_hooks_dispatch(struct psycho_ctx *const ctx)
+{
+	u32 pc = ctx->cpu.pc;
+
+	// A step stopped by a hook is resumed without dispatching its hooks
+	// again. Whatever the host does in between, the first dispatch after
+	// the stop settles it.
+	if (ctx->hooks.resume) {
+		ctx->hooks.resume = false;
+
+		if (pc == ctx->hooks.resume_pc)
+			return false;
+	}
+
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_HOOKS);
+
+	// Hooks redirecting to each other would otherwise never let the step
+	// go on; past the bound, the instruction redirected to just executes.
+	for (uint redirects = 0;; ++redirects) {
+		hooks_call(ctx, vaddr_to_paddr(pc), pc);
+
+		if (ctx->hooks.stop || (ctx->cpu.pc == pc) ||
+		    (redirects == PSYCHO_HOOKS_MAX))
+			break;
+
+		// A hook redirected the PC, so the hooks on the new one get
+		// their turn before it executes too.
+		pc = ctx->cpu.pc;
+
+		const uint page = psycho_hooks_page(pc);
+
+		if (!((ctx->hooks.pages[page / 64] >> (page % 64)) & 1))
+			break;
+	}
+
+	psycho_timer_end(ctx);
+
+	if (!ctx->hooks.stop)
+		return false;
+
+	ctx->hooks.stop = false;
+	ctx->hooks.resume = true;
+	ctx->hooks.resume_pc = pc;
+
+	return true;
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "core/compiler.h"
+#include "core/ctx.h"
+#include "core/hooks.h"
+#include "cpu-defs.h"
+
+void psycho_hooks_reset(struct psycho_ctx *ctx);
+bool psycho_hooks_dispatch(struct psycho_ctx *ctx);
+
+/**
+ * Folds the page of a virtual or physical address into the page bitmap. The
+ * segment bits are dropped first, so that every mirror of a page lands on the
+ * same bit as its physical address without a full translation. The high bits
+ * are mixed in so that the BIOS does not alias the bottom of RAM, where the
+ * kernel's exception and syscall vectors live.
+ */
+ALWAYS_INLINE uint psycho_hooks_page(const u32 addr)
+{
+	const u32 page = (addr & 0x1FFFFFFF) >> PSYCHO_HOOKS_PAGE_SHIFT;
+	return (page ^ (page >> 10)) & (PSYCHO_HOOKS_PAGE_BITS - 1);
+}
+
+/** Returns `true` if a hook stopped the step. */
+ALWAYS_INLINE bool psycho_hooks_on_step(struct psycho_ctx *const ctx)
+{
+	const uint page = psycho_hooks_page(ctx->cpu.pc);
+
+	if (unlikely((ctx->hooks.pages[page / 64] >> (page % 64)) & 1))
+		return psycho_hooks_dispatch(ctx);
+
+	return false;
+}
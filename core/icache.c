@@ -0,0 +1,387 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "bus.h"
+#include "cpu-defs.h"
+#include "icache.h"
+#include "idle.h"
+#include "util.h"
+
+enum {
+	/** The longest flush loop, in instructions, which is run in bulk. */
+	ICACHE_LOOP_LEN_MAX = 32,
+
+	/** The most instructions run in bulk at once, to bound the latency. */
+	ICACHE_LOOP_INSTRS_MAX = 1 << 16
+};
+
+struct flush_loop {
+	u32 instrs[ICACHE_LOOP_LEN_MAX + 1];
+	u32 start;
+
+	/** The number of instructions, including the branch delay slot. */
+	uint len;
+};
+
+void psycho_icache_reset(struct psycho_ctx *const ctx)
+{
+	memset(ctx->icache.tags, 0, sizeof(ctx->icache.tags));
+	memset(ctx->icache.valid, 0, sizeof(ctx->icache.valid));
+	memset(ctx->icache.data, 0, sizeof(ctx->icache.data));
+	ctx->icache.loop_instrs = 0;
+}
+
+void psycho_icache_loop_ffwd_enable(struct psycho_ctx *const ctx,
+				    const bool enable)
+{
+	ctx->icache.loop_ffwd = enable;
+	ctx->icache.loop_budget = 0;
+	ctx->icache.loop_ran = 0;
+}
+
+void psycho_icache_store(struct psycho_ctx *const ctx, const u32 paddr,
+			 const u32 val, const u32 mask)
+{
+	const u32 control = ctx->bus.cache_control;
+
+	if (!(control & PSYCHO_CACHE_CONTROL_ICACHE_ENABLE))
+		return;
+
+	// The BIOS flushes the cache by storing to every line in this mode,
+	// which leaves each of them invalid.
+	if (control & PSYCHO_CACHE_CONTROL_TAG_TEST) {
+		const uint line = (paddr >> 4) & (PSYCHO_ICACHE_LINE_NUM - 1);
+
+		ctx->icache.tags[line] = paddr & 0xFFFFF000;
+		ctx->icache.valid[line] = 0;
+
+		return;
+	}
+
+	u32 *const word =
+		&ctx->icache.data[(paddr >> 2) & (PSYCHO_ICACHE_WORD_NUM - 1)];
+
+	*word = (*word & ~mask) | (val & mask);
+}
+
+// Flush loops do nothing but compute addresses and store to them; anything
+// else, and in particular anything which could touch SR, rules a loop out.
+static bool loop_instr_allowed(const u32 instr)
+{
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_SPECIAL:
+		switch (instr_funct(instr)) {
+		case INSTR_SLL:
+		case INSTR_SRL:
+		case INSTR_SRA:
+		case INSTR_ADDU:
+		case INSTR_SUBU:
+		case INSTR_AND:
+		case INSTR_OR:
+		case INSTR_XOR:
+		case INSTR_NOR:
+		case INSTR_SLT:
+		case INSTR_SLTU:
+			return true;
+
+		default:
+			return false;
+		}
+
+	case INSTR_ADDI:
+	case INSTR_ADDIU:
+	case INSTR_SLTI:
+	case INSTR_SLTIU:
+	case INSTR_ANDI:
+	case INSTR_ORI:
+	case INSTR_XORI:
+	case INSTR_LUI:
+	case INSTR_SB:
+	case INSTR_SH:
+	case INSTR_SW:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+// Finds the loop closed by the first branch at or after the current
+// instruction, which must branch back to or before it.
+static bool loop_find(struct psycho_ctx *const ctx,
+		      struct flush_loop *const loop)
+{
+	const u32 pc = ctx->cpu.curr_pc;
+
+	for (uint i = 0; i < ICACHE_LOOP_LEN_MAX; ++i) {
+		const u32 branch_pc = pc + (i * sizeof(u32));
+		const u32 instr =
+			psycho_bus_peek_word(ctx, vaddr_to_paddr(branch_pc));
+
+		if ((instr_op(instr) != INSTR_BEQ) &&
+		    (instr_op(instr) != INSTR_BNE)) {
+			if (!loop_instr_allowed(instr))
+				return false;
+
+			continue;
+		}
+
+		const u32 start = calc_branch_addr(instr, branch_pc);
+
+		const u32 len_max = ICACHE_LOOP_LEN_MAX * sizeof(u32);
+
+		if ((start > pc) || ((branch_pc - start) >= len_max))
+			return false;
+
+		loop->start = start;
+		loop->len = ((branch_pc - start) / sizeof(u32)) + 2;
+
+		for (uint j = 0; j < loop->len; ++j) {
+			const u32 addr = start + (j * sizeof(u32));
+
+			loop->instrs[j] =
+				psycho_bus_peek_word(ctx, vaddr_to_paddr(addr));
+
+			if ((addr != branch_pc) &&
+			    !loop_instr_allowed(loop->instrs[j]))
+				return false;
+		}
+		return psycho_idle_ffwd_code_allowed(ctx, start,
+						     branch_pc + sizeof(u32));
+	}
+	return false;
+}
+
+// Returns `false` if the store would raise an exception.
+static bool loop_store_run(struct psycho_ctx *const ctx, const u32 instr)
+{
+	const u32 vaddr =
+		get_vaddr(instr_off(instr), ctx->cpu.gpr[instr_rs(instr)]);
+	const u32 paddr = data_vaddr_to_paddr(vaddr);
+	const u32 val = ctx->cpu.gpr[instr_rt(instr)];
+	const uint shift = (paddr & 3) * 8;
+
+	switch (instr_op(instr)) {
+	case INSTR_SB:
+		psycho_icache_store(ctx, paddr, val << shift,
+				    UINT32_C(0x000000FF) << shift);
+		return true;
+
+	case INSTR_SH:
+		if (paddr & 1)
+			return false;
+
+		psycho_icache_store(ctx, paddr, val << shift,
+				    UINT32_C(0x0000FFFF) << shift);
+		return true;
+
+	default:
+		if (paddr & 3)
+			return false;
+
+		psycho_icache_store(ctx, paddr, val, UINT32_MAX);
+		return true;
+	}
+}
+
+// Executes one instruction of a flush loop exactly as psycho_cpu_step()
+// would; returns `false` if it would raise an exception.
+static bool loop_instr_run(struct psycho_ctx *const ctx, const u32 instr,
+			   bool *const taken)
+{
+	u32 *const gpr = ctx->cpu.gpr;
+
+	const uint rs = instr_rs(instr);
+	const uint rt = instr_rt(instr);
+	const u16 imm = instr_imm(instr);
+
+	uint dst = rt;
+	u32 res;
+
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_SPECIAL:
+		dst = instr_rd(instr);
+
+		switch (instr_funct(instr)) {
+		case INSTR_SLL:
+			res = gpr[rt] << instr_shamt(instr);
+			break;
+
+		case INSTR_SRL:
+			res = gpr[rt] >> instr_shamt(instr);
+			break;
+
+		case INSTR_SRA:
+			res = (s32)gpr[rt] >> instr_shamt(instr);
+			break;
+
+		case INSTR_ADDU:
+			res = gpr[rs] + gpr[rt];
+			break;
+
+		case INSTR_SUBU:
+			res = gpr[rs] - gpr[rt];
+			break;
+
+		case INSTR_AND:
+			res = gpr[rs] & gpr[rt];
+			break;
+
+		case INSTR_OR:
+			res = gpr[rs] | gpr[rt];
+			break;
+
+		case INSTR_XOR:
+			res = gpr[rs] ^ gpr[rt];
+			break;
+
+		case INSTR_NOR:
+			res = ~(gpr[rs] | gpr[rt]);
+			break;
+
+		case INSTR_SLT:
+			res = (s32)gpr[rs] < (s32)gpr[rt];
+			break;
+
+		case INSTR_SLTU:
+			res = gpr[rs] < gpr[rt];
+			break;
+
+		default:
+			UNREACHABLE;
+		}
+		break;
+
+	case INSTR_BEQ:
+		*taken = gpr[rs] == gpr[rt];
+		return true;
+
+	case INSTR_BNE:
+		*taken = gpr[rs] != gpr[rt];
+		return true;
+
+	case INSTR_ADDI: {
+		int sum;
+
+		if (__builtin_sadd_overflow(sign_ext_16_32(imm), gpr[rs], &sum))
+			return false;
+
+		res = sum;
+		break;
+	}
+
+	case INSTR_ADDIU:
+		res = gpr[rs] + sign_ext_16_32(imm);
+		break;
+
+	case INSTR_SLTI:
+		res = (s32)gpr[rs] < (s32)sign_ext_16_32(imm);
+		break;
+
+	case INSTR_SLTIU:
+		res = gpr[rs] < sign_ext_16_32(imm);
+		break;
+
+	case INSTR_ANDI:
+		res = gpr[rs] & imm;
+		break;
+
+	case INSTR_ORI:
+		res = gpr[rs] | imm;
+		break;
+
+	case INSTR_XORI:
+		res = gpr[rs] ^ imm;
+		break;
+
+	case INSTR_LUI:
+		res = (u32)imm << 16;
+		break;
+
+	default:
+		return loop_store_run(ctx, instr);
+	}
+
+	if (dst)
+		gpr[dst] = res;
+
+	return true;
+}
+
+bool psycho_icache_loop_run(struct psycho_ctx *const ctx)
+{
+	struct flush_loop loop;
+
+	const u64 budget = ctx->icache.loop_budget;
+
+	// A pending load would land part way through the loop. Without a budget
+	// from psycho_run(), the step may only run its own instruction.
+	if (!budget || ctx->cpu.in_branch_delay_slot || ctx->cpu.ld_next.dst ||
+	    !psycho_idle_ffwd_allowed(ctx) || !loop_find(ctx, &loop))
+		return false;
+
+	const uint delay_slot = loop.len - 1;
+	uint i = (ctx->cpu.curr_pc - loop.start) / sizeof(u32);
+
+	bool taken = false;
+	u32 num_instrs = 0;
+
+	// Stop short of anything which would raise an exception, and leave it
+	// to be stepped through. The store which got us here is the step's own
+	// instruction, so the budget only covers the ones after it.
+	while ((num_instrs < ICACHE_LOOP_INSTRS_MAX) &&
+	       (num_instrs <= budget) &&
+	       loop_instr_run(ctx, loop.instrs[i], &taken)) {
+		num_instrs++;
+
+		if (i != delay_slot) {
+			i++;
+			continue;
+		}
+
+		if (!taken) {
+			i = loop.len;
+			break;
+		}
+
+		taken = false;
+		i = 0;
+	}
+
+	if (!num_instrs)
+		return false;
+
+	const u32 pc = loop.start + (i * sizeof(u32));
+	const bool in_delay_slot = i == delay_slot;
+
+	ctx->cpu.pc = pc;
+	ctx->cpu.next_pc = (in_delay_slot && taken) ? loop.start :
+						      (pc + sizeof(u32));
+	ctx->cpu.next_in_branch_delay_slot = in_delay_slot;
+
+	// The store which got us here is accounted for by the step.
+	ctx->icache.loop_ran = num_instrs - 1;
+	ctx->icache.loop_instrs += num_instrs - 1;
+	return true;
+}
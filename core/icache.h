@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "core/compiler.h"
+#include "core/ctx.h"
+#include "core/icache.h"
+#include "cpu-defs.h"
+
+void psycho_icache_reset(struct psycho_ctx *ctx);
+
+/**
+ * Stores the bytes of @p val selected by @p mask into the isolated cache, at
+ * the word containing @p paddr.
+ */
+void psycho_icache_store(struct psycho_ctx *ctx, u32 paddr, u32 val, u32 mask);
+
+/**
+ * Runs the rest of a cache flush loop in one go, starting with the isolated
+ * store being executed; returns `false` if the store is not part of one, in
+ * which case nothing has been done.
+ */
+bool psycho_icache_loop_run(struct psycho_ctx *ctx);
+
+/**
+ * Notes that psycho_run() is about to step with @p budget instructions left
+ * to run after that step.
+ */
+ALWAYS_INLINE void psycho_icache_on_run_step_begin(struct psycho_ctx *const ctx,
+						   const u64 budget)
+{
+	if (unlikely(ctx->icache.loop_ffwd))
+		ctx->icache.loop_budget = budget;
+}
+
+/**
+ * Notes the end of a step taken by psycho_run(); returns the number of
+ * instructions it ran in bulk on top of its own.
+ */
+ALWAYS_INLINE u64 psycho_icache_on_run_step_end(struct psycho_ctx *const ctx)
+{
+	if (likely(!ctx->icache.loop_ffwd))
+		return 0;
+
+	const u64 ran = ctx->icache.loop_ran;
+
+	ctx->icache.loop_budget = 0;
+	ctx->icache.loop_ran = 0;
+
+	return ran;
+}
+
+ALWAYS_INLINE bool psycho_icache_isolated(const struct psycho_ctx *const ctx)
+{
+	return ctx->cpu.cop0[CPU_COP0_SR] & CPU_SR_ISC;
+}
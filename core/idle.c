@@ -0,0 +1,231 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "bus.h"
+#include "cpu-defs.h"
+#include "cpu.h"
+#include "hooks.h"
+#include "idle.h"
+
+enum {
+	/** Times a loop may miss its sample before it is given up on. */
+	IDLE_MISSES_MAX = 2
+};
+
+void psycho_idle_skip_enable(struct psycho_ctx *const ctx, const bool enable)
+{
+	memset(&ctx->idle, 0, sizeof(ctx->idle));
+	ctx->idle.enable = enable;
+}
+
+// Anything which observes individual instructions would miss the ones
+// skipped.
+bool psycho_idle_ffwd_allowed(const struct psycho_ctx *const ctx)
+{
+	return !ctx->profiler.enable && !ctx->watchdog.enable &&
+	       !ctx->coverage.enable && !ctx->disasm.trace_instruction &&
+	       !ctx->watch.used &&
+	       !(ctx->cpu.cop0[CPU_COP0_DCIC] & CPU_DCIC_DE);
+}
+
+// Loop bodies may only compute; anything which could store, trap or leave the
+// loop other than by falling out of its branch disqualifies it. The CPU state
+// comparison catches everything else.
+static bool body_instr_allowed(const u32 instr)
+{
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_SPECIAL:
+		switch (instr_funct(instr)) {
+		case INSTR_SLL:
+		case INSTR_SRL:
+		case INSTR_SRA:
+		case INSTR_SLLV:
+		case INSTR_SRLV:
+		case INSTR_SRAV:
+		case INSTR_MFHI:
+		case INSTR_MFLO:
+		case INSTR_ADDU:
+		case INSTR_SUBU:
+		case INSTR_AND:
+		case INSTR_OR:
+		case INSTR_XOR:
+		case INSTR_NOR:
+		case INSTR_SLT:
+		case INSTR_SLTU:
+			return true;
+
+		default:
+			return false;
+		}
+
+	case INSTR_ADDIU:
+	case INSTR_SLTI:
+	case INSTR_SLTIU:
+	case INSTR_ANDI:
+	case INSTR_ORI:
+	case INSTR_XORI:
+	case INSTR_LUI:
+	case INSTR_LB:
+	case INSTR_LH:
+	case INSTR_LWL:
+	case INSTR_LW:
+	case INSTR_LBU:
+	case INSTR_LHU:
+	case INSTR_LWR:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+static bool branch_instr_allowed(const u32 instr)
+{
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_BCOND:
+		return (instr_rt(instr) == INSTR_BLTZ) ||
+		       (instr_rt(instr) == INSTR_BGEZ);
+
+	case INSTR_J:
+	case INSTR_BEQ:
+	case INSTR_BNE:
+	case INSTR_BLEZ:
+	case INSTR_BGTZ:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+bool psycho_idle_ffwd_code_allowed(const struct psycho_ctx *const ctx,
+				   const u32 start, const u32 end)
+{
+	for (u32 pc = start; pc <= end; pc += sizeof(u32)) {
+		const uint page = psycho_hooks_page(pc);
+
+		if ((ctx->hooks.pages[page / 64] >> (page % 64)) & 1)
+			return false;
+
+		if (psycho_bus_page_flagged(ctx, pc, PSYCHO_BUS_PAGE_DBG_EXEC))
+			return false;
+	}
+	return true;
+}
+
+static bool loop_is_candidate(struct psycho_ctx *const ctx, const u32 start,
+			      const u32 branch_pc)
+{
+	if (ctx->cpu.in_branch_delay_slot ||
+	    !branch_instr_allowed(ctx->cpu.instr) ||
+	    !psycho_idle_ffwd_code_allowed(ctx, start,
+					   branch_pc + sizeof(u32)))
+		return false;
+
+	for (u32 pc = start; pc <= (branch_pc + sizeof(u32));
+	     pc += sizeof(u32)) {
+		if ((pc != branch_pc) &&
+		    !body_instr_allowed(
+			    psycho_bus_peek_word(ctx, vaddr_to_paddr(pc))))
+			return false;
+	}
+	return true;
+}
+
+static uint reject_slot(const u32 branch_pc)
+{
+	return (branch_pc / sizeof(u32)) & (PSYCHO_IDLE_REJECT_SLOTS - 1);
+}
+
+static void reject(struct psycho_ctx *const ctx, const u32 branch_pc)
+{
+	ctx->idle.rejected[reject_slot(branch_pc)] = branch_pc;
+	ctx->idle.armed = false;
+}
+
+void psycho_idle_branch(struct psycho_ctx *const ctx, const u32 target)
+{
+	struct psycho_idle *const idle = &ctx->idle;
+	const u32 branch_pc = ctx->cpu.curr_pc;
+
+	if (idle->armed && (idle->loop_start == target) &&
+	    (idle->loop_end == (branch_pc + sizeof(u32))))
+		return;
+
+	idle->armed = false;
+
+	if ((idle->rejected[reject_slot(branch_pc)] == branch_pc) ||
+	    !psycho_idle_ffwd_allowed(ctx))
+		return;
+
+	if (!loop_is_candidate(ctx, target, branch_pc)) {
+		reject(ctx, branch_pc);
+		return;
+	}
+
+	idle->loop_start = target;
+	idle->loop_end = branch_pc + sizeof(u32);
+	idle->misses = 0;
+	idle->sampled = false;
+	idle->armed = true;
+}
+
+u64 psycho_idle_follow(struct psycho_ctx *const ctx, const u64 budget)
+{
+	struct psycho_idle *const idle = &ctx->idle;
+	const u32 pc = ctx->cpu.pc;
+
+	if ((pc < idle->loop_start) || (pc > idle->loop_end)) {
+		idle->armed = false;
+		return 0;
+	}
+
+	idle->period++;
+
+	if (pc != idle->loop_start)
+		return 0;
+
+	// Loop-invariant registers may take an iteration or two to settle
+	// after the loop is entered.
+	if (!idle->sampled ||
+	    !psycho_cpu_sample_matches(ctx, &idle->sample)) {
+		if (idle->sampled && (++idle->misses >= IDLE_MISSES_MAX)) {
+			reject(ctx, idle->loop_end - sizeof(u32));
+			return 0;
+		}
+
+		psycho_cpu_sample_take(ctx, &idle->sample);
+		idle->sampled = true;
+		idle->period = 0;
+
+		return 0;
+	}
+
+	const u64 skipped = budget - (budget % idle->period);
+
+	idle->skipped += skipped;
+	idle->period = 0;
+
+	return skipped;
+}
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "core/compiler.h"
+#include "core/ctx.h"
+#include "core/idle.h"
+
+void psycho_idle_branch(struct psycho_ctx *ctx, u32 target);
+u64 psycho_idle_follow(struct psycho_ctx *ctx, u64 budget);
+
+/**
+ * Returns `false` if anything is watching individual instructions, in which
+ * case none may be executed other than one step at a time.
+ */
+PURE_FN bool psycho_idle_ffwd_allowed(const struct psycho_ctx *ctx);
+
+/**
+ * Returns `false` if a hook or a COP0 execution breakpoint may be placed on
+ * any instruction from @p start to @p end inclusive.
+ */
+PURE_FN bool psycho_idle_ffwd_code_allowed(const struct psycho_ctx *ctx,
+					   u32 start, u32 end);
+
+/** Notes a taken branch or jump to @p target. */
+ALWAYS_INLINE void psycho_idle_on_branch(struct psycho_ctx *const ctx,
+					 const u32 target)
+{
+	const u32 pc = ctx->cpu.curr_pc;
+
+	if (unlikely(ctx->idle.enable) && (target <= pc) &&
+	    ((pc - target) < (PSYCHO_IDLE_LOOP_LEN_MAX * sizeof(u32))))
+		psycho_idle_branch(ctx, target);
+}
+
+/**
+ * Notes a step taken by psycho_run(), with @p budget instructions left to
+ * run; returns the number of instructions skipped.
+ */
+ALWAYS_INLINE u64 psycho_idle_on_run_step(struct psycho_ctx *const ctx,
+					  const u64 budget)
+{
+	if (unlikely(ctx->idle.armed))
+		return psycho_idle_follow(ctx, budget);
+
+	return 0;
+}
+
+/**
+ * The host may have changed memory or hooks since the last psycho_run(), so
+ * a loop must be analyzed afresh before it is skipped again.
+ */
+ALWAYS_INLINE void psycho_idle_on_run_begin(struct psycho_ctx *const ctx)
+{
+	ctx->idle.armed = false;
+}
@@ -26,6 +26,9 @@
 extern "C" {
 #endif // __cplusplus
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "types.h"
 
 struct psycho_ctx;
@@ -37,21 +40,119 @@ enum {
 
 	BIOS_ADDR_START = 0x1FC00000,
 	BIOS_ADDR_END = 0x1FC7FFFF,
-	BIOS_SIZE = BIOS_ADDR_END - BIOS_ADDR_START,
+	BIOS_SIZE = BIOS_ADDR_END - BIOS_ADDR_START + 1,
 
 	SCRATCHPAD_ADDR_START = 0x1F800000,
 	SCRATCHPAD_ADDR_END = 0x1F8003FF,
-	SCRATCHPAD_SIZE = SCRATCHPAD_ADDR_END - SCRATCHPAD_ADDR_START
+	SCRATCHPAD_SIZE = SCRATCHPAD_ADDR_END - SCRATCHPAD_ADDR_START + 1,
+
+	IO_ADDR_START = 0x1F801000,
+	IO_ADDR_END = 0x1F803FFF,
+
+	CACHE_CONTROL_ADDR = 0xFFFE0130
+};
+
+enum {
+	RAM_PAGE_SHIFT = 12,
+	RAM_PAGE_SIZE = 1 << RAM_PAGE_SHIFT,
+	RAM_PAGE_NUM = RAM_SIZE / RAM_PAGE_SIZE
+};
+
+enum {
+	/** @brief The granularity of the page flags. */
+	BUS_PAGE_SHIFT = 12,
+
+	/** @brief The number of page flags, onto which pages are folded. */
+	BUS_PAGE_SLOTS = 1024
+};
+
+enum psycho_bus_page_flag {
+	/** @brief A COP0 execution breakpoint may match on the page. */
+	PSYCHO_BUS_PAGE_DBG_EXEC = 1 << 0,
+
+	/** @brief A COP0 data read breakpoint may match on the page. */
+	PSYCHO_BUS_PAGE_DBG_READ = 1 << 1,
+
+	/** @brief A COP0 data write breakpoint may match on the page. */
+	PSYCHO_BUS_PAGE_DBG_WRITE = 1 << 2,
+
+	/** @brief A read watchpoint covers the physical page. */
+	PSYCHO_BUS_PAGE_WATCH_READ = 1 << 3,
+
+	/** @brief A write watchpoint covers the physical page. */
+	PSYCHO_BUS_PAGE_WATCH_WRITE = 1 << 4,
+
+	/** @brief Writes to the page are recorded for lockstep execution. */
+	PSYCHO_BUS_PAGE_LOCKSTEP = 1 << 5
 };
 
 struct psycho_bus {
 	u8 scratchpad[SCRATCHPAD_SIZE];
-	u8 *bios;
+	const u8 *bios;
 	u8 *ram;
+
+	/**
+	 * @brief One bit per page of RAM, set whenever the page is written;
+	 * cleared by taking or restoring a snapshot.
+	 */
+	u64 ram_dirty[RAM_PAGE_NUM / 64];
+
+	/**
+	 * @brief Flags for pages whose fetches or accesses need a closer
+	 * look; any page without flags takes the fast path. Several pages
+	 * share each entry, so a flag only means a match is possible.
+	 */
+	u8 page_flags[BUS_PAGE_SLOTS];
+
+	/** @brief The cache control register at 0xFFFE0130. */
+	u32 cache_control;
+
+	/**
+	 * @brief The fetch window: the RAM or BIOS mapping instructions were
+	 * last fetched from, as host memory holding the @ref size bytes from
+	 * virtual address @ref base on. Empty until the first fetch.
+	 *
+	 * The window records where code lives, never what it holds, so stores
+	 * (into code or anywhere else) leave it alone; it only goes stale when
+	 * @ref ram or @ref bios is pointed elsewhere.
+	 */
+	struct {
+		const u8 *host;
+		u32 base;
+		u32 size;
+	} fetch;
 };
 
 u32 psycho_bus_peek_word(struct psycho_ctx *ctx, u32 paddr);
 
+/**
+ * @brief Reads guest memory on behalf of a debugger.
+ *
+ * Nothing is logged, counted or timed, and no memory-mapped registers are
+ * touched.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param vaddr The virtual address to start reading from.
+ * @param dst Where to store the data read.
+ * @param size The number of bytes to read.
+ * @return `true` if every byte was backed by memory, `false` otherwise.
+ */
+bool psycho_bus_peek(struct psycho_ctx *ctx, u32 vaddr, u8 *dst, size_t size);
+
+/**
+ * @brief Writes guest memory on behalf of a debugger.
+ *
+ * Only RAM and the scratchpad are writable; the BIOS is owned by the host.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param vaddr The virtual address to start writing to.
+ * @param src The data to write.
+ * @param size The number of bytes to write.
+ * @return `true` if every byte was written, `false` otherwise.
+ */
+bool psycho_bus_poke(struct psycho_ctx *ctx, u32 vaddr, const u8 *src,
+		     size_t size);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -27,6 +27,8 @@ extern "C" {
 #endif // __cplusplus
 
 #define ALWAYS_INLINE __attribute__((always_inline)) static inline
+#define CONST_FN __attribute__((const))
+#define PURE_FN __attribute__((pure))
 #define UNREACHABLE __builtin_unreachable()
 
 #define likely(x) __builtin_expect(!!(x), 1)
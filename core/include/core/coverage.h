@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file coverage.h Defines the interface to guest code coverage collection.
+ *
+ * Two kinds of coverage are collected, each into a buffer owned by the host:
+ *
+ * - An AFL-style edge map: every control transfer hashes its destination
+ *   together with the previous destination, and bumps the counter at that
+ *   index. Both outcomes of a conditional branch count as control transfers.
+ *
+ * - Executed bitmaps with one bit per instruction word of RAM and of BIOS,
+ *   set whenever an instruction is fetched from that word.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bus.h"
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	/** @brief The size of the edge map used by AFL and its descendants. */
+	PSYCHO_COVERAGE_EDGES_SIZE_DEFAULT = 65536,
+
+	/** @brief The size of the RAM executed bitmap in bytes. */
+	PSYCHO_COVERAGE_EXEC_RAM_SIZE = RAM_SIZE / sizeof(u32) / 8,
+
+	/** @brief The size of the BIOS executed bitmap in bytes. */
+	PSYCHO_COVERAGE_EXEC_BIOS_SIZE = BIOS_SIZE / sizeof(u32) / 8
+};
+
+struct psycho_coverage_cfg {
+	/** @brief The edge map, or `NULL` to not collect edges. */
+	u8 *edges;
+
+	/**
+	 * @brief The size of @ref edges. Edges are indexed by masking, so only
+	 * the largest power of two no bigger than this is used.
+	 */
+	size_t edges_size;
+
+	/**
+	 * @brief The RAM executed bitmap of PSYCHO_COVERAGE_EXEC_RAM_SIZE
+	 * bytes, or `NULL`. Bit `n % 8` of byte `n / 8` covers the word at
+	 * physical address `n * 4`.
+	 */
+	u8 *exec_ram;
+
+	/**
+	 * @brief The BIOS executed bitmap of PSYCHO_COVERAGE_EXEC_BIOS_SIZE
+	 * bytes, or `NULL`; laid out as @ref exec_ram, relative to the start of
+	 * the BIOS.
+	 */
+	u8 *exec_bios;
+};
+
+struct psycho_coverage {
+	struct psycho_coverage_cfg cfg;
+	u32 edges_mask;
+	u32 prev_loc;
+	bool enable;
+};
+
+/**
+ * @brief Starts or stops collecting coverage.
+ *
+ * The buffers are never cleared by the core, so coverage accumulates across
+ * runs until the host clears them.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param cfg The buffers to collect into, or `NULL` to stop collecting.
+ */
+void psycho_coverage_enable(struct psycho_ctx *ctx,
+			    const struct psycho_coverage_cfg *cfg);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -51,8 +51,46 @@ struct psycho_cpu {
 
 	bool next_in_branch_delay_slot;
 	bool in_branch_delay_slot;
+
+	/**
+	 * @brief The variant of the step currently in use; only those parts of
+	 * the emulator which are enabled are built into it.
+	 */
+	void (*step)(struct psycho_ctx *ctx);
+};
+
+/**
+ * @brief A copy of every part of the CPU state which decides what the CPU
+ * does next; two equal samples mean the CPU will behave identically from
+ * either point.
+ */
+struct psycho_cpu_sample {
+	u32 gpr[CPU_GPR_NUM];
+	u32 cop0[CPU_COP0_NUM];
+	u32 hi;
+	u32 lo;
+	u32 pc;
+	u32 next_pc;
+	size_t ld_next_dst;
+	u32 ld_next_val;
+	size_t ld_pend_dst;
+	u32 ld_pend_val;
+	bool in_branch_delay_slot;
+	bool next_in_branch_delay_slot;
 };
 
+/**
+ * @brief Writes a COP0 register as an MTC0 instruction would.
+ *
+ * Hosts must use this rather than writing `cop0` directly, so that the
+ * debug breakpoints (BPC, BPCM, BDA, BDAM and DCIC) are armed accordingly.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param reg The COP0 register to write.
+ * @param val The value to write.
+ */
+void psycho_cpu_cop0_set(struct psycho_ctx *ctx, uint reg, u32 val);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -32,9 +32,20 @@ extern "C" {
 
 #include "bios-trace.h"
 #include "bus.h"
+#include "coverage.h"
 #include "cpu.h"
 #include "disasm.h"
+#include "hooks.h"
+#include "icache.h"
+#include "idle.h"
+#include "ir.h"
+#include "lockstep.h"
 #include "log.h"
+#include "profiler.h"
+#include "stats.h"
+#include "timers.h"
+#include "watch.h"
+#include "watchdog.h"
 
 enum psycho_event {
 	/** @brief The CPU has executed an illegal instruction. */
@@ -48,7 +59,31 @@ enum psycho_event {
 	 *
 	 * Note that this event will not be raised until a newline is seen.
 	 */
-	PSYCHO_EVENT_TTY_MESSAGE
+	PSYCHO_EVENT_TTY_MESSAGE,
+
+	/**
+	 * @brief The profiler has taken a sample.
+	 *
+	 * The data is a `const struct psycho_profiler_sample *`, valid only for
+	 * the duration of the callback.
+	 */
+	PSYCHO_EVENT_PROFILER_SAMPLE,
+
+	/**
+	 * @brief A watchpoint has been hit.
+	 *
+	 * The data is a `const struct psycho_watch_hit *`, valid only for the
+	 * duration of the callback.
+	 */
+	PSYCHO_EVENT_WATCHPOINT,
+
+	/**
+	 * @brief The watchdog has found the guest to be hung.
+	 *
+	 * The data is a `const struct psycho_watchdog_hang *`, valid only for
+	 * the duration of the callback.
+	 */
+	PSYCHO_EVENT_HANG
 };
 
 typedef void (*psycho_event_cb)(struct psycho_ctx *, enum psycho_event, void *);
@@ -56,17 +91,38 @@ typedef void (*psycho_event_cb)(struct psycho_ctx *, enum psycho_event, void *);
 struct psycho_ctx_cfg {
 	psycho_event_cb event_cb;
 	u8 *ram_data;
-	u8 *bios_data;
+	const u8 *bios_data;
+
+	/** @brief Opaque pointer for use by the host; never touched. */
+	void *udata;
 };
 
 struct psycho_ctx {
 	struct psycho_bus bus;
 	struct psycho_cpu cpu;
+	struct psycho_icache icache;
 	struct psycho_disasm disasm;
 	struct psycho_log log;
 	struct psycho_bios_trace bios_trace;
+	struct psycho_hooks hooks;
+	struct psycho_watch watch;
+	struct psycho_profiler profiler;
+	struct psycho_watchdog watchdog;
+	struct psycho_idle idle;
+	struct psycho_ir ir;
+	struct psycho_coverage coverage;
+	struct psycho_lockstep_tap lockstep;
+
+#ifdef PSYCHO_ENABLE_STATS
+	struct psycho_stats stats;
+#endif // PSYCHO_ENABLE_STATS
+
+#ifdef PSYCHO_ENABLE_TIMERS
+	struct psycho_timers timers;
+#endif // PSYCHO_ENABLE_TIMERS
 
 	psycho_event_cb event_cb;
+	void *udata;
 };
 
 enum psycho_return_code {
@@ -77,11 +133,37 @@ enum psycho_return_code {
 
 enum {
 	EXE_MIN_SIZE = 0x800,
+
+	/**
+	 * @brief The shell entry point, reached once the BIOS has finished
+	 * booting; this is where EXEs are side-loaded.
+	 */
+	EXE_SIDELOAD_PC = 0x80030000
 };
 
 void psycho_init(struct psycho_ctx *ctx, const struct psycho_ctx_cfg *cfg);
 void psycho_reset(struct psycho_ctx *ctx);
-void psycho_step(struct psycho_ctx *ctx);
+
+/**
+ * @brief Executes one instruction.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @return `false` if a hook stopped the step before the instruction executed,
+ * `true` otherwise.
+ */
+bool psycho_step(struct psycho_ctx *ctx);
+
+/**
+ * @brief Executes instructions until @p num_instrs have executed or a hook
+ * stops a step.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param num_instrs The number of instructions to execute.
+ * @return The number of instructions executed, including any skipped idle
+ * loop iterations, any cache flush loop instructions run in bulk and any
+ * executed through the IR.
+ */
+u64 psycho_run(struct psycho_ctx *ctx, u64 num_instrs);
 
 void psycho_tty_stdout_enable(struct psycho_ctx *ctx, bool enable);
 
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file hooks.h Defines the interface to guest PC hooks.
+ *
+ * A hook is a host callback invoked just before the instruction at a given
+ * address executes. Hooks are matched against the physical address of the
+ * PC, so a hook on `0x000000B0` fires equally for `0x800000B0` and
+ * `0xA00000B0`.
+ *
+ * Hooks live in a small open-addressed hash table, fronted by a bitmap with
+ * one bit per (folded) 4 KiB page that holds at least one hook. An
+ * instruction on a page without hooks costs a single bit test.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	/** @brief The maximum number of hooks registered at once. */
+	PSYCHO_HOOKS_MAX = 64,
+
+	/** @brief The number of slots in the hook hash table. */
+	PSYCHO_HOOKS_SLOTS = PSYCHO_HOOKS_MAX * 2,
+
+	/** @brief The granularity of the page bitmap. */
+	PSYCHO_HOOKS_PAGE_SHIFT = 12,
+
+	/** @brief The number of bits in the page bitmap. */
+	PSYCHO_HOOKS_PAGE_BITS = 1024
+};
+
+/**
+ * @brief A hook callback.
+ *
+ * Hooks may add and remove hooks, including themselves; such changes take
+ * effect from the next instruction. A hook may also redirect the PC, in which
+ * case the hooks on the new PC are dispatched in turn, for up to
+ * PSYCHO_HOOKS_MAX redirects per step, or call psycho_hook_stop() to hand
+ * control back to the host before the instruction executes.
+ *
+ * @param ctx The psycho_ctx emulator context the hook fired on.
+ * @param pc The virtual address of the instruction about to execute.
+ * @param udata The pointer passed to psycho_hook_add().
+ */
+typedef void (*psycho_hook_fn)(struct psycho_ctx *ctx, u32 pc, void *udata);
+
+struct psycho_hook {
+	psycho_hook_fn fn;
+	void *udata;
+	u32 paddr;
+	u32 id;
+};
+
+struct psycho_hooks {
+	u64 pages[PSYCHO_HOOKS_PAGE_BITS / 64];
+	struct psycho_hook slots[PSYCHO_HOOKS_SLOTS];
+	uint num;
+	u32 next_id;
+	u32 resume_pc;
+	bool stop;
+	bool resume;
+};
+
+/**
+ * @brief Registers a hook.
+ *
+ * Any number of hooks may share an address; they are called in an
+ * unspecified order. psycho_init() unregisters every hook, so hooks must be
+ * added after it.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param pc The address to hook; only its physical address is considered.
+ * @param fn The function to call.
+ * @param udata Opaque pointer handed to @p fn; never touched.
+ * @return A nonzero handle for psycho_hook_remove(), or 0 if
+ * PSYCHO_HOOKS_MAX hooks are already registered.
+ */
+u32 psycho_hook_add(struct psycho_ctx *ctx, u32 pc, psycho_hook_fn fn,
+		    void *udata);
+
+/**
+ * @brief Unregisters a hook.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param id The handle returned by psycho_hook_add().
+ * @return `true` if the hook was registered, `false` otherwise.
+ */
+bool psycho_hook_remove(struct psycho_ctx *ctx, u32 id);
+
+/**
+ * @brief Called from a hook to stop the current psycho_step() before the
+ * hooked instruction executes.
+ *
+ * The next psycho_step() then executes that instruction without dispatching
+ * its hooks again, so a host may stop on a hook and simply continue.
+ *
+ * @param ctx The psycho_ctx emulator context the hook fired on.
+ */
+void psycho_hook_stop(struct psycho_ctx *ctx);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file icache.h Defines the interface to the instruction cache.
+ *
+ * Only as much of the I-cache is modeled as software can observe: while the
+ * cache is isolated (SR.IsC), stores land in the cache rather than in memory,
+ * writing either the tags or the data depending on the cache control
+ * register. Fetches still go straight to memory.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	// clang-format off
+
+	PSYCHO_ICACHE_LINE_NUM	= 256,
+	PSYCHO_ICACHE_WORD_NUM	= 1024
+
+	// clang-format on
+};
+
+/** @brief The bits of the cache control register at 0xFFFE0130. */
+enum psycho_cache_control {
+	/** @brief Isolated stores write the tags rather than the data. */
+	PSYCHO_CACHE_CONTROL_TAG_TEST = 1 << 2,
+
+	/** @brief The I-cache is enabled. */
+	PSYCHO_CACHE_CONTROL_ICACHE_ENABLE = 1 << 11
+};
+
+struct psycho_icache {
+	/** @brief The tag of each line, i.e. bits 31..12 of its address. */
+	u32 tags[PSYCHO_ICACHE_LINE_NUM];
+
+	/** @brief The valid bits of each line, one per word. */
+	u8 valid[PSYCHO_ICACHE_LINE_NUM];
+
+	u32 data[PSYCHO_ICACHE_WORD_NUM];
+
+	/** @brief Cache flush loops may be run in bulk by psycho_run(). */
+	bool loop_ffwd;
+
+	/**
+	 * @brief The most instructions the current step may run in bulk on
+	 * top of its own; 0 outside of psycho_run().
+	 */
+	u64 loop_budget;
+
+	/** @brief The instructions the current step ran in bulk. */
+	u64 loop_ran;
+
+	/**
+	 * @brief The number of instructions of cache flush loops which were
+	 * executed in bulk rather than stepped through.
+	 */
+	u64 loop_instrs;
+};
+
+/**
+ * @brief Enables or disables running cache flush loops in bulk.
+ *
+ * When enabled, psycho_run() executes the rest of a flush loop in one go as
+ * soon as its first isolated store is reached, counting every instruction of
+ * it against its budget. As with idle loop skipping, this never happens while
+ * anything watches individual instructions, nor from psycho_step().
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param enable Whether or not to run flush loops in bulk.
+ */
+void psycho_icache_loop_ffwd_enable(struct psycho_ctx *ctx, bool enable);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file idle.h Defines the interface to idle loop skipping.
+ *
+ * Guests spend a great deal of time spinning in short polling loops, waiting
+ * for a value in memory to change. When idle loop skipping is enabled, every
+ * short backward branch is checked for such a loop: a body of nothing but
+ * loads, arithmetic and compares, closed by the branch itself. A candidate is
+ * then followed for one iteration, and if that iteration leaves the CPU
+ * exactly as it found it, so will every iteration until a hardware event
+ * changes what the loop reads. psycho_run() skips straight to that event
+ * instead of interpreting the spins.
+ *
+ * No hardware events are scheduled yet, so the earliest one is the end of the
+ * psycho_run() call itself.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "cpu.h"
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	/** @brief The longest loop, in instructions, which can be skipped. */
+	PSYCHO_IDLE_LOOP_LEN_MAX = 16,
+
+	/** @brief The number of loops remembered as not being idle. */
+	PSYCHO_IDLE_REJECT_SLOTS = 64
+};
+
+struct psycho_idle {
+	/** @brief The CPU state at the head of the loop being followed. */
+	struct psycho_cpu_sample sample;
+
+	/** @brief The branch PCs of loops found not to be idle. */
+	u32 rejected[PSYCHO_IDLE_REJECT_SLOTS];
+
+	/** @brief The first instruction of the candidate loop. */
+	u32 loop_start;
+
+	/** @brief The delay slot of the branch closing the candidate loop. */
+	u32 loop_end;
+
+	/** @brief Instructions executed since the sample was taken. */
+	u32 period;
+
+	/** @brief Times the loop has failed to return to the sampled state. */
+	u32 misses;
+
+	/** @brief The total number of instructions skipped. */
+	u64 skipped;
+
+	/** @brief A candidate loop is being followed. */
+	bool armed;
+
+	/** @brief The sample has been taken. */
+	bool sampled;
+
+	bool enable;
+};
+
+/**
+ * @brief Enables or disables idle loop skipping.
+ *
+ * Idle loops are never skipped while the profiler, watchdog, coverage,
+ * instruction tracing, watchpoints or the COP0 breakpoints are in use, nor
+ * when a hook may be placed within the loop, since all of them expect to see
+ * every instruction.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param enable Whether or not to skip idle loops.
+ */
+void psycho_idle_skip_enable(struct psycho_ctx *ctx, bool enable);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,424 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file ir.h Defines the interface to the intermediate representation.
+ *
+ * A guest basic block (a run of instructions up to and including the delay
+ * slot of the branch which closes it) is translated into a short list of
+ * three-address operations on virtual registers, run through a few cheap
+ * optimization passes, and cached. psycho_run() then executes whole blocks
+ * from the cache with a small interpreter instead of stepping through them,
+ * going straight from one block into the next for as long as no load is in
+ * flight between them.
+ *
+ * The load delay and branch delay slots are resolved during translation: a
+ * load lands in a temporary, which is copied to its destination after the
+ * instruction following it, unless that instruction overwrote the
+ * destination first. Anything that can trap is guarded, and a guard which
+ * fails leaves the block with the CPU exactly as psycho_cpu_step() would
+ * have left it before the trapping instruction, which then runs in the
+ * interpreter.
+ *
+ * Blocks are only executed while nothing is observing individual
+ * instructions; see psycho_idle_ffwd_allowed().
+ *
+ * Blocks may also be compiled into host code ahead of time from the very same
+ * operations, and handed to the core as a native module. A native block
+ * replaces the interpretation of its operations whenever the block it was
+ * generated from is translated again from the same instructions.
+ *
+ * As the BIOS never changes, its blocks may be translated once ahead of time
+ * and shared read-only by every context running it, which then copies them
+ * into its cache instead of translating them.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "cpu.h"
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	/** @brief The most guest instructions translated into one block. */
+	PSYCHO_IR_BLOCK_INSTRS_MAX = 32,
+
+	/** @brief The most operations one block may hold. */
+	PSYCHO_IR_BLOCK_OPS_MAX = 128,
+
+	/**
+	 * @brief The number of virtual registers; the guest GPRs come first,
+	 * followed by HI, LO and temporaries.
+	 */
+	PSYCHO_IR_VREG_NUM = 64
+};
+
+/** @brief The virtual registers following the guest GPRs. */
+enum psycho_ir_vreg {
+	PSYCHO_IR_VREG_HI = CPU_GPR_NUM,
+	PSYCHO_IR_VREG_LO,
+	PSYCHO_IR_VREG_TMP_FIRST
+};
+
+/**
+ * @brief The operations; a and b name virtual registers, and imm is an
+ * immediate. Guards leave the block through the exit numbered dst when their
+ * check fails.
+ */
+enum psycho_ir_opcode {
+	PSYCHO_IR_OP_NOP,
+	PSYCHO_IR_OP_CONST,		// dst = imm
+	PSYCHO_IR_OP_MOV,		// dst = a
+	PSYCHO_IR_OP_ADD,		// dst = a + b
+	PSYCHO_IR_OP_ADDI,		// dst = a + imm
+	PSYCHO_IR_OP_SUB,		// dst = a - b
+	PSYCHO_IR_OP_AND,
+	PSYCHO_IR_OP_ANDI,
+	PSYCHO_IR_OP_OR,
+	PSYCHO_IR_OP_ORI,
+	PSYCHO_IR_OP_XOR,
+	PSYCHO_IR_OP_XORI,
+	PSYCHO_IR_OP_NOR,
+	PSYCHO_IR_OP_SLT,		// dst = (s32)a < (s32)b
+	PSYCHO_IR_OP_SLTI,
+	PSYCHO_IR_OP_SLTU,		// dst = a < b
+	PSYCHO_IR_OP_SLTIU,
+	PSYCHO_IR_OP_SLL,		// dst = a << imm
+	PSYCHO_IR_OP_SRL,
+	PSYCHO_IR_OP_SRA,
+	PSYCHO_IR_OP_SLLV,		// dst = a << (b & 31)
+	PSYCHO_IR_OP_SRLV,
+	PSYCHO_IR_OP_SRAV,
+	PSYCHO_IR_OP_SEQ,		// dst = a == b
+	PSYCHO_IR_OP_SNE,		// dst = a != b
+	PSYCHO_IR_OP_SLEZ,		// dst = (s32)a <= 0
+	PSYCHO_IR_OP_SGTZ,		// dst = (s32)a > 0
+	PSYCHO_IR_OP_SLTZ,		// dst = (s32)a < 0
+	PSYCHO_IR_OP_SGEZ,		// dst = (s32)a >= 0
+	PSYCHO_IR_OP_MULT,		// HI:LO = a * b
+	PSYCHO_IR_OP_MULTU,
+	PSYCHO_IR_OP_DIV,		// LO = a / b, HI = a % b
+	PSYCHO_IR_OP_DIVU,
+	PSYCHO_IR_OP_LB,		// dst = load(a + imm)
+	PSYCHO_IR_OP_LBU,
+	PSYCHO_IR_OP_LH,
+	PSYCHO_IR_OP_LHU,
+	PSYCHO_IR_OP_LW,
+	PSYCHO_IR_OP_SB,		// store(a + imm, b)
+	PSYCHO_IR_OP_SH,
+	PSYCHO_IR_OP_SW,
+	PSYCHO_IR_OP_LWL,		// dst = load(a + imm) merged into b
+	PSYCHO_IR_OP_LWR,
+	PSYCHO_IR_OP_SWL,		// merge b into store(a + imm)
+	PSYCHO_IR_OP_SWR,
+	PSYCHO_IR_OP_GUARD_ADD,		// exit if a + b overflows
+	PSYCHO_IR_OP_GUARD_ADDI,	// exit if a + imm overflows
+	PSYCHO_IR_OP_GUARD_SUB,		// exit if a - b overflows
+	PSYCHO_IR_OP_GUARD_ALIGN2,	// exit unless a + imm is 2 aligned
+	PSYCHO_IR_OP_GUARD_ALIGN4,	// exit unless a + imm is 4 aligned
+	PSYCHO_IR_OP_GUARD_CODE		// exit if a + imm is in the block
+};
+
+/** @brief How a block leaves the PC and the branch delay state. */
+enum psycho_ir_exit_kind {
+	/** Not in a branch delay slot; execution carries on at the exit PC. */
+	PSYCHO_IR_EXIT_SEQ,
+
+	/** The exit PC is a delay slot, after which comes the target. */
+	PSYCHO_IR_EXIT_SLOT,
+
+	/** The delay slot has executed; execution carries on at the target. */
+	PSYCHO_IR_EXIT_BRANCH
+};
+
+/** @brief How the branch target of a block is computed. */
+enum psycho_ir_target_kind {
+	PSYCHO_IR_TARGET_NONE,
+
+	/** target */
+	PSYCHO_IR_TARGET_CONST,
+
+	/** target if target_vreg is set, otherwise target_alt */
+	PSYCHO_IR_TARGET_COND,
+
+	/** target_vreg */
+	PSYCHO_IR_TARGET_VREG
+};
+
+/** @brief One operation: `dst = code(a, b, imm)`. */
+struct psycho_ir_op {
+	u8 code;
+	u8 dst;
+	u8 a;
+	u8 b;
+	u32 imm;
+};
+
+/** @brief The CPU state to leave behind when a block is left at one point. */
+struct psycho_ir_exit {
+	/** @brief The address following the last instruction executed. */
+	u32 pc;
+
+	/** @brief The guest instructions executed before leaving. */
+	u8 instrs;
+
+	/** @brief How the PC and the branch delay state are left behind. */
+	u8 kind;
+
+	/** @brief The pending loads, and the virtual registers holding them. */
+	u8 ld_next_dst;
+	u8 ld_next_vreg;
+	u8 ld_pend_dst;
+	u8 ld_pend_vreg;
+};
+
+/** @brief The bus accesses of native blocks, made with virtual addresses. */
+struct psycho_ir_native_bus {
+	u32 (*load_word)(struct psycho_ctx *ctx, u32 vaddr);
+	u16 (*load_halfword)(struct psycho_ctx *ctx, u32 vaddr);
+	u8 (*load_byte)(struct psycho_ctx *ctx, u32 vaddr);
+
+	void (*store_word)(struct psycho_ctx *ctx, u32 vaddr, u32 word);
+	void (*store_halfword)(struct psycho_ctx *ctx, u32 vaddr, u16 halfword);
+	void (*store_byte)(struct psycho_ctx *ctx, u32 vaddr, u8 byte);
+
+	/** @brief Translates the virtual address of a load or store. */
+	u32 (*paddr)(u32 vaddr);
+};
+
+/**
+ * @brief Executes the operations of a block on the virtual registers @p v.
+ *
+ * @returns The index of the exit the block left through.
+ */
+typedef uint (*psycho_ir_native_fn)(struct psycho_ctx *ctx,
+				    const struct psycho_ir_native_bus *bus,
+				    u32 *v);
+
+/** @brief A block compiled into host code ahead of time. */
+struct psycho_ir_native {
+	/** @brief The virtual address of the first instruction. */
+	u32 pc;
+
+	/** @brief The instructions the block was translated from. */
+	const u32 *words;
+
+	u8 instrs_num;
+
+	/** @brief The number of operations the code was generated from. */
+	u16 ops_num;
+
+	psycho_ir_native_fn fn;
+};
+
+enum {
+	/**
+	 * @brief The revision of the native module interface, and of the
+	 * translation; bump it whenever either changes.
+	 */
+	PSYCHO_IR_NATIVE_ABI_VERSION = 2
+};
+
+/** @brief The symbol a shared object exports its native module under. */
+#define PSYCHO_IR_NATIVE_MODULE_SYMBOL "psycho_ir_native_module"
+
+/** @brief The native blocks generated for one program. */
+struct psycho_ir_native_module {
+	/** @brief The @ref PSYCHO_IR_NATIVE_ABI_VERSION generated against. */
+	u32 abi_version;
+
+	/** @brief The native blocks, sorted by PC. */
+	const struct psycho_ir_native *natives;
+	size_t natives_num;
+};
+
+struct psycho_ir_block {
+	/** @brief The virtual address of the first instruction. */
+	u32 pc;
+
+	/** @brief The physical address of the first instruction. */
+	u32 paddr;
+
+	/**
+	 * @brief The instructions translated, compared against RAM before every
+	 * execution in case the guest has overwritten them.
+	 */
+	u32 words[PSYCHO_IR_BLOCK_INSTRS_MAX];
+
+	/** @brief The branch target if taken, and the address if not. */
+	u32 target;
+	u32 target_alt;
+
+	struct psycho_ir_op ops[PSYCHO_IR_BLOCK_OPS_MAX];
+
+	/** @brief One exit before every instruction, and one after the last. */
+	struct psycho_ir_exit exits[PSYCHO_IR_BLOCK_INSTRS_MAX + 1];
+
+	u16 ops_num;
+
+	/**
+	 * @brief The number of instructions translated; `0` if the first one
+	 * cannot be, in which case the block only remembers as much.
+	 */
+	u8 instrs_num;
+
+	/** @brief How the branch target is computed, if there is a branch. */
+	u8 target_kind;
+	u8 target_vreg;
+
+	/** @brief The native code to run instead of the operations, if any. */
+	psycho_ir_native_fn native;
+
+	/** @brief Whether the block was translated from RAM. */
+	bool ram;
+
+	bool valid;
+};
+
+/** @brief BIOS blocks translated by psycho_ir_bios_translate(). */
+struct psycho_ir_bios_blocks {
+	/** @brief The blocks, sorted by PC. */
+	const struct psycho_ir_block *blocks;
+	size_t blocks_num;
+};
+
+struct psycho_ir_cfg {
+	/** @brief The block cache, indexed by PC. */
+	struct psycho_ir_block *blocks;
+
+	/** @brief The number of entries in @ref blocks; a power of two. */
+	size_t blocks_num;
+
+	/** @brief The native blocks to use where possible, or `NULL`. */
+	const struct psycho_ir_native_module *native;
+
+	/**
+	 * @brief The blocks of the BIOS to copy rather than translate, or
+	 * `NULL`; they must have been translated from the very same BIOS.
+	 */
+	const struct psycho_ir_bios_blocks *bios;
+};
+
+struct psycho_ir {
+	struct psycho_ir_cfg cfg;
+	u32 blocks_mask;
+
+	/** @brief The number of blocks translated. */
+	u64 translated;
+
+	/** @brief The number of blocks executed. */
+	u64 blocks_run;
+
+	/** @brief The number of instructions executed in blocks. */
+	u64 instrs_run;
+
+	/** @brief The number of blocks left early by a failed guard. */
+	u64 side_exits;
+
+	/** @brief The number of blocks executed as native code. */
+	u64 native_run;
+
+	/** @brief The number of blocks copied from @ref psycho_ir_cfg.bios. */
+	u64 bios_copied;
+
+	bool enable;
+};
+
+/**
+ * @brief Starts or stops executing guest code through the IR.
+ *
+ * BIOS blocks are never checked against the BIOS again, so the BIOS must not
+ * change while the IR is enabled.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param cfg The block cache to use, or `NULL` to stop. The cache is cleared.
+ */
+void psycho_ir_enable(struct psycho_ctx *ctx, const struct psycho_ir_cfg *cfg);
+
+/**
+ * @brief Translates the block starting at @p pc as it would be before being
+ * executed, without executing it.
+ *
+ * This is what native modules are generated from.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param block The block to translate into.
+ * @param pc The virtual address of the first instruction.
+ */
+void psycho_ir_translate(struct psycho_ctx *ctx, struct psycho_ir_block *block,
+			 u32 pc);
+
+/**
+ * @brief Translates the blocks of the BIOS reachable from the reset vector
+ * ahead of time.
+ *
+ * Blocks are found by following branches and calls, so code only reached
+ * through a jump to a register may be left out; it is then translated as
+ * usual. The blocks hold no pointers, and may be copied anywhere.
+ *
+ * @param ctx A psycho_ctx emulator context with the BIOS to translate.
+ * @param blocks Where to translate the blocks into.
+ * @param blocks_max The number of entries in @p blocks.
+ * @returns The number of blocks translated, sorted by PC.
+ */
+size_t psycho_ir_bios_translate(struct psycho_ctx *ctx,
+				struct psycho_ir_block *blocks,
+				size_t blocks_max);
+
+/**
+ * @brief Executes the block starting at the PC, translating it first if
+ * need be.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param budget The most instructions the block may execute.
+ * @return The number of instructions executed; `0` if the next instruction
+ * has to be stepped through by the interpreter instead.
+ */
+u64 psycho_ir_step(struct psycho_ctx *ctx, u64 budget);
+
+/**
+ * @brief Translates at most @p budget instructions from the PC into a block
+ * of their own and executes it, bypassing the block cache.
+ *
+ * A branch is never split from its delay slot, so the block may hold fewer
+ * instructions than asked for.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param block Where to translate the block into.
+ * @param budget The most instructions to translate.
+ * @return The number of instructions executed; `0` if the next instruction
+ * has to be stepped through by the interpreter instead.
+ */
+u64 psycho_ir_step_uncached(struct psycho_ctx *ctx,
+			    struct psycho_ir_block *block, u64 budget);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
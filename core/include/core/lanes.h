@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file lanes.h Defines the interface to lane-parallel execution.
+ *
+ * Fuzzing and parameter sweeps run many contexts through the same code with
+ * different data. Up to @ref PSYCHO_LANES_MAX such contexts, the lanes, can be
+ * run in lockstep: the lanes which are at the same point of the same code are
+ * packed together, their registers held as structure-of-arrays, and each
+ * instruction is fetched and decoded once and executed for all of them with
+ * vector operations.
+ *
+ * A lane leaves the pack before any instruction it cannot execute the way
+ * the others do: an access outside of RAM and the scratchpad, a trap, or an
+ * instruction only the interpreter knows. A lane which branches the other way
+ * than most of the pack leaves it after the delay slot instead. Either way, the
+ * lane is then stepped by the interpreter on its own, and rejoins the pack once
+ * it is back at the same point. Whichever of the pack and the lanes outside
+ * of it are at the lowest PC go first, so that lanes which branched ahead wait
+ * for the rest to catch up rather than staying a step ahead of the pack. Lanes
+ * are only packed while nothing is observing individual instructions; see
+ * psycho_idle_ffwd_allowed().
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "cpu-defs.h"
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	/** @brief The most contexts run together. */
+	PSYCHO_LANES_MAX = 16
+};
+
+struct psycho_lanes {
+	/** @brief The contexts, one per lane. */
+	struct psycho_ctx *ctx[PSYCHO_LANES_MAX];
+	uint lanes_num;
+
+	/** @brief The lanes in the pack, one bit per lane. */
+	u32 packed;
+
+	/**
+	 * @brief The lanes whose last instruction was executed in the pack,
+	 * and so whose current PC and instruction are those of the pack.
+	 */
+	u32 fresh;
+
+	/**
+	 * @brief The lanes which sit out the rest of the run, having been
+	 * stopped by a hook or executed all of their instructions.
+	 */
+	u32 stopped;
+
+	/** @brief The lane to try starting the next pack from. */
+	uint next_leader;
+
+	/**
+	 * @brief The registers of the packed lanes; the lanes' own copies are
+	 * stale for as long as they are packed.
+	 */
+	u32 gpr[CPU_GPR_NUM][PSYCHO_LANES_MAX] __attribute__((aligned(64)));
+	u32 hi[PSYCHO_LANES_MAX] __attribute__((aligned(64)));
+	u32 lo[PSYCHO_LANES_MAX] __attribute__((aligned(64)));
+	u32 ld_next_val[PSYCHO_LANES_MAX] __attribute__((aligned(64)));
+	u32 ld_pend_val[PSYCHO_LANES_MAX] __attribute__((aligned(64)));
+
+	/**
+	 * @brief The instructions each lane has left to execute in the run; for
+	 * packed lanes, the value of @ref clock at which they will have none.
+	 */
+	u64 left[PSYCHO_LANES_MAX];
+
+	/** @brief The instructions executed by the pack in the run. */
+	u64 clock;
+
+	/** @brief No packed lane runs out of instructions before this. */
+	u64 deadline;
+
+	/** @brief The state every packed lane shares. */
+	u32 curr_pc;
+	u32 pc;
+	u32 next_pc;
+	u32 instr;
+	uint ld_next_dst;
+	uint ld_pend_dst;
+	bool in_branch_delay_slot;
+	bool next_in_branch_delay_slot;
+
+	/**
+	 * @brief The packed lanes which took the last branch the other way
+	 * than the pack, and so leave it after the delay slot for
+	 * @ref diverged_pc.
+	 */
+	u32 diverged;
+	u32 diverged_pc;
+
+	/** @brief The instructions executed in the pack, summed over lanes. */
+	u64 packed_instrs;
+
+	/** @brief The instructions stepped one lane at a time. */
+	u64 scalar_instrs;
+
+	/** @brief The number of times a lane left the pack. */
+	u64 splits;
+
+	/**
+	 * @brief The number of times a lane joined the pack, including at the
+	 * start of every run.
+	 */
+	u64 merges;
+};
+
+/**
+ * @brief Sets up lanes over a number of contexts.
+ *
+ * The contexts are set up by the host as usual beforehand. Each must have
+ * memory of its own; the BIOS may be shared.
+ *
+ * @param lanes The lanes to set up.
+ * @param ctx The contexts, one per lane.
+ * @param lanes_num The number of contexts; at most @ref PSYCHO_LANES_MAX.
+ */
+void psycho_lanes_init(struct psycho_lanes *lanes,
+		       struct psycho_ctx *const *ctx, uint lanes_num);
+
+/**
+ * @brief Executes a number of instructions on every lane, in lockstep.
+ *
+ * Every context is up to date when this returns, and may be inspected or
+ * changed freely before the next run.
+ *
+ * @param lanes The lanes to run.
+ * @param num_instrs The number of instructions each lane is to execute.
+ * @return The number of instructions executed, summed over lanes; less than
+ * @p num_instrs times the number of lanes if a hook stopped any of them.
+ */
+u64 psycho_lanes_run(struct psycho_lanes *lanes, u64 num_instrs);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file lockstep.h Defines the interface to differential lockstep execution.
+ *
+ * A candidate context is run side by side with a reference context, which
+ * steps through every instruction with the interpreter, and the two are
+ * compared as they go: the GPRs, HI and LO, COP0, the PC and the delay slot
+ * state, and a rolling hash of every write either has made to the bus. The
+ * candidate executes through the IR, native blocks included, whenever it has
+ * the IR enabled, and is stepped otherwise; a reference and a candidate using
+ * different variants of the step may equally be compared.
+ *
+ * The first instruction after which the two differ is reported, with its
+ * disassembly. When only whole blocks are compared, both contexts are rewound
+ * to the start of a block which left them differing, and it is run again one
+ * instruction longer at a time until the instruction is found.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "cpu.h"
+#include "disasm.h"
+#include "ir.h"
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	/** @brief The most instructions executed between two comparisons. */
+	PSYCHO_LOCKSTEP_UNIT_INSTRS_MAX = PSYCHO_IR_BLOCK_INSTRS_MAX
+};
+
+enum psycho_lockstep_granularity {
+	/**
+	 * @brief Compare after every instruction. A candidate with the IR
+	 * enabled translates every instruction into a block of its own, and
+	 * steps through branches, which cannot be split from their delay
+	 * slots.
+	 */
+	PSYCHO_LOCKSTEP_INSTR,
+
+	/**
+	 * @brief Compare after every block the candidate executes through the
+	 * IR, and after every run of instructions it steps through up to the
+	 * end of a branch delay slot.
+	 */
+	PSYCHO_LOCKSTEP_BLOCK
+};
+
+/** @brief A bus write, as needed to undo it. */
+struct psycho_lockstep_write {
+	u32 paddr;
+
+	/** @brief The value in memory before the write. */
+	u32 old_val;
+
+	u8 width;
+};
+
+/** @brief What a context in lockstep records of its own bus writes. */
+struct psycho_lockstep_tap {
+	/** @brief A rolling hash of every bus write, in order. */
+	u64 write_hash;
+
+	/** @brief The writes made since the last comparison. */
+	struct psycho_lockstep_write writes[PSYCHO_LOCKSTEP_UNIT_INSTRS_MAX];
+	uint writes_num;
+};
+
+/** @brief Where a candidate first diverged from the reference. */
+struct psycho_lockstep_divergence {
+	/**
+	 * @brief The number of instructions executed in lockstep, up to and
+	 * including the first differing one.
+	 */
+	u64 instrs;
+
+	/** @brief The address of the first differing instruction. */
+	u32 pc;
+
+	/** @brief The first differing instruction. */
+	u32 instr;
+
+	/** @brief The disassembly of @ref instr. */
+	char disasm[PSYCHO_DISASM_LEN_MAX];
+
+	/** @brief The CPU state of either context after @ref instr. */
+	struct psycho_cpu_sample ref;
+	struct psycho_cpu_sample cand;
+
+	/** @brief The write hash of either context after @ref instr. */
+	u64 ref_write_hash;
+	u64 cand_write_hash;
+};
+
+struct psycho_lockstep {
+	struct psycho_ctx *ref;
+	struct psycho_ctx *cand;
+
+	/** @brief A @ref psycho_lockstep_granularity value. */
+	u8 granularity;
+
+	/** @brief The number of instructions executed in lockstep. */
+	u64 instrs;
+
+	/** @brief The number of times the two have been compared. */
+	u64 compares;
+
+	/** @brief Set once the two have diverged. */
+	bool diverged;
+	struct psycho_lockstep_divergence divergence;
+
+	/** @brief The CPU state of either context before the last unit. */
+	struct psycho_cpu ref_cpu;
+	struct psycho_cpu cand_cpu;
+	u64 ref_write_hash;
+	u64 cand_write_hash;
+
+	/** @brief The blocks the candidate translates outside of its cache. */
+	struct psycho_ir_block block;
+};
+
+/**
+ * @brief Puts two contexts in lockstep.
+ *
+ * Both must be in the very same state, must have been initialized by
+ * psycho_init() beforehand, and must not be run other than by
+ * psycho_lockstep_run() until psycho_lockstep_end(). Hooks on the reference
+ * must not stop it.
+ *
+ * @param ls The lockstep state to initialize.
+ * @param ref The reference context; its IR is never used.
+ * @param cand The candidate context.
+ * @param granularity How often to compare the two.
+ */
+void psycho_lockstep_init(struct psycho_lockstep *ls, struct psycho_ctx *ref,
+			  struct psycho_ctx *cand,
+			  enum psycho_lockstep_granularity granularity);
+
+/**
+ * @brief Executes instructions on both contexts until @p num_instrs have
+ * executed, the two diverge, or a hook stops the candidate.
+ *
+ * Once the two have diverged, they are left as they were just after the first
+ * differing instruction, and @ref psycho_lockstep.divergence describes it.
+ *
+ * @param ls The target lockstep state.
+ * @param num_instrs The number of instructions to execute.
+ * @return The number of instructions executed.
+ */
+u64 psycho_lockstep_run(struct psycho_lockstep *ls, u64 num_instrs);
+
+/**
+ * @brief Takes both contexts out of lockstep, after which they may be run as
+ * usual.
+ *
+ * @param ls The target lockstep state.
+ */
+void psycho_lockstep_end(struct psycho_lockstep *ls);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
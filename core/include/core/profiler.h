@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file profiler.h Defines the interface to the guest sampling profiler.
+ *
+ * The profiler maintains a shadow call stack by observing calls (JAL, JALR
+ * and BLTZAL/BGEZAL) and returns (`jr $ra`), and every N instructions it
+ * raises @ref PSYCHO_EVENT_PROFILER_SAMPLE with the current PC and call
+ * stack. Aggregating and exporting the samples is left to the host.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	PSYCHO_PROFILER_STACK_DEPTH_MAX = 64,
+};
+
+struct psycho_profiler_frame {
+	/** @brief The address of the function which was called. */
+	u32 func;
+
+	/** @brief The address the function is expected to return to. */
+	u32 ret_addr;
+};
+
+struct psycho_profiler_sample {
+	/** @brief The PC of the instruction about to be executed. */
+	u32 pc;
+
+	/** @brief The call stack, outermost frame first. */
+	const struct psycho_profiler_frame *stack;
+
+	/** @brief The number of frames in @ref stack. */
+	uint depth;
+};
+
+struct psycho_profiler {
+	struct psycho_profiler_frame stack[PSYCHO_PROFILER_STACK_DEPTH_MAX];
+
+	/**
+	 * @brief The depth of the call stack; this may exceed
+	 * PSYCHO_PROFILER_STACK_DEPTH_MAX, in which case the innermost frames
+	 * are not recorded.
+	 */
+	uint depth;
+
+	u64 interval;
+	u64 countdown;
+	bool enable;
+};
+
+/**
+ * @brief Enables or disables the guest sampling profiler.
+ *
+ * Enabling the profiler clears the shadow call stack, so it should ideally be
+ * enabled before the code of interest starts running.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param enable Whether or not to enable the profiler.
+ * @param interval The number of instructions between samples.
+ */
+void psycho_profiler_enable(struct psycho_ctx *ctx, bool enable, u64 interval);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
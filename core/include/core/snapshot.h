@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file snapshot.h Defines the interface to emulator snapshots.
+ *
+ * A snapshot captures the entire state of an emulator context, including its
+ * RAM. Restoring a snapshot only copies back the pages of RAM which have been
+ * written since the snapshot was taken or last restored, which makes
+ * restoring it many times over (e.g., once per fuzzing iteration) cheap.
+ *
+ * Writes made to RAM directly by the host are not tracked; use
+ * psycho_snapshot_ram_write() for those.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+
+#include "ctx.h"
+
+struct psycho_snapshot {
+	struct psycho_ctx ctx;
+
+	/** @brief RAM_SIZE bytes of storage for RAM, owned by the host. */
+	u8 *ram;
+};
+
+/**
+ * @brief Takes a snapshot of an emulator context.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param snap The snapshot to take; its @ref psycho_snapshot.ram member must
+ * already point to RAM_SIZE bytes of storage.
+ */
+void psycho_snapshot_save(struct psycho_ctx *ctx, struct psycho_snapshot *snap);
+
+/**
+ * @brief Restores an emulator context to the state of a snapshot.
+ *
+ * The snapshot must have been taken from this context, and no other snapshot
+ * may have been taken or restored since.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param snap The snapshot to restore.
+ * @returns The number of pages of RAM which had to be copied.
+ */
+uint psycho_snapshot_restore(struct psycho_ctx *ctx,
+			     const struct psycho_snapshot *snap);
+
+/**
+ * @brief Writes to RAM on behalf of the host, such that restoring a snapshot
+ * undoes the write.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param paddr The physical address to write to.
+ * @param data The data to write.
+ * @param size The number of bytes to write; the write is truncated at the end
+ * of RAM.
+ */
+void psycho_snapshot_ram_write(struct psycho_ctx *ctx, u32 paddr,
+			       const void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
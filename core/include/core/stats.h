@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file stats.h Defines the interface to the execution statistics.
+ *
+ * When psycho is configured with PSYCHO_ENABLE_STATS, the core counts every
+ * instruction executed by opcode, every bus access by region and a handful of
+ * pipeline events. Otherwise, the counting is compiled out entirely and
+ * psycho_stats_get() reports that no statistics are available.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "compiler.h"
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	/** @brief The number of primary opcodes and of SPECIAL functions. */
+	PSYCHO_STATS_OP_NUM = 64,
+
+	/** @brief The number of exception codes representable in CAUSE. */
+	PSYCHO_STATS_EXC_NUM = 32
+};
+
+enum psycho_stats_region {
+	PSYCHO_STATS_REGION_RAM,
+	PSYCHO_STATS_REGION_SCRATCHPAD,
+	PSYCHO_STATS_REGION_BIOS,
+	PSYCHO_STATS_REGION_MMIO,
+	PSYCHO_STATS_REGION_UNMAPPED,
+	PSYCHO_STATS_REGION_NUM
+};
+
+struct psycho_stats {
+	/**
+	 * @brief Instructions executed, indexed by primary opcode (the
+	 * `instr_group_op` values).
+	 */
+	u64 op[PSYCHO_STATS_OP_NUM];
+
+	/**
+	 * @brief SPECIAL instructions executed, indexed by function (the
+	 * `instr_group_special` values).
+	 */
+	u64 special[PSYCHO_STATS_OP_NUM];
+
+	/** @brief Instruction fetches, indexed by region. */
+	u64 fetches[PSYCHO_STATS_REGION_NUM];
+
+	/** @brief Data loads, indexed by region. */
+	u64 loads[PSYCHO_STATS_REGION_NUM];
+
+	/** @brief Data stores, indexed by region. */
+	u64 stores[PSYCHO_STATS_REGION_NUM];
+
+	/** @brief Exceptions raised, indexed by exception code. */
+	u64 exceptions[PSYCHO_STATS_EXC_NUM];
+
+	/**
+	 * @brief Pending loads discarded because the next instruction wrote
+	 * to the same register.
+	 */
+	u64 load_delay_cancels;
+
+	/** @brief Branches and jumps executed in a branch delay slot. */
+	u64 branch_in_delay_slot;
+};
+
+/**
+ * @brief Copies the execution statistics gathered so far.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param stats Where to copy the statistics to.
+ * @returns Whether statistics were compiled in; if not, @p stats is zeroed.
+ */
+bool psycho_stats_get(const struct psycho_ctx *ctx, struct psycho_stats *stats);
+
+/**
+ * @brief Resets the execution statistics to zero.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ */
+void psycho_stats_reset(struct psycho_ctx *ctx);
+
+/**
+ * @brief Retrieves the mnemonic of a primary opcode.
+ *
+ * @param op The primary opcode.
+ * @returns The mnemonic, or `NULL` if the opcode is not implemented.
+ */
+CONST_FN const char *psycho_stats_op_name(uint op);
+
+/**
+ * @brief Retrieves the mnemonic of a SPECIAL function.
+ *
+ * @param funct The function.
+ * @returns The mnemonic, or `NULL` if the function is not implemented.
+ */
+CONST_FN const char *psycho_stats_special_name(uint funct);
+
+/**
+ * @brief Retrieves the name of a bus region.
+ *
+ * @param region The region.
+ * @returns The name of the region.
+ */
+CONST_FN const char *psycho_stats_region_name(enum psycho_stats_region region);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file timers.h Defines the interface to the host timing instrumentation.
+ *
+ * When psycho is configured with PSYCHO_ENABLE_TIMERS, scoped timers measure
+ * how much host time is spent in each subsystem of the step path. Time spent
+ * in a nested subsystem (e.g., a bus access made by the CPU) is attributed to
+ * that subsystem's self time, and not to its parent's. Optionally, every
+ * timed scope can be recorded into a host-provided buffer to build a
+ * timeline. Otherwise, the timers are compiled out entirely.
+ *
+ * Times are measured in ticks of psycho_timers_now(); this is the TSC where
+ * available, and nanoseconds otherwise.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "compiler.h"
+#include "types.h"
+
+struct psycho_ctx;
+
+enum psycho_timer_zone {
+	PSYCHO_TIMER_ZONE_STEP,
+	PSYCHO_TIMER_ZONE_CPU,
+	PSYCHO_TIMER_ZONE_BUS,
+	PSYCHO_TIMER_ZONE_LOG,
+	PSYCHO_TIMER_ZONE_DISASM,
+	PSYCHO_TIMER_ZONE_HOOKS,
+	PSYCHO_TIMER_ZONE_CALLBACK,
+	PSYCHO_TIMER_ZONE_NUM
+};
+
+enum {
+	/** @brief The deepest nesting of scopes which is timed. */
+	PSYCHO_TIMER_DEPTH_MAX = 8
+};
+
+struct psycho_timer_totals {
+	/** @brief The number of times the zone was entered. */
+	u64 count;
+
+	/** @brief Ticks spent in the zone, including nested zones. */
+	u64 ticks;
+
+	/** @brief Ticks spent in the zone, excluding nested zones. */
+	u64 self_ticks;
+};
+
+struct psycho_timer_event {
+	u64 begin;
+	u64 end;
+	u8 zone;
+	u8 depth;
+};
+
+struct psycho_timers {
+	struct psycho_timer_totals zones[PSYCHO_TIMER_ZONE_NUM];
+
+	struct {
+		u64 begin;
+		u64 child_ticks;
+		enum psycho_timer_zone zone;
+	} stack[PSYCHO_TIMER_DEPTH_MAX];
+
+	uint depth;
+
+	struct psycho_timer_event *events;
+	size_t events_num;
+	size_t events_capacity;
+	u64 events_dropped;
+};
+
+/**
+ * @brief Reads the tick source used by the timers.
+ *
+ * @returns The current tick count.
+ */
+u64 psycho_timers_now(void);
+
+/**
+ * @brief Copies the per-zone totals gathered so far.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param totals Where to copy the totals to; an array of
+ * PSYCHO_TIMER_ZONE_NUM elements indexed by zone.
+ * @returns Whether the timers were compiled in; if not, @p totals is zeroed.
+ */
+bool psycho_timers_get(const struct psycho_ctx *ctx,
+		       struct psycho_timer_totals *totals);
+
+/**
+ * @brief Resets the per-zone totals to zero.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ */
+void psycho_timers_reset(struct psycho_ctx *ctx);
+
+/**
+ * @brief Starts or stops recording every timed scope.
+ *
+ * Scopes are recorded in the order they end. Once @p capacity events have
+ * been recorded, further events are counted as dropped.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param events The buffer to record into, or `NULL` to stop recording.
+ * @param capacity The number of events @p events can hold.
+ */
+void psycho_timers_record(struct psycho_ctx *ctx,
+			  struct psycho_timer_event *events, size_t capacity);
+
+/**
+ * @brief Retrieves the number of scopes recorded since recording started.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param dropped If not `NULL`, receives the number of scopes which did not
+ * fit in the buffer.
+ * @returns The number of events in the buffer.
+ */
+size_t psycho_timers_recorded(const struct psycho_ctx *ctx, u64 *dropped);
+
+/**
+ * @brief Retrieves the name of a timer zone.
+ *
+ * @param zone The zone.
+ * @returns The name of the zone.
+ */
+CONST_FN const char *psycho_timer_zone_name(enum psycho_timer_zone zone);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file watch.h Defines the interface to guest memory watchpoints.
+ *
+ * Watched ranges are flagged page by page in the bus, so that only loads and
+ * stores to those pages look for a matching watchpoint; every hit is
+ * reported through PSYCHO_EVENT_WATCHPOINT.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	/** @brief The maximum number of watchpoints set at once. */
+	PSYCHO_WATCHPOINTS_MAX = 16
+};
+
+enum psycho_watch_access {
+	PSYCHO_WATCH_READ = 1 << 0,
+	PSYCHO_WATCH_WRITE = 1 << 1
+};
+
+struct psycho_watchpoint {
+	/** @brief The first physical address watched. */
+	u32 start;
+
+	/** @brief One past the last physical address watched. */
+	u32 end;
+
+	/** @brief A combination of @ref psycho_watch_access values. */
+	u8 access;
+};
+
+/**
+ * @brief Describes a watchpoint hit; the data of PSYCHO_EVENT_WATCHPOINT.
+ *
+ * The event is raised before a store takes effect.
+ */
+struct psycho_watch_hit {
+	/** @brief The handle of the watchpoint which was hit. */
+	u32 id;
+
+	/** @brief The address of the instruction making the access. */
+	u32 pc;
+
+	/** @brief The physical address accessed. */
+	u32 addr;
+
+	/** @brief The value in memory before the access. */
+	u32 old_val;
+
+	/** @brief The value loaded or stored. */
+	u32 new_val;
+
+	/** @brief The width of the access in bytes. */
+	u8 width;
+
+	/** @brief Either PSYCHO_WATCH_READ or PSYCHO_WATCH_WRITE. */
+	u8 access;
+};
+
+struct psycho_watch {
+	struct psycho_watchpoint points[PSYCHO_WATCHPOINTS_MAX];
+	u32 used;
+};
+
+/**
+ * @brief Watches a range of guest memory.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param addr The first address to watch; only its physical address is
+ * considered.
+ * @param size The number of bytes to watch.
+ * @param access The accesses to report, as a combination of
+ * @ref psycho_watch_access values.
+ * @return A nonzero handle for psycho_watch_remove(), or 0 if the range is
+ * empty or PSYCHO_WATCHPOINTS_MAX watchpoints are already set.
+ */
+u32 psycho_watch_add(struct psycho_ctx *ctx, u32 addr, u32 size, u8 access);
+
+/**
+ * @brief Removes a watchpoint.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param id The handle returned by psycho_watch_add().
+ * @return `true` if the watchpoint was set, `false` otherwise.
+ */
+bool psycho_watch_remove(struct psycho_ctx *ctx, u32 id);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file watchdog.h Defines the interface to the guest hang watchdog.
+ *
+ * Every N instructions the watchdog takes a sample of the CPU state and then
+ * follows the guest for a short while. Should the guest come back around to
+ * the same PC with exactly the same state and without having stored anything,
+ * nothing can ever change its course again and it is considered hung. The
+ * watchdog also considers a guest hung once it has gone too long without
+ * printing anything to the TTY. Either way, @ref PSYCHO_EVENT_HANG is raised
+ * and deciding what to do about it is left to the host.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "cpu.h"
+#include "types.h"
+
+struct psycho_ctx;
+
+enum {
+	/** @brief The longest loop, in instructions, which can be detected. */
+	PSYCHO_WATCHDOG_PERIOD_MAX = 1024
+};
+
+enum psycho_watchdog_reason {
+	/** @brief The guest is stuck in a loop which can never exit. */
+	PSYCHO_WATCHDOG_REASON_LOOP,
+
+	/** @brief The guest has not printed anything for too long. */
+	PSYCHO_WATCHDOG_REASON_NO_PROGRESS
+};
+
+struct psycho_watchdog_hang {
+	enum psycho_watchdog_reason reason;
+
+	/** @brief The PC of the instruction about to be executed. */
+	u32 pc;
+
+	/**
+	 * @brief The number of instructions in one iteration of the loop, or 0
+	 * if the reason is not @ref PSYCHO_WATCHDOG_REASON_LOOP.
+	 */
+	u32 period;
+
+	/** @brief The number of instructions since the TTY was last written. */
+	u64 idle;
+};
+
+struct psycho_watchdog {
+	/** @brief The CPU state sampled at the start of the current check. */
+	struct psycho_cpu_sample sample;
+
+	u64 interval;
+	u64 countdown;
+
+	/** @brief Instructions without TTY output before the guest is hung. */
+	u64 timeout;
+	u64 idle;
+
+	/** @brief Instructions left to follow the guest for, 0 if none. */
+	u32 remaining;
+	bool enable;
+};
+
+/**
+ * @brief Enables or disables the guest hang watchdog.
+ *
+ * @param ctx The target psycho_ctx emulator context.
+ * @param enable Whether or not to enable the watchdog.
+ * @param interval The number of instructions between samples.
+ * @param timeout The number of instructions the guest may run for without
+ * writing to the TTY, or 0 to never consider that a hang.
+ */
+void psycho_watchdog_enable(struct psycho_ctx *ctx, bool enable, u64 interval,
+			    u64 timeout);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,1859 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bus.h"
+#include "cpu-defs.h"
+#include "icache.h"
+#include "idle.h"
+#include "ir.h"
+#include "timers.h"
+#include "util.h"
+
+enum {
+	// The most operations and temporaries one instruction translates into.
+	IR_INSTR_OPS_MAX = 4,
+	IR_INSTR_TMPS_MAX = 1
+};
+
+enum ir_op_flag {
+	IR_FLAG_A = 1 << 0,	// reads a
+	IR_FLAG_B = 1 << 1,	// reads b
+	IR_FLAG_DST = 1 << 2,	// writes dst
+	IR_FLAG_HILO = 1 << 3,	// writes HI and LO
+	IR_FLAG_PURE = 1 << 4,	// may be dropped if nothing reads the result
+	IR_FLAG_COMMUTES = 1 << 5,
+	IR_FLAG_GUARD = 1 << 6,
+	IR_FLAG_MEM = 1 << 7,	// accesses memory at a + imm
+
+	IR_FLAGS_RR = IR_FLAG_A | IR_FLAG_B | IR_FLAG_DST | IR_FLAG_PURE,
+	IR_FLAGS_RR_COMMUTES = IR_FLAGS_RR | IR_FLAG_COMMUTES,
+	IR_FLAGS_RI = IR_FLAG_A | IR_FLAG_DST | IR_FLAG_PURE,
+	IR_FLAGS_MULDIV = IR_FLAG_A | IR_FLAG_B | IR_FLAG_HILO | IR_FLAG_PURE,
+	IR_FLAGS_LOAD = IR_FLAG_A | IR_FLAG_DST | IR_FLAG_MEM,
+	IR_FLAGS_LOAD_MERGE = IR_FLAGS_LOAD | IR_FLAG_B,
+	IR_FLAGS_STORE = IR_FLAG_A | IR_FLAG_B | IR_FLAG_MEM,
+	IR_FLAGS_GUARD_RR = IR_FLAG_A | IR_FLAG_B | IR_FLAG_GUARD,
+	IR_FLAGS_GUARD_RI = IR_FLAG_A | IR_FLAG_GUARD
+};
+
+static const u8 ir_op_flags[] = {
+	// clang-format off
+
+	[PSYCHO_IR_OP_NOP]		= IR_FLAG_PURE,
+	[PSYCHO_IR_OP_CONST]		= IR_FLAG_DST | IR_FLAG_PURE,
+	[PSYCHO_IR_OP_MOV]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_ADD]		= IR_FLAGS_RR_COMMUTES,
+	[PSYCHO_IR_OP_ADDI]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_SUB]		= IR_FLAGS_RR,
+	[PSYCHO_IR_OP_AND]		= IR_FLAGS_RR_COMMUTES,
+	[PSYCHO_IR_OP_ANDI]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_OR]		= IR_FLAGS_RR_COMMUTES,
+	[PSYCHO_IR_OP_ORI]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_XOR]		= IR_FLAGS_RR_COMMUTES,
+	[PSYCHO_IR_OP_XORI]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_NOR]		= IR_FLAGS_RR_COMMUTES,
+	[PSYCHO_IR_OP_SLT]		= IR_FLAGS_RR,
+	[PSYCHO_IR_OP_SLTI]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_SLTU]		= IR_FLAGS_RR,
+	[PSYCHO_IR_OP_SLTIU]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_SLL]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_SRL]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_SRA]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_SLLV]		= IR_FLAGS_RR,
+	[PSYCHO_IR_OP_SRLV]		= IR_FLAGS_RR,
+	[PSYCHO_IR_OP_SRAV]		= IR_FLAGS_RR,
+	[PSYCHO_IR_OP_SEQ]		= IR_FLAGS_RR_COMMUTES,
+	[PSYCHO_IR_OP_SNE]		= IR_FLAGS_RR_COMMUTES,
+	[PSYCHO_IR_OP_SLEZ]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_SGTZ]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_SLTZ]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_SGEZ]		= IR_FLAGS_RI,
+	[PSYCHO_IR_OP_MULT]		= IR_FLAGS_MULDIV,
+	[PSYCHO_IR_OP_MULTU]		= IR_FLAGS_MULDIV,
+	[PSYCHO_IR_OP_DIV]		= IR_FLAGS_MULDIV,
+	[PSYCHO_IR_OP_DIVU]		= IR_FLAGS_MULDIV,
+	[PSYCHO_IR_OP_LB]		= IR_FLAGS_LOAD,
+	[PSYCHO_IR_OP_LBU]		= IR_FLAGS_LOAD,
+	[PSYCHO_IR_OP_LH]		= IR_FLAGS_LOAD,
+	[PSYCHO_IR_OP_LHU]		= IR_FLAGS_LOAD,
+	[PSYCHO_IR_OP_LW]		= IR_FLAGS_LOAD,
+	[PSYCHO_IR_OP_SB]		= IR_FLAGS_STORE,
+	[PSYCHO_IR_OP_SH]		= IR_FLAGS_STORE,
+	[PSYCHO_IR_OP_SW]		= IR_FLAGS_STORE,
+	[PSYCHO_IR_OP_LWL]		= IR_FLAGS_LOAD_MERGE,
+	[PSYCHO_IR_OP_LWR]		= IR_FLAGS_LOAD_MERGE,
+	[PSYCHO_IR_OP_SWL]		= IR_FLAGS_STORE,
+	[PSYCHO_IR_OP_SWR]		= IR_FLAGS_STORE,
+	[PSYCHO_IR_OP_GUARD_ADD]	= IR_FLAGS_GUARD_RR,
+	[PSYCHO_IR_OP_GUARD_ADDI]	= IR_FLAGS_GUARD_RI,
+	[PSYCHO_IR_OP_GUARD_SUB]	= IR_FLAGS_GUARD_RR,
+	[PSYCHO_IR_OP_GUARD_ALIGN2]	= IR_FLAGS_GUARD_RI,
+	[PSYCHO_IR_OP_GUARD_ALIGN4]	= IR_FLAGS_GUARD_RI,
+	[PSYCHO_IR_OP_GUARD_CODE]	= IR_FLAGS_GUARD_RI
+
+	// clang-format on
+};
+
+// Returns the same operation with b replaced by an immediate, if there is one.
+CONST_FN static uint op_imm_form(const uint code)
+{
+	switch (code) {
+	case PSYCHO_IR_OP_ADD:
+	case PSYCHO_IR_OP_SUB:
+		return PSYCHO_IR_OP_ADDI;
+
+	case PSYCHO_IR_OP_AND:
+		return PSYCHO_IR_OP_ANDI;
+
+	case PSYCHO_IR_OP_OR:
+		return PSYCHO_IR_OP_ORI;
+
+	case PSYCHO_IR_OP_XOR:
+		return PSYCHO_IR_OP_XORI;
+
+	case PSYCHO_IR_OP_SLT:
+		return PSYCHO_IR_OP_SLTI;
+
+	case PSYCHO_IR_OP_SLTU:
+		return PSYCHO_IR_OP_SLTIU;
+
+	case PSYCHO_IR_OP_SLLV:
+		return PSYCHO_IR_OP_SLL;
+
+	case PSYCHO_IR_OP_SRLV:
+		return PSYCHO_IR_OP_SRL;
+
+	case PSYCHO_IR_OP_SRAV:
+		return PSYCHO_IR_OP_SRA;
+
+	default:
+		return PSYCHO_IR_OP_NOP;
+	}
+}
+
+enum ir_instr_class {
+	IR_INSTR_UNSUPPORTED,
+	IR_INSTR_PLAIN,
+	IR_INSTR_BRANCH
+};
+
+struct ir_load {
+	u8 dst;
+	u8 vreg;
+};
+
+struct ir_translator {
+	struct psycho_ir_block *block;
+
+	// The load landing before the next instruction, and the one landing
+	// after it; the same as ld_next and ld_pend of struct psycho_cpu.
+	struct ir_load ld_next;
+	struct ir_load ld_pend;
+
+	uint tmp_next;
+};
+
+ALWAYS_INLINE u64 vreg_bit(const uint vreg)
+{
+	return UINT64_C(1) << vreg;
+}
+
+// Every guest register is live wherever the block is left; $zero is not, as
+// it never changes.
+static const u64 ir_guest_mask = (UINT64_C(1) << PSYCHO_IR_VREG_TMP_FIRST) - 2;
+
+static const u64 ir_hilo_mask = UINT64_C(3) << PSYCHO_IR_VREG_HI;
+
+// Executes one operation on the virtual registers; returns `false` if it is a
+// guard which failed. Memory is only ever touched through @p ctx, so ctx may
+// be NULL for anything else.
+ALWAYS_INLINE bool op_run(struct psycho_ctx *const ctx,
+			  const struct psycho_ir_block *const block,
+			  const struct psycho_ir_op *const op, u32 *const v)
+{
+	const u32 a = v[op->a];
+	const u32 b = v[op->b];
+	const u32 imm = op->imm;
+
+	switch (op->code) {
+	case PSYCHO_IR_OP_NOP:
+		return true;
+
+	case PSYCHO_IR_OP_CONST:
+		v[op->dst] = imm;
+		return true;
+
+	case PSYCHO_IR_OP_MOV:
+		v[op->dst] = a;
+		return true;
+
+	case PSYCHO_IR_OP_ADD:
+		v[op->dst] = a + b;
+		return true;
+
+	case PSYCHO_IR_OP_ADDI:
+		v[op->dst] = a + imm;
+		return true;
+
+	case PSYCHO_IR_OP_SUB:
+		v[op->dst] = a - b;
+		return true;
+
+	case PSYCHO_IR_OP_AND:
+		v[op->dst] = a & b;
+		return true;
+
+	case PSYCHO_IR_OP_ANDI:
+		v[op->dst] = a & imm;
+		return true;
+
+	case PSYCHO_IR_OP_OR:
+		v[op->dst] = a | b;
+		return true;
+
+	case PSYCHO_IR_OP_ORI:
+		v[op->dst] = a | imm;
+		return true;
+
+	case PSYCHO_IR_OP_XOR:
+		v[op->dst] = a ^ b;
+		return true;
+
+	case PSYCHO_IR_OP_XORI:
+		v[op->dst] = a ^ imm;
+		return true;
+
+	case PSYCHO_IR_OP_NOR:
+		v[op->dst] = ~(a | b);
+		return true;
+
+	case PSYCHO_IR_OP_SLT:
+		v[op->dst] = (s32)a < (s32)b;
+		return true;
+
+	case PSYCHO_IR_OP_SLTI:
+		v[op->dst] = (s32)a < (s32)imm;
+		return true;
+
+	case PSYCHO_IR_OP_SLTU:
+		v[op->dst] = a < b;
+		return true;
+
+	case PSYCHO_IR_OP_SLTIU:
+		v[op->dst] = a < imm;
+		return true;
+
+	case PSYCHO_IR_OP_SLL:
+		v[op->dst] = a << imm;
+		return true;
+
+	case PSYCHO_IR_OP_SRL:
+		v[op->dst] = a >> imm;
+		return true;
+
+	case PSYCHO_IR_OP_SRA:
+		v[op->dst] = (s32)a >> imm;
+		return true;
+
+	case PSYCHO_IR_OP_SLLV:
+		v[op->dst] = a << (b & 0x0000001F);
+		return true;
+
+	case PSYCHO_IR_OP_SRLV:
+		v[op->dst] = a >> (b & 0x0000001F);
+		return true;
+
+	case PSYCHO_IR_OP_SRAV:
+		v[op->dst] = (s32)a >> (b & 0x0000001F);
+		return true;
+
+	case PSYCHO_IR_OP_SEQ:
+		v[op->dst] = a == b;
+		return true;
+
+	case PSYCHO_IR_OP_SNE:
+		v[op->dst] = a != b;
+		return true;
+
+	case PSYCHO_IR_OP_SLEZ:
+		v[op->dst] = (s32)a <= 0;
+		return true;
+
+	case PSYCHO_IR_OP_SGTZ:
+		v[op->dst] = (s32)a > 0;
+		return true;
+
+	case PSYCHO_IR_OP_SLTZ:
+		v[op->dst] = (s32)a < 0;
+		return true;
+
+	case PSYCHO_IR_OP_SGEZ:
+		v[op->dst] = (s32)a >= 0;
+		return true;
+
+	case PSYCHO_IR_OP_MULT: {
+		const u64 prod = sign_ext_32_64(a) * sign_ext_32_64(b);
+
+		v[PSYCHO_IR_VREG_LO] = prod & UINT32_MAX;
+		v[PSYCHO_IR_VREG_HI] = prod >> 32;
+
+		return true;
+	}
+
+	case PSYCHO_IR_OP_MULTU: {
+		const u64 prod = zero_ext_32_64(a) * zero_ext_32_64(b);
+
+		v[PSYCHO_IR_VREG_LO] = prod & UINT32_MAX;
+		v[PSYCHO_IR_VREG_HI] = prod >> 32;
+
+		return true;
+	}
+
+	// Division by zero and overflow give what psycho_cpu_step() gives.
+	case PSYCHO_IR_OP_DIV:
+		if (unlikely(!b)) {
+			v[PSYCHO_IR_VREG_LO] =
+				((s32)a < 0) ? 0x00000001 : UINT32_MAX;
+			v[PSYCHO_IR_VREG_HI] = a;
+		} else if (unlikely((a == 0x80000000) && (b == UINT32_MAX))) {
+			v[PSYCHO_IR_VREG_LO] = a;
+			v[PSYCHO_IR_VREG_HI] = 0x00000000;
+		} else {
+			v[PSYCHO_IR_VREG_LO] = (s32)a / (s32)b;
+			v[PSYCHO_IR_VREG_HI] = (s32)a % (s32)b;
+		}
+		return true;
+
+	case PSYCHO_IR_OP_DIVU:
+		if (unlikely(!b)) {
+			v[PSYCHO_IR_VREG_LO] = UINT32_MAX;
+			v[PSYCHO_IR_VREG_HI] = a;
+		} else {
+			v[PSYCHO_IR_VREG_LO] = a / b;
+			v[PSYCHO_IR_VREG_HI] = a % b;
+		}
+		return true;
+
+	case PSYCHO_IR_OP_LB:
+		v[op->dst] = sign_ext_8_32(psycho_bus_load_byte(
+			ctx, data_vaddr_to_paddr(a + imm)));
+		return true;
+
+	case PSYCHO_IR_OP_LBU:
+		v[op->dst] =
+			psycho_bus_load_byte(ctx, data_vaddr_to_paddr(a + imm));
+		return true;
+
+	case PSYCHO_IR_OP_LH:
+		v[op->dst] = sign_ext_16_32(psycho_bus_load_halfword(
+			ctx, data_vaddr_to_paddr(a + imm)));
+		return true;
+
+	case PSYCHO_IR_OP_LHU:
+		v[op->dst] = psycho_bus_load_halfword(
+			ctx, data_vaddr_to_paddr(a + imm));
+		return true;
+
+	case PSYCHO_IR_OP_LW:
+		v[op->dst] =
+			psycho_bus_load_word(ctx, data_vaddr_to_paddr(a + imm));
+		return true;
+
+	case PSYCHO_IR_OP_SB:
+		psycho_bus_store_byte(ctx, data_vaddr_to_paddr(a + imm),
+				      b & UINT8_MAX);
+		return true;
+
+	case PSYCHO_IR_OP_SH:
+		psycho_bus_store_halfword(ctx, data_vaddr_to_paddr(a + imm),
+					  b & UINT16_MAX);
+		return true;
+
+	case PSYCHO_IR_OP_SW:
+		psycho_bus_store_word(ctx, data_vaddr_to_paddr(a + imm), b);
+		return true;
+
+	case PSYCHO_IR_OP_LWL: {
+		const u32 paddr = data_vaddr_to_paddr(a + imm);
+		const u32 word = psycho_bus_load_word(ctx, paddr & ~3);
+		const uint shift = (paddr & 3) * 8;
+		const u32 mask = 0x00FFFFFF >> shift;
+
+		v[op->dst] = (b & mask) | (word << (24 - shift));
+		return true;
+	}
+
+	case PSYCHO_IR_OP_LWR: {
+		const u32 paddr = data_vaddr_to_paddr(a + imm);
+		const u32 word = psycho_bus_load_word(ctx, paddr & ~3);
+		const uint shift = (paddr & 3) * 8;
+		const u32 mask = 0xFFFFFF00 << (24 - shift);
+
+		v[op->dst] = (b & mask) | (word >> shift);
+		return true;
+	}
+
+	case PSYCHO_IR_OP_SWL: {
+		const u32 paddr = data_vaddr_to_paddr(a + imm);
+		const uint shift = (paddr & 3) * 8;
+
+		u32 word = psycho_bus_load_word(ctx, paddr & ~3);
+		word = (word & (0xFFFFFF00 << shift)) | (b >> (24 - shift));
+		psycho_bus_store_word(ctx, paddr & ~3, word);
+
+		return true;
+	}
+
+	case PSYCHO_IR_OP_SWR: {
+		const u32 paddr = data_vaddr_to_paddr(a + imm);
+		const uint shift = (paddr & 3) * 8;
+
+		u32 word = psycho_bus_load_word(ctx, paddr & ~3);
+		word = (word & (0x00FFFFFF >> (24 - shift))) | (b << shift);
+		psycho_bus_store_word(ctx, paddr & ~3, word);
+
+		return true;
+	}
+
+	case PSYCHO_IR_OP_GUARD_ADD: {
+		s32 res;
+		return !__builtin_sadd_overflow((s32)a, (s32)b, &res);
+	}
+
+	case PSYCHO_IR_OP_GUARD_ADDI: {
+		s32 res;
+		return !__builtin_sadd_overflow((s32)a, (s32)imm, &res);
+	}
+
+	case PSYCHO_IR_OP_GUARD_SUB: {
+		s32 res;
+		return !__builtin_ssub_overflow((s32)a, (s32)b, &res);
+	}
+
+	case PSYCHO_IR_OP_GUARD_ALIGN2:
+		return !((a + imm) & 1);
+
+	case PSYCHO_IR_OP_GUARD_ALIGN4:
+		return !((a + imm) & 3);
+
+	case PSYCHO_IR_OP_GUARD_CODE: {
+		const u32 paddr = data_vaddr_to_paddr(a + imm) & ~3;
+		return (paddr - block->paddr) >=
+		       (block->instrs_num * sizeof(u32));
+	}
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+static enum ir_instr_class instr_class(const u32 instr)
+{
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_SPECIAL:
+		switch (instr_funct(instr)) {
+		case INSTR_JR:
+		case INSTR_JALR:
+			return IR_INSTR_BRANCH;
+
+		case INSTR_SLL:
+		case INSTR_SRL:
+		case INSTR_SRA:
+		case INSTR_SLLV:
+		case INSTR_SRLV:
+		case INSTR_SRAV:
+		case INSTR_MFHI:
+		case INSTR_MTHI:
+		case INSTR_MFLO:
+		case INSTR_MTLO:
+		case INSTR_MULT:
+		case INSTR_MULTU:
+		case INSTR_DIV:
+		case INSTR_DIVU:
+		case INSTR_ADD:
+		case INSTR_ADDU:
+		case INSTR_SUB:
+		case INSTR_SUBU:
+		case INSTR_AND:
+		case INSTR_OR:
+		case INSTR_XOR:
+		case INSTR_NOR:
+		case INSTR_SLT:
+		case INSTR_SLTU:
+			return IR_INSTR_PLAIN;
+
+		default:
+			return IR_INSTR_UNSUPPORTED;
+		}
+
+	case INSTR_GROUP_BCOND:
+	case INSTR_J:
+	case INSTR_JAL:
+	case INSTR_BEQ:
+	case INSTR_BNE:
+	case INSTR_BLEZ:
+	case INSTR_BGTZ:
+		return IR_INSTR_BRANCH;
+
+	case INSTR_ADDI:
+	case INSTR_ADDIU:
+	case INSTR_SLTI:
+	case INSTR_SLTIU:
+	case INSTR_ANDI:
+	case INSTR_ORI:
+	case INSTR_XORI:
+	case INSTR_LUI:
+	case INSTR_LB:
+	case INSTR_LH:
+	case INSTR_LW:
+	case INSTR_LBU:
+	case INSTR_LHU:
+	case INSTR_SB:
+	case INSTR_SH:
+	case INSTR_SW:
+	case INSTR_LWL:
+	case INSTR_LWR:
+	case INSTR_SWL:
+	case INSTR_SWR:
+		return IR_INSTR_PLAIN;
+
+	// COP0 and GTE accesses and traps are left to the interpreter.
+	default:
+		return IR_INSTR_UNSUPPORTED;
+	}
+}
+
+static void emit(struct ir_translator *const tr, const uint code,
+		 const uint dst, const uint a, const uint b, const u32 imm)
+{
+	struct psycho_ir_block *const block = tr->block;
+
+	block->ops[block->ops_num++] = (struct psycho_ir_op){
+		// clang-format off
+
+		.code	= code,
+		.dst	= dst,
+		.a	= a,
+		.b	= b,
+		.imm	= imm
+
+		// clang-format on
+	};
+}
+
+// Writes a guest register as gpr_set() does, cancelling a pending load into
+// the same register. Writes to $zero are dropped outright, so that it reads
+// back as zero throughout the block.
+static void emit_set(struct ir_translator *const tr, const uint code,
+		     const uint dst, const uint a, const uint b, const u32 imm)
+{
+	if (!dst)
+		return;
+
+	emit(tr, code, dst, a, b, imm);
+
+	if (tr->ld_next.dst == dst)
+		tr->ld_next = (struct ir_load){ 0 };
+}
+
+// Delays the load held in @p vreg, as gpr_set_delayed() does.
+static void load_delay(struct ir_translator *const tr, const uint dst,
+		       const uint vreg)
+{
+	// A load into $zero is still carried out, but is never delayed.
+	if (!dst)
+		return;
+
+	tr->ld_pend = (struct ir_load){ .dst = dst, .vreg = vreg };
+
+	if (tr->ld_next.dst == dst)
+		tr->ld_next = (struct ir_load){ 0 };
+}
+
+// Loads into a temporary.
+static void emit_load(struct ir_translator *const tr, const uint code,
+		      const uint dst, const uint base, const u32 off)
+{
+	const uint vreg = tr->tmp_next++;
+
+	emit(tr, code, vreg, base, 0, off);
+	load_delay(tr, dst, vreg);
+}
+
+// LWL and LWR merge into the value the register is about to receive, if a
+// load is about to land in it, so that a pair of them assembles one word.
+static void emit_load_merge(struct ir_translator *const tr, const uint code,
+			    const uint dst, const uint base, const u32 off)
+{
+	const uint merge = (tr->ld_next.dst == dst) ? tr->ld_next.vreg : dst;
+	const uint vreg = tr->tmp_next++;
+
+	emit(tr, code, vreg, base, merge, off);
+	load_delay(tr, dst, vreg);
+}
+
+// Guards run before the load landing ahead of their instruction has landed,
+// so they read the temporary holding it instead of its destination.
+static uint guard_src(const struct ir_translator *const tr, const uint reg)
+{
+	return (reg == tr->ld_next.dst) ? tr->ld_next.vreg : reg;
+}
+
+static void emit_guard(struct ir_translator *const tr, const uint code,
+		       const uint exit, const uint a, const uint b,
+		       const u32 imm)
+{
+	emit(tr, code, exit, guard_src(tr, a), guard_src(tr, b), imm);
+}
+
+static void target_set(struct ir_translator *const tr,
+		       const enum psycho_ir_target_kind kind, const uint vreg,
+		       const u32 target, const u32 target_alt)
+{
+	tr->block->target_kind = kind;
+	tr->block->target_vreg = vreg;
+	tr->block->target = target;
+	tr->block->target_alt = target_alt;
+}
+
+static void exit_set(struct ir_translator *const tr, const uint index,
+		     const u32 pc, const enum psycho_ir_exit_kind kind)
+{
+	tr->block->exits[index] = (struct psycho_ir_exit){
+		// clang-format off
+
+		.pc		= pc,
+		.instrs		= index,
+		.kind		= kind,
+		.ld_next_dst	= tr->ld_next.dst,
+		.ld_next_vreg	= tr->ld_next.vreg,
+		.ld_pend_dst	= tr->ld_pend.dst,
+		.ld_pend_vreg	= tr->ld_pend.vreg
+
+		// clang-format on
+	};
+}
+
+// Emits the checks for whatever would make the instruction trap; any of them
+// failing leaves the block through the exit before it.
+static void instr_guards(struct ir_translator *const tr, const u32 instr,
+			 const uint exit)
+{
+	const uint rs = instr_rs(instr);
+	const uint rt = instr_rt(instr);
+	const u32 off = sign_ext_16_32(instr_imm(instr));
+	const bool ram = tr->block->ram;
+
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_SPECIAL:
+		switch (instr_funct(instr)) {
+		case INSTR_ADD:
+			emit_guard(tr, PSYCHO_IR_OP_GUARD_ADD, exit, rs, rt, 0);
+			return;
+
+		case INSTR_SUB:
+			emit_guard(tr, PSYCHO_IR_OP_GUARD_SUB, exit, rs, rt, 0);
+			return;
+
+		case INSTR_JALR:
+			emit_guard(tr, PSYCHO_IR_OP_GUARD_ALIGN4, exit, rs, 0,
+				   0);
+			return;
+
+		default:
+			return;
+		}
+
+	case INSTR_ADDI:
+		emit_guard(tr, PSYCHO_IR_OP_GUARD_ADDI, exit, rs, 0, off);
+		return;
+
+	case INSTR_LH:
+	case INSTR_LHU:
+		emit_guard(tr, PSYCHO_IR_OP_GUARD_ALIGN2, exit, rs, 0, off);
+		return;
+
+	case INSTR_LW:
+		emit_guard(tr, PSYCHO_IR_OP_GUARD_ALIGN4, exit, rs, 0, off);
+		return;
+
+	// A store into the block itself has to be seen by the instructions
+	// following it.
+	case INSTR_SB:
+		if (ram)
+			emit_guard(tr, PSYCHO_IR_OP_GUARD_CODE, exit, rs, 0,
+				   off);
+		return;
+
+	case INSTR_SH:
+		emit_guard(tr, PSYCHO_IR_OP_GUARD_ALIGN2, exit, rs, 0, off);
+
+		if (ram)
+			emit_guard(tr, PSYCHO_IR_OP_GUARD_CODE, exit, rs, 0,
+				   off);
+		return;
+
+	case INSTR_SW:
+		emit_guard(tr, PSYCHO_IR_OP_GUARD_ALIGN4, exit, rs, 0, off);
+
+		if (ram)
+			emit_guard(tr, PSYCHO_IR_OP_GUARD_CODE, exit, rs, 0,
+				   off);
+		return;
+
+	case INSTR_SWL:
+	case INSTR_SWR:
+		if (ram)
+			emit_guard(tr, PSYCHO_IR_OP_GUARD_CODE, exit, rs, 0,
+				   off);
+		return;
+
+	default:
+		return;
+	}
+}
+
+// Lands the load issued two instructions ago, as load_delay_process() does at
+// the start of every step.
+static void load_land(struct ir_translator *const tr)
+{
+	if (tr->ld_next.dst)
+		emit(tr, PSYCHO_IR_OP_MOV, tr->ld_next.dst, tr->ld_next.vreg,
+		     0, 0);
+
+	tr->ld_next = tr->ld_pend;
+	tr->ld_pend = (struct ir_load){ 0 };
+}
+
+static void instr_body_special(struct ir_translator *const tr, const u32 instr,
+			       const u32 pc)
+{
+	const uint rs = instr_rs(instr);
+	const uint rt = instr_rt(instr);
+	const uint rd = instr_rd(instr);
+	const uint shamt = instr_shamt(instr);
+	const u32 link = pc + (sizeof(u32) * 2);
+
+	switch (instr_funct(instr)) {
+	case INSTR_SLL:
+		emit_set(tr, PSYCHO_IR_OP_SLL, rd, rt, 0, shamt);
+		return;
+
+	case INSTR_SRL:
+		emit_set(tr, PSYCHO_IR_OP_SRL, rd, rt, 0, shamt);
+		return;
+
+	case INSTR_SRA:
+		emit_set(tr, PSYCHO_IR_OP_SRA, rd, rt, 0, shamt);
+		return;
+
+	case INSTR_SLLV:
+		emit_set(tr, PSYCHO_IR_OP_SLLV, rd, rt, rs, 0);
+		return;
+
+	case INSTR_SRLV:
+		emit_set(tr, PSYCHO_IR_OP_SRLV, rd, rt, rs, 0);
+		return;
+
+	case INSTR_SRAV:
+		emit_set(tr, PSYCHO_IR_OP_SRAV, rd, rt, rs, 0);
+		return;
+
+	// The delay slot may overwrite the register holding the target.
+	case INSTR_JR: {
+		const uint vreg = tr->tmp_next++;
+
+		emit(tr, PSYCHO_IR_OP_MOV, vreg, rs, 0, 0);
+		target_set(tr, PSYCHO_IR_TARGET_VREG, vreg, 0, 0);
+		return;
+	}
+
+	case INSTR_JALR: {
+		const uint vreg = tr->tmp_next++;
+
+		emit(tr, PSYCHO_IR_OP_MOV, vreg, rs, 0, 0);
+		emit_set(tr, PSYCHO_IR_OP_CONST, rd, 0, 0, link);
+		target_set(tr, PSYCHO_IR_TARGET_VREG, vreg, 0, 0);
+		return;
+	}
+
+	case INSTR_MFHI:
+		emit_set(tr, PSYCHO_IR_OP_MOV, rd, PSYCHO_IR_VREG_HI, 0, 0);
+		return;
+
+	case INSTR_MTHI:
+		emit(tr, PSYCHO_IR_OP_MOV, PSYCHO_IR_VREG_HI, rs, 0, 0);
+		return;
+
+	case INSTR_MFLO:
+		emit_set(tr, PSYCHO_IR_OP_MOV, rd, PSYCHO_IR_VREG_LO, 0, 0);
+		return;
+
+	case INSTR_MTLO:
+		emit(tr, PSYCHO_IR_OP_MOV, PSYCHO_IR_VREG_LO, rs, 0, 0);
+		return;
+
+	case INSTR_MULT:
+		emit(tr, PSYCHO_IR_OP_MULT, 0, rs, rt, 0);
+		return;
+
+	case INSTR_MULTU:
+		emit(tr, PSYCHO_IR_OP_MULTU, 0, rs, rt, 0);
+		return;
+
+	case INSTR_DIV:
+		emit(tr, PSYCHO_IR_OP_DIV, 0, rs, rt, 0);
+		return;
+
+	case INSTR_DIVU:
+		emit(tr, PSYCHO_IR_OP_DIVU, 0, rs, rt, 0);
+		return;
+
+	case INSTR_ADD:
+	case INSTR_ADDU:
+		emit_set(tr, PSYCHO_IR_OP_ADD, rd, rs, rt, 0);
+		return;
+
+	case INSTR_SUB:
+	case INSTR_SUBU:
+		emit_set(tr, PSYCHO_IR_OP_SUB, rd, rs, rt, 0);
+		return;
+
+	case INSTR_AND:
+		emit_set(tr, PSYCHO_IR_OP_AND, rd, rs, rt, 0);
+		return;
+
+	case INSTR_OR:
+		emit_set(tr, PSYCHO_IR_OP_OR, rd, rs, rt, 0);
+		return;
+
+	case INSTR_XOR:
+		emit_set(tr, PSYCHO_IR_OP_XOR, rd, rs, rt, 0);
+		return;
+
+	case INSTR_NOR:
+		emit_set(tr, PSYCHO_IR_OP_NOR, rd, rs, rt, 0);
+		return;
+
+	case INSTR_SLT:
+		emit_set(tr, PSYCHO_IR_OP_SLT, rd, rs, rt, 0);
+		return;
+
+	case INSTR_SLTU:
+		emit_set(tr, PSYCHO_IR_OP_SLTU, rd, rs, rt, 0);
+		return;
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+// Emits a conditional branch, whose condition is computed before any link
+// register is written.
+static void emit_branch(struct ir_translator *const tr, const uint code,
+			const u32 instr, const u32 pc, const bool link)
+{
+	const uint vreg = tr->tmp_next++;
+
+	emit(tr, code, vreg, instr_rs(instr), instr_rt(instr), 0);
+
+	if (link)
+		emit_set(tr, PSYCHO_IR_OP_CONST, CPU_GPR_RA, 0, 0,
+			 pc + (sizeof(u32) * 2));
+
+	target_set(tr, PSYCHO_IR_TARGET_COND, vreg, calc_branch_addr(instr, pc),
+		   pc + (sizeof(u32) * 2));
+}
+
+static void instr_body(struct ir_translator *const tr, const u32 instr,
+		       const u32 pc)
+{
+	const uint rs = instr_rs(instr);
+	const uint rt = instr_rt(instr);
+	const u32 imm = instr_imm(instr);
+	const u32 simm = sign_ext_16_32(instr_imm(instr));
+
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_SPECIAL:
+		instr_body_special(tr, instr, pc);
+		return;
+
+	case INSTR_GROUP_BCOND:
+		emit_branch(tr,
+			    (rt & 1) ? PSYCHO_IR_OP_SGEZ : PSYCHO_IR_OP_SLTZ,
+			    instr, pc, (rt & 0x1E) == 0x10);
+		return;
+
+	case INSTR_J:
+		target_set(tr, PSYCHO_IR_TARGET_CONST, 0,
+			   calc_jmp_addr(instr, pc), 0);
+		return;
+
+	case INSTR_JAL:
+		emit_set(tr, PSYCHO_IR_OP_CONST, CPU_GPR_RA, 0, 0,
+			 pc + (sizeof(u32) * 2));
+		target_set(tr, PSYCHO_IR_TARGET_CONST, 0,
+			   calc_jmp_addr(instr, pc), 0);
+		return;
+
+	case INSTR_BEQ:
+		emit_branch(tr, PSYCHO_IR_OP_SEQ, instr, pc, false);
+		return;
+
+	case INSTR_BNE:
+		emit_branch(tr, PSYCHO_IR_OP_SNE, instr, pc, false);
+		return;
+
+	case INSTR_BLEZ:
+		emit_branch(tr, PSYCHO_IR_OP_SLEZ, instr, pc, false);
+		return;
+
+	case INSTR_BGTZ:
+		emit_branch(tr, PSYCHO_IR_OP_SGTZ, instr, pc, false);
+		return;
+
+	case INSTR_ADDI:
+	case INSTR_ADDIU:
+		emit_set(tr, PSYCHO_IR_OP_ADDI, rt, rs, 0, simm);
+		return;
+
+	case INSTR_SLTI:
+		emit_set(tr, PSYCHO_IR_OP_SLTI, rt, rs, 0, simm);
+		return;
+
+	case INSTR_SLTIU:
+		emit_set(tr, PSYCHO_IR_OP_SLTIU, rt, rs, 0, simm);
+		return;
+
+	case INSTR_ANDI:
+		emit_set(tr, PSYCHO_IR_OP_ANDI, rt, rs, 0, imm);
+		return;
+
+	case INSTR_ORI:
+		emit_set(tr, PSYCHO_IR_OP_ORI, rt, rs, 0, imm);
+		return;
+
+	case INSTR_XORI:
+		emit_set(tr, PSYCHO_IR_OP_XORI, rt, rs, 0, imm);
+		return;
+
+	case INSTR_LUI:
+		emit_set(tr, PSYCHO_IR_OP_CONST, rt, 0, 0, imm << 16);
+		return;
+
+	case INSTR_LB:
+		emit_load(tr, PSYCHO_IR_OP_LB, rt, rs, simm);
+		return;
+
+	case INSTR_LH:
+		emit_load(tr, PSYCHO_IR_OP_LH, rt, rs, simm);
+		return;
+
+	case INSTR_LW:
+		emit_load(tr, PSYCHO_IR_OP_LW, rt, rs, simm);
+		return;
+
+	case INSTR_LBU:
+		emit_load(tr, PSYCHO_IR_OP_LBU, rt, rs, simm);
+		return;
+
+	case INSTR_LHU:
+		emit_load(tr, PSYCHO_IR_OP_LHU, rt, rs, simm);
+		return;
+
+	case INSTR_SB:
+		emit(tr, PSYCHO_IR_OP_SB, 0, rs, rt, simm);
+		return;
+
+	case INSTR_SH:
+		emit(tr, PSYCHO_IR_OP_SH, 0, rs, rt, simm);
+		return;
+
+	case INSTR_SW:
+		emit(tr, PSYCHO_IR_OP_SW, 0, rs, rt, simm);
+		return;
+
+	case INSTR_LWL:
+		emit_load_merge(tr, PSYCHO_IR_OP_LWL, rt, rs, simm);
+		return;
+
+	case INSTR_LWR:
+		emit_load_merge(tr, PSYCHO_IR_OP_LWR, rt, rs, simm);
+		return;
+
+	case INSTR_SWL:
+		emit(tr, PSYCHO_IR_OP_SWL, 0, rs, rt, simm);
+		return;
+
+	case INSTR_SWR:
+		emit(tr, PSYCHO_IR_OP_SWR, 0, rs, rt, simm);
+		return;
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+static void instr_translate(struct ir_translator *const tr, const u32 instr,
+			    const u32 pc, const uint index)
+{
+	instr_guards(tr, instr, index);
+	load_land(tr);
+	instr_body(tr, instr, pc);
+}
+
+static bool room_left(const struct ir_translator *const tr, const uint instrs)
+{
+	return ((tr->block->ops_num + (instrs * IR_INSTR_OPS_MAX)) <=
+		PSYCHO_IR_BLOCK_OPS_MAX) &&
+	       ((tr->tmp_next + (instrs * IR_INSTR_TMPS_MAX)) <=
+		PSYCHO_IR_VREG_NUM);
+}
+
+// Folds every operation whose operands are known at translation time into a
+// constant, and turns those with one known operand into their immediate
+// forms; a `lui` followed by an `ori` or `addiu` becomes a single constant.
+// Guards known to pass are dropped.
+static void pass_const_fold(struct psycho_ir_block *const block)
+{
+	u32 val[PSYCHO_IR_VREG_NUM] = { 0 };
+	u64 known = vreg_bit(0);
+
+	for (uint i = 0; i < block->ops_num; ++i) {
+		struct psycho_ir_op *const op = &block->ops[i];
+		const uint imm_form = op_imm_form(op->code);
+		u8 flags = ir_op_flags[op->code];
+
+		const bool known_a = known & vreg_bit(op->a);
+		const bool known_b = known & vreg_bit(op->b);
+
+		if (imm_form && (known_a != known_b) &&
+		    (known_b || (flags & IR_FLAG_COMMUTES))) {
+			if (known_a)
+				swap(&op->a, &op->b);
+
+			switch (op->code) {
+			case PSYCHO_IR_OP_SUB:
+				op->imm = -val[op->b];
+				break;
+
+			case PSYCHO_IR_OP_SLLV:
+			case PSYCHO_IR_OP_SRLV:
+			case PSYCHO_IR_OP_SRAV:
+				op->imm = val[op->b] & 0x0000001F;
+				break;
+
+			default:
+				op->imm = val[op->b];
+				break;
+			}
+
+			op->code = imm_form;
+			op->b = 0;
+			flags = ir_op_flags[op->code];
+		}
+
+		if ((flags & IR_FLAG_MEM) && (known & vreg_bit(op->a))) {
+			op->imm += val[op->a];
+			op->a = 0;
+		}
+
+		u64 reads = 0;
+
+		if (flags & IR_FLAG_A)
+			reads |= vreg_bit(op->a);
+
+		if (flags & IR_FLAG_B)
+			reads |= vreg_bit(op->b);
+
+		const bool foldable = (known & reads) == reads;
+
+		if (flags & IR_FLAG_GUARD) {
+			if (foldable && op_run(NULL, block, op, val))
+				op->code = PSYCHO_IR_OP_NOP;
+
+			continue;
+		}
+
+		if (!(flags & IR_FLAG_PURE) || !foldable) {
+			if ((flags & IR_FLAG_DST) && op->dst)
+				known &= ~vreg_bit(op->dst);
+
+			if (flags & IR_FLAG_HILO)
+				known &= ~ir_hilo_mask;
+			continue;
+		}
+
+		op_run(NULL, block, op, val);
+
+		if ((flags & IR_FLAG_DST) && op->dst) {
+			op->code = PSYCHO_IR_OP_CONST;
+			op->imm = val[op->dst];
+			known |= vreg_bit(op->dst);
+		}
+
+		if (flags & IR_FLAG_HILO)
+			known |= ir_hilo_mask;
+
+		val[0] = 0;
+	}
+
+	if (!(known & vreg_bit(block->target_vreg)))
+		return;
+
+	switch (block->target_kind) {
+	case PSYCHO_IR_TARGET_COND:
+		if (!val[block->target_vreg])
+			block->target = block->target_alt;
+
+		block->target_kind = PSYCHO_IR_TARGET_CONST;
+		break;
+
+	case PSYCHO_IR_TARGET_VREG:
+		block->target = val[block->target_vreg];
+		block->target_kind = PSYCHO_IR_TARGET_CONST;
+		break;
+
+	default:
+		break;
+	}
+}
+
+static u64 exit_live(const struct psycho_ir_block *const block,
+		     const struct psycho_ir_exit *const exit)
+{
+	u64 live = ir_guest_mask | vreg_bit(exit->ld_next_vreg) |
+		   vreg_bit(exit->ld_pend_vreg);
+
+	if (exit->kind != PSYCHO_IR_EXIT_SEQ)
+		live |= vreg_bit(block->target_vreg);
+
+	return live;
+}
+
+// Drops every write nothing reads before it is overwritten or the block is
+// left.
+static void pass_dead_writes(struct psycho_ir_block *const block)
+{
+	u64 live = exit_live(block, &block->exits[block->instrs_num]);
+
+	for (uint i = block->ops_num; i-- > 0;) {
+		struct psycho_ir_op *const op = &block->ops[i];
+		const u8 flags = ir_op_flags[op->code];
+
+		u64 writes = 0;
+
+		if (flags & IR_FLAG_DST)
+			writes |= vreg_bit(op->dst);
+
+		if (flags & IR_FLAG_HILO)
+			writes |= ir_hilo_mask;
+
+		if ((flags & IR_FLAG_PURE) && !(live & writes)) {
+			op->code = PSYCHO_IR_OP_NOP;
+			continue;
+		}
+
+		live &= ~writes;
+
+		if (flags & IR_FLAG_GUARD)
+			live |= exit_live(block, &block->exits[op->dst]);
+
+		if (flags & IR_FLAG_A)
+			live |= vreg_bit(op->a);
+
+		if (flags & IR_FLAG_B)
+			live |= vreg_bit(op->b);
+	}
+}
+
+static void pass_compact(struct psycho_ir_block *const block)
+{
+	uint num = 0;
+
+	for (uint i = 0; i < block->ops_num; ++i) {
+		if (block->ops[i].code != PSYCHO_IR_OP_NOP)
+			block->ops[num++] = block->ops[i];
+	}
+	block->ops_num = num;
+}
+
+// Returns the number of instructions from @p paddr to the end of the memory it
+// lies in, if that memory may be translated from at all.
+static u32 region_instrs_left(const u32 paddr, bool *const ram)
+{
+	*ram = paddr < RAM_SIZE;
+
+	if (*ram)
+		return (RAM_SIZE - paddr) / sizeof(u32);
+
+	if ((paddr >= BIOS_ADDR_START) && (paddr <= BIOS_ADDR_END))
+		return (BIOS_ADDR_END + 1 - paddr) / sizeof(u32);
+
+	return 0;
+}
+
+// Finds the native block generated from the same translation, if there is
+// one.
+PURE_FN static psycho_ir_native_fn
+native_find(const struct psycho_ctx *const ctx,
+	    const struct psycho_ir_block *const block)
+{
+	const struct psycho_ir_native_module *const mod = ctx->ir.cfg.native;
+
+	if (!mod)
+		return NULL;
+
+	size_t lo = 0;
+	size_t hi = mod->natives_num;
+
+	while (lo < hi) {
+		const size_t mid = lo + ((hi - lo) / 2);
+
+		if (mod->natives[mid].pc < block->pc)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == mod->natives_num)
+		return NULL;
+
+	const struct psycho_ir_native *const native = &mod->natives[lo];
+
+	if ((native->pc != block->pc) ||
+	    (native->instrs_num != block->instrs_num) ||
+	    (native->ops_num != block->ops_num) ||
+	    (memcmp(native->words, block->words,
+		    block->instrs_num * sizeof(u32)) != 0))
+		return NULL;
+
+	return native->fn;
+}
+
+// Translates no more than @p instrs_max instructions into the block.
+static void translate(struct psycho_ctx *const ctx,
+		      struct psycho_ir_block *const block, const u32 pc,
+		      const u32 instrs_max)
+{
+	memset(block, 0, sizeof(*block));
+
+	block->pc = pc;
+	block->paddr = vaddr_to_paddr(pc);
+	block->valid = true;
+
+	ctx->ir.translated++;
+
+	u32 limit = region_instrs_left(block->paddr, &block->ram);
+
+	if (limit > instrs_max)
+		limit = instrs_max;
+
+	struct ir_translator tr = {
+		// clang-format off
+
+		.block		= block,
+		.tmp_next	= PSYCHO_IR_VREG_TMP_FIRST
+
+		// clang-format on
+	};
+
+	uint num = 0;
+
+	for (;;) {
+		const u32 instr_pc = pc + (num * sizeof(u32));
+		exit_set(&tr, num, instr_pc, PSYCHO_IR_EXIT_SEQ);
+
+		if (num == limit)
+			break;
+
+		const u32 instr =
+			psycho_bus_peek_word(ctx, block->paddr + (num * 4));
+
+		block->words[num] = instr;
+
+		const enum ir_instr_class class = instr_class(instr);
+
+		if ((class == IR_INSTR_UNSUPPORTED) || !room_left(&tr, 2))
+			break;
+
+		if (class == IR_INSTR_PLAIN) {
+			instr_translate(&tr, instr, instr_pc, num++);
+			continue;
+		}
+
+		// A branch is only translated along with its delay slot, which
+		// may not branch itself.
+		if ((num + 2) > limit)
+			break;
+
+		const u32 slot = psycho_bus_peek_word(
+			ctx, block->paddr + ((num + 1) * 4));
+
+		if (instr_class(slot) != IR_INSTR_PLAIN)
+			break;
+
+		instr_translate(&tr, instr, instr_pc, num++);
+
+		block->words[num] = slot;
+		exit_set(&tr, num, instr_pc + sizeof(u32), PSYCHO_IR_EXIT_SLOT);
+		instr_translate(&tr, slot, instr_pc + sizeof(u32), num++);
+
+		exit_set(&tr, num, instr_pc + (sizeof(u32) * 2),
+			 PSYCHO_IR_EXIT_BRANCH);
+		break;
+	}
+
+	block->instrs_num = num;
+
+	pass_const_fold(block);
+	pass_dead_writes(block);
+	pass_compact(block);
+
+	block->native = native_find(ctx, block);
+}
+
+void psycho_ir_translate(struct psycho_ctx *const ctx,
+			 struct psycho_ir_block *const block, const u32 pc)
+{
+	translate(ctx, block, pc, PSYCHO_IR_BLOCK_INSTRS_MAX);
+}
+
+// Only blocks starting in the BIOS proper, as the reset vector has it, are
+// translated ahead of time; the BIOS is not run from its other mirrors.
+static bool bios_pc(const u32 pc)
+{
+	return !(pc & 0x00000003) && ((pc - RESET_PC) < BIOS_SIZE);
+}
+
+static bool instr_links(const u32 instr)
+{
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_SPECIAL:
+		return instr_funct(instr) == INSTR_JALR;
+
+	case INSTR_GROUP_BCOND:
+		return (instr_rt(instr) & 0x1E) == 0x10;
+
+	case INSTR_JAL:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+static void bios_queue(struct psycho_ctx *const ctx,
+		       struct psycho_ir_block *const blocks,
+		       const size_t blocks_max, size_t *const num,
+		       u64 *const queued, const u32 pc)
+{
+	const u32 index = (pc - RESET_PC) / sizeof(u32);
+
+	if (!bios_pc(pc) || (*num == blocks_max) ||
+	    ((queued[index / 64] >> (index % 64)) & 1))
+		return;
+
+	queued[index / 64] |= UINT64_C(1) << (index % 64);
+
+	struct psycho_ir_block *const block = &blocks[(*num)++];
+
+	psycho_ir_translate(ctx, block, pc);
+	block->native = NULL;
+}
+
+static int block_pc_cmp(const void *const a, const void *const b)
+{
+	const u32 lhs = ((const struct psycho_ir_block *)a)->pc;
+	const u32 rhs = ((const struct psycho_ir_block *)b)->pc;
+
+	return (lhs > rhs) - (lhs < rhs);
+}
+
+size_t psycho_ir_bios_translate(struct psycho_ctx *const ctx,
+				struct psycho_ir_block *const blocks,
+				const size_t blocks_max)
+{
+	u64 queued[BIOS_SIZE / sizeof(u32) / 64] = { 0 };
+	size_t num = 0;
+
+	bios_queue(ctx, blocks, blocks_max, &num, queued, RESET_PC);
+
+	// Every block queues the blocks it may lead to, including the blocks
+	// after whatever it stopped short of, which the interpreter steps
+	// through; a block which never runs costs nothing but room.
+	for (size_t i = 0; i < num; ++i) {
+		const struct psycho_ir_block *const block = &blocks[i];
+		const struct psycho_ir_exit *const last =
+			&block->exits[block->instrs_num];
+
+		if (block->target_kind != PSYCHO_IR_TARGET_NONE) {
+			bios_queue(ctx, blocks, blocks_max, &num, queued,
+				   block->target);
+			bios_queue(ctx, blocks, blocks_max, &num, queued,
+				   block->target_alt);
+		}
+
+		// A call returns to just past its delay slot.
+		if (last->kind == PSYCHO_IR_EXIT_BRANCH) {
+			if (instr_links(block->words[block->instrs_num - 2]))
+				bios_queue(ctx, blocks, blocks_max, &num,
+					   queued, last->pc);
+			continue;
+		}
+
+		bios_queue(ctx, blocks, blocks_max, &num, queued, last->pc);
+
+		if (block->instrs_num == PSYCHO_IR_BLOCK_INSTRS_MAX)
+			continue;
+
+		const u32 instr = block->words[block->instrs_num];
+
+		switch (instr_class(instr)) {
+		case IR_INSTR_UNSUPPORTED:
+			bios_queue(ctx, blocks, blocks_max, &num, queued,
+				   last->pc + sizeof(u32));
+			break;
+
+		// A branch the block could not take along with its delay
+		// slot.
+		case IR_INSTR_BRANCH:
+			bios_queue(ctx, blocks, blocks_max, &num, queued,
+				   last->pc + (sizeof(u32) * 2));
+
+			if ((instr_op(instr) == INSTR_J) ||
+			    (instr_op(instr) == INSTR_JAL))
+				bios_queue(ctx, blocks, blocks_max, &num,
+					   queued,
+					   calc_jmp_addr(instr, last->pc));
+			else if (instr_op(instr) != INSTR_GROUP_SPECIAL)
+				bios_queue(ctx, blocks, blocks_max, &num,
+					   queued,
+					   calc_branch_addr(instr, last->pc));
+			break;
+
+		case IR_INSTR_PLAIN:
+		default:
+			break;
+		}
+	}
+
+	qsort(blocks, num, sizeof(*blocks), block_pc_cmp);
+	return num;
+}
+
+// Finds the block translated ahead of time for @p pc, if there is one.
+PURE_FN static const struct psycho_ir_block *
+bios_block_find(const struct psycho_ctx *const ctx, const u32 pc)
+{
+	const struct psycho_ir_bios_blocks *const bios = ctx->ir.cfg.bios;
+
+	if (!bios || !bios_pc(pc))
+		return NULL;
+
+	size_t lo = 0;
+	size_t hi = bios->blocks_num;
+
+	while (lo < hi) {
+		const size_t mid = lo + ((hi - lo) / 2);
+
+		if (bios->blocks[mid].pc < pc)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if ((lo == bios->blocks_num) || (bios->blocks[lo].pc != pc))
+		return NULL;
+
+	return &bios->blocks[lo];
+}
+
+// Blocks from RAM are only good for as long as the guest leaves their code
+// alone.
+static bool block_current(const struct psycho_ctx *const ctx,
+			  const struct psycho_ir_block *const block)
+{
+	if (!block->ram)
+		return true;
+
+	const size_t num = block->instrs_num ? block->instrs_num : 1;
+	return memcmp(&ctx->bus.ram[block->paddr], block->words,
+		      num * sizeof(u32)) == 0;
+}
+
+static const struct psycho_ir_block *block_get(struct psycho_ctx *const ctx,
+					       const u32 pc)
+{
+	struct psycho_ir_block *const block =
+		&ctx->ir.cfg.blocks[(pc / sizeof(u32)) & ctx->ir.blocks_mask];
+
+	if (block->valid && (block->pc == pc) && block_current(ctx, block))
+		return block;
+
+	const struct psycho_ir_block *const bios = bios_block_find(ctx, pc);
+
+	if (bios) {
+		*block = *bios;
+		block->native = native_find(ctx, block);
+
+		ctx->ir.bios_copied++;
+	} else
+		psycho_ir_translate(ctx, block, pc);
+
+	return block;
+}
+
+// Blocks may only start where psycho_cpu_step() could have left the CPU
+// between two instructions outside of a delay slot, with no load landing after
+// the first one, and with nothing looking on.
+static bool run_allowed(const struct psycho_ctx *const ctx)
+{
+	const struct psycho_cpu *const cpu = &ctx->cpu;
+
+	return !(cpu->pc & 0x00000003) && !cpu->next_in_branch_delay_slot &&
+	       !cpu->ld_pend.dst && !psycho_icache_isolated(ctx) &&
+	       !ctx->bios_trace.curr_func && psycho_idle_ffwd_allowed(ctx);
+}
+
+// A block never spans more than two pages, so checking its ends covers it.
+static bool code_allowed(const struct psycho_ctx *const ctx,
+			 const struct psycho_ir_block *const block)
+{
+	const u32 last = block->pc + ((block->instrs_num - 1) * sizeof(u32));
+
+	return psycho_idle_ffwd_code_allowed(ctx, block->pc, block->pc) &&
+	       psycho_idle_ffwd_code_allowed(ctx, last, last);
+}
+
+static u32 target_get(const struct psycho_ir_block *const block,
+		      const u32 *const v)
+{
+	switch (block->target_kind) {
+	case PSYCHO_IR_TARGET_CONST:
+		return block->target;
+
+	case PSYCHO_IR_TARGET_COND:
+		return v[block->target_vreg] ? block->target :
+					       block->target_alt;
+
+	case PSYCHO_IR_TARGET_VREG:
+		return v[block->target_vreg];
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+static u32 native_load_word(struct psycho_ctx *const ctx, const u32 vaddr)
+{
+	return psycho_bus_load_word(ctx, data_vaddr_to_paddr(vaddr));
+}
+
+static u16 native_load_halfword(struct psycho_ctx *const ctx, const u32 vaddr)
+{
+	return psycho_bus_load_halfword(ctx, data_vaddr_to_paddr(vaddr));
+}
+
+static u8 native_load_byte(struct psycho_ctx *const ctx, const u32 vaddr)
+{
+	return psycho_bus_load_byte(ctx, data_vaddr_to_paddr(vaddr));
+}
+
+static void native_store_word(struct psycho_ctx *const ctx, const u32 vaddr,
+			      const u32 word)
+{
+	psycho_bus_store_word(ctx, data_vaddr_to_paddr(vaddr), word);
+}
+
+static void native_store_halfword(struct psycho_ctx *const ctx,
+				  const u32 vaddr, const u16 halfword)
+{
+	psycho_bus_store_halfword(ctx, data_vaddr_to_paddr(vaddr), halfword);
+}
+
+static void native_store_byte(struct psycho_ctx *const ctx, const u32 vaddr,
+			      const u8 byte)
+{
+	psycho_bus_store_byte(ctx, data_vaddr_to_paddr(vaddr), byte);
+}
+
+CONST_FN static u32 native_paddr(const u32 vaddr)
+{
+	return data_vaddr_to_paddr(vaddr);
+}
+
+static const struct psycho_ir_native_bus ir_native_bus = {
+	// clang-format off
+
+	.load_word	= native_load_word,
+	.load_halfword	= native_load_halfword,
+	.load_byte	= native_load_byte,
+	.store_word	= native_store_word,
+	.store_halfword	= native_store_halfword,
+	.store_byte	= native_store_byte,
+	.paddr		= native_paddr
+
+	// clang-format on
+};
+
+static const struct psycho_ir_exit *ops_run(struct psycho_ctx *const ctx,
+					    const struct psycho_ir_block *block,
+					    u32 *const v)
+{
+	const struct psycho_ir_op *const end = &block->ops[block->ops_num];
+
+	for (const struct psycho_ir_op *op = block->ops; op < end; ++op) {
+		if (unlikely(!op_run(ctx, block, op, v)))
+			return &block->exits[op->dst];
+	}
+	return &block->exits[block->instrs_num];
+}
+
+// Leaves the CPU as psycho_cpu_step() would have after the instructions before
+// the exit.
+static void exit_take(struct psycho_ctx *const ctx,
+		      const struct psycho_ir_block *const block,
+		      const struct psycho_ir_exit *const exit,
+		      const u32 *const v)
+{
+	struct psycho_cpu *const cpu = &ctx->cpu;
+
+	memcpy(cpu->gpr, v, sizeof(cpu->gpr));
+	cpu->hi = v[PSYCHO_IR_VREG_HI];
+	cpu->lo = v[PSYCHO_IR_VREG_LO];
+
+	cpu->ld_next.dst = exit->ld_next_dst;
+	cpu->ld_next.val = v[exit->ld_next_vreg];
+	cpu->ld_pend.dst = exit->ld_pend_dst;
+	cpu->ld_pend.val = v[exit->ld_pend_vreg];
+
+	cpu->curr_pc = exit->pc - sizeof(u32);
+	cpu->instr = block->words[exit->instrs - 1];
+
+	switch (exit->kind) {
+	case PSYCHO_IR_EXIT_SEQ:
+		cpu->pc = exit->pc;
+		cpu->next_pc = cpu->pc + sizeof(u32);
+		cpu->in_branch_delay_slot = false;
+		cpu->next_in_branch_delay_slot = false;
+		break;
+
+	case PSYCHO_IR_EXIT_SLOT:
+		cpu->pc = exit->pc;
+		cpu->next_pc = target_get(block, v);
+		cpu->in_branch_delay_slot = false;
+		cpu->next_in_branch_delay_slot = true;
+		break;
+
+	case PSYCHO_IR_EXIT_BRANCH:
+		cpu->pc = target_get(block, v);
+		cpu->next_pc = cpu->pc + sizeof(u32);
+		cpu->in_branch_delay_slot = true;
+		cpu->next_in_branch_delay_slot = false;
+		break;
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+static const struct psycho_ir_exit *
+block_exec(struct psycho_ctx *const ctx,
+	   const struct psycho_ir_block *const block, u32 *const v)
+{
+	const struct psycho_ir_exit *exit;
+
+	if (block->native) {
+		exit = &block->exits[block->native(ctx, &ir_native_bus, v)];
+		ctx->ir.native_run++;
+	} else
+		exit = ops_run(ctx, block, v);
+
+	if (exit != &block->exits[block->instrs_num])
+		ctx->ir.side_exits++;
+
+	return exit;
+}
+
+// Returns the block to run from @p pc with @p budget instructions left, or
+// NULL if the interpreter has to step through the next instruction instead.
+static const struct psycho_ir_block *block_next(struct psycho_ctx *const ctx,
+						const u32 pc, const u64 budget)
+{
+	bool ram;
+
+	if (!region_instrs_left(vaddr_to_paddr(pc), &ram))
+		return NULL;
+
+	const struct psycho_ir_block *const block = block_get(ctx, pc);
+
+	if (!block->instrs_num || (block->instrs_num > budget) ||
+	    !code_allowed(ctx, block))
+		return NULL;
+
+	return block;
+}
+
+// Returns the block to run straight after @p block was left through @p exit,
+// with the registers still in @p v, or NULL if the CPU state has to be written
+// back first. That is the case after a side exit and while a load is in
+// flight, and whenever the next block would be translated into the entry of
+// the one just left, which the state is still to be written back from.
+static const struct psycho_ir_block *
+block_chain(struct psycho_ctx *const ctx,
+	    const struct psycho_ir_block *const block,
+	    const struct psycho_ir_exit *const exit, const u32 *const v,
+	    const u64 budget)
+{
+	if ((exit != &block->exits[block->instrs_num]) || exit->ld_next_dst ||
+	    exit->ld_pend_dst)
+		return NULL;
+
+	const u32 pc = (exit->kind == PSYCHO_IR_EXIT_BRANCH) ?
+			       target_get(block, v) :
+			       exit->pc;
+
+	if (pc & 0x00000003)
+		return NULL;
+
+	const struct psycho_ir_block *const entry =
+		&ctx->ir.cfg.blocks[(pc / sizeof(u32)) & ctx->ir.blocks_mask];
+
+	if ((entry == block) &&
+	    ((block->pc != pc) || !block_current(ctx, block)))
+		return NULL;
+
+	return block_next(ctx, pc, budget);
+}
+
+// Runs @p block and, if @p chain is set, as many blocks after it as
+// block_chain() allows, keeping the registers in a local copy throughout.
+static u64 blocks_run(struct psycho_ctx *const ctx,
+		      const struct psycho_ir_block *block, const u64 budget,
+		      const bool chain)
+{
+	struct psycho_cpu *const cpu = &ctx->cpu;
+	u32 v[PSYCHO_IR_VREG_NUM];
+
+	memcpy(v, cpu->gpr, sizeof(cpu->gpr));
+	v[PSYCHO_IR_VREG_HI] = cpu->hi;
+	v[PSYCHO_IR_VREG_LO] = cpu->lo;
+
+	// The load issued by the last instruction stepped through lands before
+	// the first instruction of the block.
+	v[cpu->ld_next.dst] = cpu->ld_next.val;
+	v[0] = 0;
+
+	const struct psycho_ir_block *last = NULL;
+	const struct psycho_ir_exit *last_exit = NULL;
+	u64 ran = 0;
+
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_CPU);
+
+	do {
+		const struct psycho_ir_exit *const exit =
+			block_exec(ctx, block, v);
+
+		// Nothing has happened yet if the first instruction would trap;
+		// its guards come before anything it writes.
+		if (!exit->instrs)
+			break;
+
+		last = block;
+		last_exit = exit;
+		ran += exit->instrs;
+
+		ctx->ir.blocks_run++;
+		ctx->ir.instrs_run += exit->instrs;
+
+		block = chain ? block_chain(ctx, block, exit, v, budget - ran) :
+				NULL;
+	} while (block);
+
+	if (last)
+		exit_take(ctx, last, last_exit, v);
+
+	psycho_timer_end(ctx);
+	return ran;
+}
+
+void psycho_ir_enable(struct psycho_ctx *const ctx,
+		      const struct psycho_ir_cfg *const cfg)
+{
+	memset(&ctx->ir, 0, sizeof(ctx->ir));
+
+	if (!cfg)
+		return;
+
+	ctx->ir.cfg = *cfg;
+	ctx->ir.blocks_mask = cfg->blocks_num - 1;
+	ctx->ir.enable = true;
+
+	memset(cfg->blocks, 0, cfg->blocks_num * sizeof(*cfg->blocks));
+}
+
+// Finds the first block to run, if the CPU is anywhere a block may start.
+static const struct psycho_ir_block *block_first(struct psycho_ctx *const ctx,
+						 const u64 budget)
+{
+	if (!ctx->ir.enable || !run_allowed(ctx))
+		return NULL;
+
+	return block_next(ctx, ctx->cpu.pc, budget);
+}
+
+u64 psycho_ir_step(struct psycho_ctx *const ctx, const u64 budget)
+{
+	const struct psycho_ir_block *const block = block_first(ctx, budget);
+	return block ? blocks_run(ctx, block, budget, false) : 0;
+}
+
+u64 psycho_ir_chain(struct psycho_ctx *const ctx, const u64 budget)
+{
+	const struct psycho_ir_block *const block = block_first(ctx, budget);
+	return block ? blocks_run(ctx, block, budget, true) : 0;
+}
+
+u64 psycho_ir_step_uncached(struct psycho_ctx *const ctx,
+			    struct psycho_ir_block *const block,
+			    const u64 budget)
+{
+	bool ram;
+
+	if (!ctx->ir.enable || !run_allowed(ctx) ||
+	    !region_instrs_left(vaddr_to_paddr(ctx->cpu.pc), &ram))
+		return 0;
+
+	translate(ctx, block, ctx->cpu.pc,
+		  (budget < PSYCHO_IR_BLOCK_INSTRS_MAX) ?
+			  (u32)budget :
+			  PSYCHO_IR_BLOCK_INSTRS_MAX);
+
+	if (!block->instrs_num || !code_allowed(ctx, block))
+		return 0;
+
+	return blocks_run(ctx, block, budget, false);
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "core/compiler.h"
+#include "core/ctx.h"
+#include "core/ir.h"
+
+/**
+ * Executes blocks one after another, no more than @p budget instructions of
+ * them, for as long as each leaves the CPU where the next may start; returns
+ * the number of instructions executed. Unlike psycho_ir_step(), the CPU state
+ * is only written back once the last block has been left.
+ */
+u64 psycho_ir_chain(struct psycho_ctx *ctx, u64 budget);
+
+/**
+ * Executes blocks in place of the next steps of psycho_run(), with @p budget
+ * instructions left to run; returns the number of instructions executed.
+ */
+ALWAYS_INLINE u64 psycho_ir_on_run_step(struct psycho_ctx *const ctx,
+					const u64 budget)
+{
+	if (ctx->ir.enable)
+		return psycho_ir_chain(ctx, budget);
+
+	return 0;
+}
@@ -0,0 +1,1099 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "core/lanes.h"
+
+#include "bios-trace.h"
+#include "bus.h"
+#include "cpu-defs.h"
+#include "hooks.h"
+#include "icache.h"
+#include "idle.h"
+#include "util.h"
+
+// Every register of the pack is one vector holding all of its lanes. The
+// compiler lowers the operations onto whatever vector unit the host has, and
+// the step is built for each of the ones worth having.
+typedef u32 lanes_vec
+	__attribute__((vector_size(PSYCHO_LANES_MAX * sizeof(u32)),
+		       may_alias));
+typedef s32 lanes_svec
+	__attribute__((vector_size(PSYCHO_LANES_MAX * sizeof(s32)),
+		       may_alias));
+typedef u64 lanes_wide
+	__attribute__((vector_size(PSYCHO_LANES_MAX * sizeof(u64))));
+typedef s64 lanes_swide
+	__attribute__((vector_size(PSYCHO_LANES_MAX * sizeof(s64))));
+
+// Nothing taking or returning a vector leaves this file, so which registers
+// they would be passed in is of no concern.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// The step is flattened so that each of its versions has the whole of the
+// instruction in it, built for that vector unit.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define LANES_TARGETS                                                      \
+	__attribute__((target_clones("avx512f", "avx2", "default"), flatten))
+#else
+#define LANES_TARGETS __attribute__((flatten))
+#endif
+
+ALWAYS_INLINE lanes_vec *vec(u32 *const lanes)
+{
+	return (lanes_vec *)(void *)lanes;
+}
+
+ALWAYS_INLINE u32 lanes_all(const struct psycho_lanes *const lanes)
+{
+	return (u32)((UINT64_C(1) << lanes->lanes_num) - 1);
+}
+
+// The lanes of @p mask set in @p cond.
+ALWAYS_INLINE u32 cond_lanes(const lanes_svec cond, const u32 mask)
+{
+	u32 res = 0;
+
+	for (uint i = 0; i < PSYCHO_LANES_MAX; ++i)
+		res |= (u32)(cond[i] & 1) << i;
+
+	return res & mask;
+}
+
+// The smaller of the lanes of @p mask in @p set and those which are not; the
+// lanes to take out of the pack so that the rest do the same thing.
+ALWAYS_INLINE u32 minority(const u32 set, const u32 mask)
+{
+	const uint set_num = __builtin_popcount(set & mask);
+
+	if ((set_num * 2) >= (uint)__builtin_popcount(mask))
+		return mask & ~set;
+
+	return set & mask;
+}
+
+// Whatever observes individual instructions, or takes the debug variant of
+// the step, keeps a lane out of the pack.
+static bool lane_ok(const struct psycho_ctx *const ctx)
+{
+	return !psycho_icache_isolated(ctx) && !ctx->bios_trace.curr_func &&
+	       psycho_idle_ffwd_allowed(ctx);
+}
+
+// The instruction a lane has at @p paddr, which lies in RAM or, if @p in_bios,
+// in the BIOS; read straight from memory, as the fetch window does.
+ALWAYS_INLINE u32 lane_code(const struct psycho_ctx *const ctx, const u32 paddr,
+			    const bool in_bios)
+{
+	const u8 *const mem = in_bios ?
+				      &ctx->bus.bios[paddr - BIOS_ADDR_START] :
+				      &ctx->bus.ram[paddr];
+	u32 word;
+
+	memcpy(&word, mem, sizeof(word));
+	return word;
+}
+
+ALWAYS_INLINE bool lane_code_ok(const struct psycho_ctx *const ctx,
+				const u32 pc)
+{
+	const uint page = psycho_hooks_page(pc);
+	return !((ctx->hooks.pages[page / 64] >> (page % 64)) & 1);
+}
+
+// Whether a lane is at the same point as the pack, and so may join it.
+static bool lane_at_pack(const struct psycho_lanes *const lanes,
+			 const struct psycho_cpu *const cpu)
+{
+	return (cpu->pc == lanes->pc) && (cpu->next_pc == lanes->next_pc) &&
+	       (cpu->ld_next.dst == lanes->ld_next_dst) &&
+	       (cpu->ld_pend.dst == lanes->ld_pend_dst) &&
+	       (cpu->in_branch_delay_slot == lanes->in_branch_delay_slot) &&
+	       (cpu->next_in_branch_delay_slot ==
+		lanes->next_in_branch_delay_slot);
+}
+
+static void pack_start(struct psycho_lanes *const lanes,
+		       const struct psycho_cpu *const cpu)
+{
+	lanes->curr_pc = cpu->curr_pc;
+	lanes->pc = cpu->pc;
+	lanes->next_pc = cpu->next_pc;
+	lanes->instr = cpu->instr;
+	lanes->ld_next_dst = cpu->ld_next.dst;
+	lanes->ld_pend_dst = cpu->ld_pend.dst;
+	lanes->in_branch_delay_slot = cpu->in_branch_delay_slot;
+	lanes->next_in_branch_delay_slot = cpu->next_in_branch_delay_slot;
+	lanes->diverged = 0;
+	lanes->deadline = UINT64_MAX;
+}
+
+static void lane_pack(struct psycho_lanes *const lanes, const uint lane)
+{
+	const struct psycho_cpu *const cpu = &lanes->ctx[lane]->cpu;
+
+	for (uint i = 0; i < CPU_GPR_NUM; ++i)
+		lanes->gpr[i][lane] = cpu->gpr[i];
+
+	lanes->hi[lane] = cpu->hi;
+	lanes->lo[lane] = cpu->lo;
+	lanes->ld_next_val[lane] = cpu->ld_next.val;
+	lanes->ld_pend_val[lane] = cpu->ld_pend.val;
+
+	lanes->left[lane] += lanes->clock;
+
+	if (lanes->left[lane] < lanes->deadline)
+		lanes->deadline = lanes->left[lane];
+
+	lanes->packed |= 1U << lane;
+	lanes->fresh &= ~(1U << lane);
+	lanes->merges++;
+}
+
+static void lane_unpack(struct psycho_lanes *const lanes, const uint lane)
+{
+	struct psycho_cpu *const cpu = &lanes->ctx[lane]->cpu;
+
+	for (uint i = 0; i < CPU_GPR_NUM; ++i)
+		cpu->gpr[i] = lanes->gpr[i][lane];
+
+	cpu->hi = lanes->hi[lane];
+	cpu->lo = lanes->lo[lane];
+	cpu->pc = lanes->pc;
+	cpu->next_pc = lanes->next_pc;
+	cpu->ld_next.dst = lanes->ld_next_dst;
+	cpu->ld_next.val = lanes->ld_next_val[lane];
+	cpu->ld_pend.dst = lanes->ld_pend_dst;
+	cpu->ld_pend.val = lanes->ld_pend_val[lane];
+	cpu->in_branch_delay_slot = lanes->in_branch_delay_slot;
+	cpu->next_in_branch_delay_slot = lanes->next_in_branch_delay_slot;
+
+	if (lanes->fresh & (1U << lane)) {
+		cpu->curr_pc = lanes->curr_pc;
+		cpu->instr = lanes->instr;
+	}
+
+	// A lane which branched the other way than the pack is yet to go
+	// there, or has just executed the delay slot on the way.
+	if (lanes->diverged & (1U << lane)) {
+		if (lanes->next_in_branch_delay_slot) {
+			cpu->next_pc = lanes->diverged_pc;
+		} else {
+			cpu->pc = lanes->diverged_pc;
+			cpu->next_pc = cpu->pc + sizeof(u32);
+		}
+		lanes->diverged &= ~(1U << lane);
+	}
+	lanes->left[lane] -= lanes->clock;
+	lanes->packed &= ~(1U << lane);
+}
+
+static void lanes_split(struct psycho_lanes *const lanes, const u32 mask)
+{
+	for (u32 left = mask & lanes->packed; left; left &= left - 1) {
+		lane_unpack(lanes, __builtin_ctz(left));
+		lanes->splits++;
+	}
+}
+
+// Takes the lanes which have executed all of their instructions out of the
+// pack. The deadline may be that of a lane which has since left, so it is
+// worked out again from the lanes still there.
+static void lanes_expire(struct psycho_lanes *const lanes)
+{
+	lanes->deadline = UINT64_MAX;
+
+	for (u32 rest = lanes->packed; rest; rest &= rest - 1) {
+		const uint lane = __builtin_ctz(rest);
+
+		if (lanes->left[lane] == lanes->clock) {
+			lane_unpack(lanes, lane);
+			lanes->stopped |= 1U << lane;
+		} else if (lanes->left[lane] < lanes->deadline) {
+			lanes->deadline = lanes->left[lane];
+		}
+	}
+}
+
+// The lowest PC of the pack and the loose lanes.
+static u32 lanes_min_pc(const struct psycho_lanes *const lanes,
+			const u32 loose)
+{
+	u32 pc = lanes->packed ? lanes->pc : UINT32_MAX;
+
+	for (u32 rest = loose; rest; rest &= rest - 1) {
+		const struct psycho_ctx *const ctx =
+			lanes->ctx[__builtin_ctz(rest)];
+
+		if (ctx->cpu.pc < pc)
+			pc = ctx->cpu.pc;
+	}
+	return pc;
+}
+
+// Packs every loose lane which is at the same point as the pack. Without a
+// pack, one is started from the lanes at the same point as one of them, taken
+// in turn; a pack of a single lane would only slow it down.
+static void lanes_merge(struct psycho_lanes *const lanes)
+{
+	const u32 loose = lanes_all(lanes) & ~lanes->packed & ~lanes->stopped;
+
+	if (!loose)
+		return;
+
+	if (!lanes->packed) {
+		uint leader = lanes->lanes_num;
+
+		for (uint i = 0; i < lanes->lanes_num; ++i) {
+			const uint lane = (lanes->next_leader + i) %
+					  lanes->lanes_num;
+
+			if ((loose & (1U << lane)) &&
+			    lane_ok(lanes->ctx[lane])) {
+				leader = lane;
+				break;
+			}
+		}
+
+		if (leader == lanes->lanes_num)
+			return;
+
+		lanes->next_leader = (leader + 1) % lanes->lanes_num;
+		pack_start(lanes, &lanes->ctx[leader]->cpu);
+
+		uint num = 0;
+
+		for (u32 left = loose; left; left &= left - 1) {
+			const uint lane = __builtin_ctz(left);
+			num += lane_at_pack(lanes, &lanes->ctx[lane]->cpu);
+		}
+
+		if (num < 2)
+			return;
+	}
+
+	for (u32 left = loose; left; left &= left - 1) {
+		const uint lane = __builtin_ctz(left);
+		const struct psycho_ctx *const ctx = lanes->ctx[lane];
+
+		if (lane_at_pack(lanes, &ctx->cpu) && lane_ok(ctx))
+			lane_pack(lanes, lane);
+	}
+}
+
+// The value a register will have once the pending load has landed, which is
+// what the instruction about to be executed sees.
+ALWAYS_INLINE lanes_vec src(struct psycho_lanes *const lanes, const uint reg)
+{
+	if (reg == lanes->ld_next_dst)
+		return *vec(lanes->ld_next_val);
+
+	return *vec(lanes->gpr[reg]);
+}
+
+ALWAYS_INLINE lanes_vec splat(const u32 val)
+{
+	return (lanes_vec){ 0 } + val;
+}
+
+ALWAYS_INLINE void gpr_set(struct psycho_lanes *const lanes, const uint reg,
+			   const lanes_vec val)
+{
+	if (lanes->ld_next_dst == reg) {
+		lanes->ld_next_dst = 0;
+		*vec(lanes->ld_next_val) = splat(0);
+	}
+	*vec(lanes->gpr[reg]) = val;
+}
+
+ALWAYS_INLINE void gpr_set_delayed(struct psycho_lanes *const lanes,
+				   const uint reg, const lanes_vec val)
+{
+	lanes->ld_pend_dst = reg;
+	*vec(lanes->ld_pend_val) = val;
+
+	if (lanes->ld_next_dst == reg) {
+		lanes->ld_next_dst = 0;
+		*vec(lanes->ld_next_val) = splat(0);
+	}
+}
+
+ALWAYS_INLINE void jmp(struct psycho_lanes *const lanes, const u32 target)
+{
+	lanes->next_in_branch_delay_slot = true;
+	lanes->next_pc = target;
+}
+
+// Sends the pack the way most of its lanes branch. The others stay for the
+// delay slot, which they execute all the same, and only then leave the pack.
+ALWAYS_INLINE void branch(struct psycho_lanes *const lanes, const u32 instr,
+			  const lanes_svec cond, const u32 mask)
+{
+	const u32 taken = cond_lanes(cond, mask);
+	const u32 target = calc_branch_addr(instr, lanes->curr_pc);
+
+	lanes->next_in_branch_delay_slot = true;
+	lanes->diverged = minority(taken, mask);
+
+	if (taken & ~lanes->diverged) {
+		lanes->diverged_pc = lanes->next_pc;
+		lanes->next_pc = target;
+	} else {
+		lanes->diverged_pc = target;
+	}
+}
+
+// The lanes of @p mask whose access of @p size bytes at @p base + @p off
+// either leaves RAM and the scratchpad, or traps on alignment.
+ALWAYS_INLINE u32 mem_bad(const lanes_vec base, const u32 off,
+			  const uint size, const u32 mask)
+{
+	u32 bad = 0;
+
+	for (u32 left = mask; left; left &= left - 1) {
+		const uint lane = __builtin_ctz(left);
+		const u32 paddr = data_vaddr_to_paddr(base[lane] + off);
+
+		if (((paddr >= RAM_SIZE) &&
+		     ((paddr - SCRATCHPAD_ADDR_START) >= SCRATCHPAD_SIZE)) ||
+		    (paddr & (size - 1)))
+			bad |= 1U << lane;
+	}
+	return bad;
+}
+
+ALWAYS_INLINE u32 add_overflows(const lanes_vec a, const lanes_vec b,
+				const u32 mask)
+{
+	const lanes_vec sum = a + b;
+	return cond_lanes((lanes_svec)((a ^ sum) & (b ^ sum)) < 0, mask);
+}
+
+ALWAYS_INLINE u32 sub_overflows(const lanes_vec a, const lanes_vec b,
+				const u32 mask)
+{
+	const lanes_vec diff = a - b;
+	return cond_lanes((lanes_svec)((a ^ b) & (a ^ diff)) < 0, mask);
+}
+
+// The lanes which cannot execute @p instr along with the rest of the pack:
+// those which would trap, access anything but RAM and the scratchpad or go
+// elsewhere, or the whole pack if only the interpreter knows the instruction
+// or it sits in a delay slot. Nothing has been changed yet.
+static u32 step_check(struct psycho_lanes *const lanes, const u32 instr,
+		      const u32 mask)
+{
+	const uint rs = instr_rs(instr);
+	const uint rt = instr_rt(instr);
+	const lanes_vec a = src(lanes, rs);
+	const lanes_vec b = src(lanes, rt);
+	const u32 simm = sign_ext_16_32(instr_imm(instr));
+
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_SPECIAL:
+		switch (instr_funct(instr)) {
+		case INSTR_SLL:
+		case INSTR_SRL:
+		case INSTR_SRA:
+		case INSTR_SLLV:
+		case INSTR_SRLV:
+		case INSTR_SRAV:
+		case INSTR_MFHI:
+		case INSTR_MTHI:
+		case INSTR_MFLO:
+		case INSTR_MTLO:
+		case INSTR_MULT:
+		case INSTR_MULTU:
+		case INSTR_DIV:
+		case INSTR_DIVU:
+		case INSTR_ADDU:
+		case INSTR_SUBU:
+		case INSTR_AND:
+		case INSTR_OR:
+		case INSTR_XOR:
+		case INSTR_NOR:
+		case INSTR_SLT:
+		case INSTR_SLTU:
+			return 0;
+
+		case INSTR_JR:
+		case INSTR_JALR: {
+			if (lanes->next_in_branch_delay_slot)
+				return mask;
+
+			// A misaligned JALR traps right away, and a JR one step
+			// later.
+			const u32 target = a[__builtin_ctz(mask)];
+
+			if ((instr_funct(instr) == INSTR_JALR) &&
+			    (target & 0x00000003))
+				return mask;
+
+			return cond_lanes(a != target, mask);
+		}
+
+		case INSTR_ADD:
+			return add_overflows(a, b, mask);
+
+		case INSTR_SUB:
+			return sub_overflows(a, b, mask);
+
+		default:
+			return mask;
+		}
+
+	// Lanes which branch the other way stay for the delay slot; see
+	// branch().
+	case INSTR_GROUP_BCOND:
+		return lanes->next_in_branch_delay_slot ? mask : 0;
+
+	case INSTR_GROUP_COP0:
+		return (instr_rs(instr) == INSTR_COP_MF) ? 0 : mask;
+
+	case INSTR_J:
+	case INSTR_JAL:
+		return lanes->next_in_branch_delay_slot ? mask : 0;
+
+	case INSTR_BEQ:
+	case INSTR_BNE:
+	case INSTR_BLEZ:
+	case INSTR_BGTZ:
+		return lanes->next_in_branch_delay_slot ? mask : 0;
+
+	case INSTR_ADDI:
+		return add_overflows(a, splat(simm), mask);
+
+	case INSTR_ADDIU:
+	case INSTR_SLTI:
+	case INSTR_SLTIU:
+	case INSTR_ANDI:
+	case INSTR_ORI:
+	case INSTR_XORI:
+	case INSTR_LUI:
+		return 0;
+
+	// A load into $zero is rejected with a warning, which only the
+	// interpreter gives.
+	case INSTR_LB:
+	case INSTR_LBU:
+		return rt ? mem_bad(a, simm, sizeof(u8), mask) : mask;
+
+	case INSTR_LH:
+	case INSTR_LHU:
+		return rt ? mem_bad(a, simm, sizeof(u16), mask) : mask;
+
+	case INSTR_LW:
+		return rt ? mem_bad(a, simm, sizeof(u32), mask) : mask;
+
+	case INSTR_LWL:
+	case INSTR_LWR:
+		return rt ? mem_bad(a, simm, sizeof(u8), mask) : mask;
+
+	case INSTR_SB:
+		return mem_bad(a, simm, sizeof(u8), mask);
+
+	case INSTR_SH:
+		return mem_bad(a, simm, sizeof(u16), mask);
+
+	case INSTR_SW:
+		return mem_bad(a, simm, sizeof(u32), mask);
+
+	case INSTR_SWL:
+	case INSTR_SWR:
+		return mem_bad(a, simm, sizeof(u8), mask);
+
+	default:
+		return mask;
+	}
+}
+
+// Loads are made lane by lane; there is nothing to gain from gathers when each
+// lane has memory of its own.
+ALWAYS_INLINE lanes_vec load(struct psycho_lanes *const lanes,
+			     const lanes_vec base, const u32 off,
+			     const uint size, const u32 mask)
+{
+	lanes_vec val = { 0 };
+
+	for (u32 left = mask; left; left &= left - 1) {
+		const uint lane = __builtin_ctz(left);
+		struct psycho_ctx *const ctx = lanes->ctx[lane];
+		const u32 paddr = data_vaddr_to_paddr(base[lane] + off);
+
+		switch (size) {
+		case sizeof(u8):
+			val[lane] = psycho_bus_load_byte(ctx, paddr);
+			break;
+
+		case sizeof(u16):
+			val[lane] = psycho_bus_load_halfword(ctx, paddr);
+			break;
+
+		default:
+			val[lane] = psycho_bus_load_word(ctx, paddr);
+			break;
+		}
+	}
+	return val;
+}
+
+ALWAYS_INLINE void store(struct psycho_lanes *const lanes,
+			 const lanes_vec base, const u32 off, const uint size,
+			 const lanes_vec val, const u32 mask)
+{
+	for (u32 left = mask; left; left &= left - 1) {
+		const uint lane = __builtin_ctz(left);
+		struct psycho_ctx *const ctx = lanes->ctx[lane];
+		const u32 paddr = data_vaddr_to_paddr(base[lane] + off);
+
+		switch (size) {
+		case sizeof(u8):
+			psycho_bus_store_byte(ctx, paddr,
+					      val[lane] & UINT8_MAX);
+			break;
+
+		case sizeof(u16):
+			psycho_bus_store_halfword(ctx, paddr,
+						  val[lane] & UINT16_MAX);
+			break;
+
+		default:
+			psycho_bus_store_word(ctx, paddr, val[lane]);
+			break;
+		}
+	}
+}
+
+// LWL and LWR merge into the value the register is about to receive, if a
+// load is about to land in it.
+ALWAYS_INLINE lanes_vec load_merge_base(struct psycho_lanes *const lanes,
+					const uint reg)
+{
+	if (reg == lanes->ld_next_dst)
+		return *vec(lanes->ld_next_val);
+
+	return *vec(lanes->gpr[reg]);
+}
+
+static void lwl_lwr(struct psycho_lanes *const lanes, const u32 instr,
+		    const lanes_vec a, const u32 mask)
+{
+	const uint rt = instr_rt(instr);
+	const u32 simm = sign_ext_16_32(instr_imm(instr));
+	const lanes_vec old = load_merge_base(lanes, rt);
+	lanes_vec res = old;
+
+	for (u32 left = mask; left; left &= left - 1) {
+		const uint lane = __builtin_ctz(left);
+		const u32 paddr = data_vaddr_to_paddr(a[lane] + simm);
+		const u32 word =
+			psycho_bus_load_word(lanes->ctx[lane], paddr & ~3U);
+		const uint shift = (paddr & 3) * 8;
+
+		if (instr_op(instr) == INSTR_LWL)
+			res[lane] = (old[lane] & (0x00FFFFFF >> shift)) |
+				    (word << (24 - shift));
+		else
+			res[lane] = (old[lane] & (0xFFFFFF00 << (24 - shift))) |
+				    (word >> shift);
+	}
+	gpr_set_delayed(lanes, rt, res);
+}
+
+static void swl_swr(struct psycho_lanes *const lanes, const u32 instr,
+		    const lanes_vec a, const lanes_vec b, const u32 mask)
+{
+	const u32 simm = sign_ext_16_32(instr_imm(instr));
+
+	for (u32 left = mask; left; left &= left - 1) {
+		const uint lane = __builtin_ctz(left);
+		struct psycho_ctx *const ctx = lanes->ctx[lane];
+		const u32 paddr = data_vaddr_to_paddr(a[lane] + simm);
+		const uint shift = (paddr & 3) * 8;
+
+		u32 word = psycho_bus_load_word(ctx, paddr & ~3U);
+
+		if (instr_op(instr) == INSTR_SWL)
+			word = (word & (0xFFFFFF00 << shift)) |
+			       (b[lane] >> (24 - shift));
+		else
+			word = (word & (0x00FFFFFF >> (24 - shift))) |
+			       (b[lane] << shift);
+
+		psycho_bus_store_word(ctx, paddr & ~3U, word);
+	}
+}
+
+static void div_lanes(struct psycho_lanes *const lanes, const lanes_vec a,
+		      const lanes_vec b, const bool sign, const u32 mask)
+{
+	for (u32 left = mask; left; left &= left - 1) {
+		const uint lane = __builtin_ctz(left);
+		const u32 n = a[lane];
+		const u32 d = b[lane];
+
+		if (!d) {
+			lanes->lo[lane] = (sign && ((s32)n < 0)) ? 0x00000001 :
+								   UINT32_MAX;
+			lanes->hi[lane] = n;
+		} else if (sign && (n == 0x80000000) && (d == UINT32_MAX)) {
+			lanes->lo[lane] = n;
+			lanes->hi[lane] = 0x00000000;
+		} else if (sign) {
+			lanes->lo[lane] = (s32)n / (s32)d;
+			lanes->hi[lane] = (s32)n % (s32)d;
+		} else {
+			lanes->lo[lane] = n / d;
+			lanes->hi[lane] = n % d;
+		}
+	}
+}
+
+static void mult(struct psycho_lanes *const lanes, const lanes_vec a,
+		 const lanes_vec b, const bool sign)
+{
+	lanes_wide prod;
+
+	if (sign)
+		prod = (lanes_wide)(__builtin_convertvector((lanes_svec)a,
+							    lanes_swide) *
+				    __builtin_convertvector((lanes_svec)b,
+							    lanes_swide));
+	else
+		prod = __builtin_convertvector(a, lanes_wide) *
+		       __builtin_convertvector(b, lanes_wide);
+
+	*vec(lanes->lo) = __builtin_convertvector(prod, lanes_vec);
+	*vec(lanes->hi) = __builtin_convertvector(prod >> 32, lanes_vec);
+}
+
+// Executes @p instr for every lane of @p mask, which step_check() has found
+// to all do the same thing.
+static void step_exec(struct psycho_lanes *const lanes, const u32 instr,
+		      const u32 mask)
+{
+	const uint rs = instr_rs(instr);
+	const uint rt = instr_rt(instr);
+	const uint rd = instr_rd(instr);
+	const uint shamt = instr_shamt(instr);
+	const u32 imm = instr_imm(instr);
+	const u32 simm = sign_ext_16_32(imm);
+	const lanes_vec a = *vec(lanes->gpr[rs]);
+	const lanes_vec b = *vec(lanes->gpr[rt]);
+	const uint leader = __builtin_ctz(mask);
+	const u32 link = lanes->curr_pc + (sizeof(u32) * 2);
+
+	switch (instr_op(instr)) {
+	case INSTR_GROUP_SPECIAL:
+		switch (instr_funct(instr)) {
+		case INSTR_SLL:
+			gpr_set(lanes, rd, b << shamt);
+			break;
+
+		case INSTR_SRL:
+			gpr_set(lanes, rd, b >> shamt);
+			break;
+
+		case INSTR_SRA:
+			gpr_set(lanes, rd, (lanes_vec)((lanes_svec)b >> shamt));
+			break;
+
+		case INSTR_SLLV:
+			gpr_set(lanes, rd, b << (a & 0x0000001F));
+			break;
+
+		case INSTR_SRLV:
+			gpr_set(lanes, rd, b >> (a & 0x0000001F));
+			break;
+
+		case INSTR_SRAV:
+			gpr_set(lanes, rd,
+				(lanes_vec)((lanes_svec)b >>
+					    (lanes_svec)(a & 0x0000001F)));
+			break;
+
+		case INSTR_JR:
+			jmp(lanes, a[leader]);
+			break;
+
+		case INSTR_JALR:
+			gpr_set(lanes, rd, splat(link));
+			jmp(lanes, a[leader]);
+			break;
+
+		case INSTR_MFHI:
+			gpr_set(lanes, rd, *vec(lanes->hi));
+			break;
+
+		case INSTR_MTHI:
+			*vec(lanes->hi) = a;
+			break;
+
+		case INSTR_MFLO:
+			gpr_set(lanes, rd, *vec(lanes->lo));
+			break;
+
+		case INSTR_MTLO:
+			*vec(lanes->lo) = a;
+			break;
+
+		case INSTR_MULT:
+			mult(lanes, a, b, true);
+			break;
+
+		case INSTR_MULTU:
+			mult(lanes, a, b, false);
+			break;
+
+		case INSTR_DIV:
+			div_lanes(lanes, a, b, true, mask);
+			break;
+
+		case INSTR_DIVU:
+			div_lanes(lanes, a, b, false, mask);
+			break;
+
+		case INSTR_ADD:
+		case INSTR_ADDU:
+			gpr_set(lanes, rd, a + b);
+			break;
+
+		case INSTR_SUB:
+		case INSTR_SUBU:
+			gpr_set(lanes, rd, a - b);
+			break;
+
+		case INSTR_AND:
+			gpr_set(lanes, rd, a & b);
+			break;
+
+		case INSTR_OR:
+			gpr_set(lanes, rd, a | b);
+			break;
+
+		case INSTR_XOR:
+			gpr_set(lanes, rd, a ^ b);
+			break;
+
+		case INSTR_NOR:
+			gpr_set(lanes, rd, ~(a | b));
+			break;
+
+		case INSTR_SLT:
+			gpr_set(lanes, rd,
+				(lanes_vec)-((lanes_svec)a < (lanes_svec)b));
+			break;
+
+		case INSTR_SLTU:
+			gpr_set(lanes, rd, (lanes_vec)-(a < b));
+			break;
+
+		default:
+			UNREACHABLE;
+		}
+		break;
+
+	case INSTR_GROUP_BCOND:
+		if ((rt & 0x1E) == 0x10)
+			gpr_set(lanes, CPU_GPR_RA, splat(link));
+
+		branch(lanes, instr, (lanes_svec)(a ^ (rt << 31)) < 0, mask);
+		break;
+
+	case INSTR_GROUP_COP0: {
+		lanes_vec val = { 0 };
+
+		for (u32 left = mask; left; left &= left - 1) {
+			const uint lane = __builtin_ctz(left);
+			val[lane] = lanes->ctx[lane]->cpu.cop0[rd];
+		}
+		gpr_set(lanes, rt, val);
+		break;
+	}
+
+	case INSTR_J:
+		jmp(lanes, calc_jmp_addr(instr, lanes->curr_pc));
+		break;
+
+	case INSTR_JAL:
+		gpr_set(lanes, CPU_GPR_RA, splat(link));
+		jmp(lanes, calc_jmp_addr(instr, lanes->curr_pc));
+		break;
+
+	case INSTR_BEQ:
+		branch(lanes, instr, a == b, mask);
+		break;
+
+	case INSTR_BNE:
+		branch(lanes, instr, a != b, mask);
+		break;
+
+	case INSTR_BLEZ:
+		branch(lanes, instr, (lanes_svec)a <= 0, mask);
+		break;
+
+	case INSTR_BGTZ:
+		branch(lanes, instr, (lanes_svec)a > 0, mask);
+		break;
+
+	case INSTR_ADDI:
+	case INSTR_ADDIU:
+		gpr_set(lanes, rt, a + simm);
+		break;
+
+	case INSTR_SLTI:
+		gpr_set(lanes, rt, (lanes_vec)-((lanes_svec)a < (s32)simm));
+		break;
+
+	case INSTR_SLTIU:
+		gpr_set(lanes, rt, (lanes_vec)-(a < simm));
+		break;
+
+	case INSTR_ANDI:
+		gpr_set(lanes, rt, a & imm);
+		break;
+
+	case INSTR_ORI:
+		gpr_set(lanes, rt, a | imm);
+		break;
+
+	case INSTR_XORI:
+		gpr_set(lanes, rt, a ^ imm);
+		break;
+
+	case INSTR_LUI:
+		gpr_set(lanes, rt, splat(imm << 16));
+		break;
+
+	case INSTR_LB:
+		gpr_set_delayed(lanes, rt,
+				(lanes_vec)((lanes_svec)(load(lanes, a, simm,
+							      sizeof(u8),
+							      mask)
+							 << 24) >>
+					    24));
+		break;
+
+	case INSTR_LBU:
+		gpr_set_delayed(lanes, rt,
+				load(lanes, a, simm, sizeof(u8), mask));
+		break;
+
+	case INSTR_LH:
+		gpr_set_delayed(lanes, rt,
+				(lanes_vec)((lanes_svec)(load(lanes, a, simm,
+							      sizeof(u16),
+							      mask)
+							 << 16) >>
+					    16));
+		break;
+
+	case INSTR_LHU:
+		gpr_set_delayed(lanes, rt,
+				load(lanes, a, simm, sizeof(u16), mask));
+		break;
+
+	case INSTR_LW:
+		gpr_set_delayed(lanes, rt,
+				load(lanes, a, simm, sizeof(u32), mask));
+		break;
+
+	case INSTR_LWL:
+	case INSTR_LWR:
+		lwl_lwr(lanes, instr, a, mask);
+		break;
+
+	case INSTR_SB:
+		store(lanes, a, simm, sizeof(u8), b, mask);
+		break;
+
+	case INSTR_SH:
+		store(lanes, a, simm, sizeof(u16), b, mask);
+		break;
+
+	case INSTR_SW:
+		store(lanes, a, simm, sizeof(u32), b, mask);
+		break;
+
+	case INSTR_SWL:
+	case INSTR_SWR:
+		swl_swr(lanes, instr, a, b, mask);
+		break;
+
+	default:
+		UNREACHABLE;
+	}
+
+	*vec(lanes->gpr[0]) = splat(0);
+}
+
+// Executes the next instruction in the pack, taking out the lanes which
+// cannot; returns the lanes which executed it.
+LANES_TARGETS static u32 step_packed(struct psycho_lanes *const lanes)
+{
+	if (lanes->pc & 0x00000003) {
+		lanes_split(lanes, lanes->packed);
+		return 0;
+	}
+
+	// Code is only shared from RAM, which every lane has a copy of, and the
+	// BIOS, which they all have the same of unless the host says otherwise.
+	const u32 paddr = vaddr_to_paddr(lanes->pc);
+	const bool in_bios = (paddr - BIOS_ADDR_START) < BIOS_SIZE;
+
+	if ((paddr >= RAM_SIZE) && !in_bios) {
+		lanes_split(lanes, lanes->packed);
+		return 0;
+	}
+
+	const uint leader = __builtin_ctz(lanes->packed);
+	struct psycho_ctx *const lead = lanes->ctx[leader];
+	const u32 instr = lane_code(lead, paddr, in_bios);
+
+	u32 out = 0;
+
+	for (u32 left = lanes->packed; left; left &= left - 1) {
+		const uint lane = __builtin_ctz(left);
+		struct psycho_ctx *const ctx = lanes->ctx[lane];
+
+		if (!lane_code_ok(ctx, lanes->pc))
+			out |= 1U << lane;
+		else if ((ctx != lead) &&
+			 (!in_bios || (ctx->bus.bios != lead->bus.bios)) &&
+			 (lane_code(ctx, paddr, in_bios) != instr))
+			out |= 1U << lane;
+	}
+
+	lanes_split(lanes, out);
+
+	if (!lanes->packed)
+		return 0;
+
+	lanes_split(lanes, step_check(lanes, instr, lanes->packed));
+
+	const u32 mask = lanes->packed;
+
+	if (!mask)
+		return 0;
+
+	// The start of psycho_cpu_step(), for every lane at once.
+	lanes->in_branch_delay_slot = lanes->next_in_branch_delay_slot;
+	lanes->next_in_branch_delay_slot = false;
+
+	*vec(lanes->gpr[lanes->ld_next_dst]) = *vec(lanes->ld_next_val);
+	lanes->ld_next_dst = lanes->ld_pend_dst;
+	*vec(lanes->ld_next_val) = *vec(lanes->ld_pend_val);
+	lanes->ld_pend_dst = 0;
+	*vec(lanes->ld_pend_val) = splat(0);
+
+	lanes->curr_pc = lanes->pc;
+	lanes->instr = instr;
+	lanes->pc = lanes->next_pc;
+	lanes->next_pc = lanes->pc + sizeof(u32);
+
+	step_exec(lanes, instr, mask);
+
+	lanes->fresh = mask;
+	lanes->clock++;
+
+	if (lanes->diverged && !lanes->next_in_branch_delay_slot)
+		lanes_split(lanes, lanes->diverged);
+
+	return mask;
+}
+
+void psycho_lanes_init(struct psycho_lanes *const lanes,
+		       struct psycho_ctx *const *const ctx,
+		       const uint lanes_num)
+{
+	memset(lanes, 0, sizeof(*lanes));
+
+	memcpy(lanes->ctx, ctx, lanes_num * sizeof(*ctx));
+	lanes->lanes_num = lanes_num;
+}
+
+u64 psycho_lanes_run(struct psycho_lanes *const lanes, const u64 num_instrs)
+{
+	const u32 all = lanes_all(lanes);
+	u64 total = 0;
+
+	if (!num_instrs)
+		return 0;
+
+	for (uint i = 0; i < lanes->lanes_num; ++i)
+		lanes->left[i] = num_instrs;
+
+	lanes->clock = 0;
+	lanes->stopped = 0;
+	lanes_merge(lanes);
+
+	while (lanes->stopped != all) {
+		u32 loose = all & ~lanes->packed & ~lanes->stopped;
+
+		// Lanes which went another way than the pack rejoin it where
+		// the paths meet again. Running the lowest PC first gets them
+		// there: whichever side skipped ahead waits for the other.
+		const u32 pc = loose ? lanes_min_pc(lanes, loose) : lanes->pc;
+
+		if (lanes->packed && (lanes->pc == pc)) {
+			const u32 ran = step_packed(lanes);
+
+			lanes->packed_instrs += __builtin_popcount(ran);
+			total += __builtin_popcount(ran);
+
+			if (unlikely(lanes->clock == lanes->deadline))
+				lanes_expire(lanes);
+
+			loose = all & ~lanes->packed & ~lanes->stopped;
+		}
+
+		if (!loose)
+			continue;
+
+		for (u32 rest = loose; rest; rest &= rest - 1) {
+			const uint lane = __builtin_ctz(rest);
+			struct psycho_ctx *const ctx = lanes->ctx[lane];
+
+			if (ctx->cpu.pc != pc)
+				continue;
+
+			if (!psycho_step(ctx)) {
+				lanes->stopped |= 1U << lane;
+				continue;
+			}
+
+			lanes->scalar_instrs++;
+			total++;
+
+			if (--lanes->left[lane] == 0)
+				lanes->stopped |= 1U << lane;
+		}
+		lanes_merge(lanes);
+	}
+
+	// Leave every context up to date for the host.
+	for (u32 rest = lanes->packed; rest; rest &= rest - 1)
+		lane_unpack(lanes, __builtin_ctz(rest));
+
+	return total;
+}
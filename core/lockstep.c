@@ -0,0 +1,294 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "bus.h"
+#include "cpu.h"
+#include "lockstep.h"
+
+static u64 hash_mix(const u64 hash, const u64 val)
+{
+	return (hash ^ val) * UINT64_C(0x00000100000001B3);
+}
+
+static void tap_start(struct psycho_ctx *const ctx)
+{
+	memset(&ctx->lockstep, 0, sizeof(ctx->lockstep));
+	ctx->lockstep.write_hash = UINT64_C(0xCBF29CE484222325);
+
+	psycho_bus_page_flags_set(ctx, 0, 0, PSYCHO_BUS_PAGE_LOCKSTEP);
+}
+
+void psycho_lockstep_store(struct psycho_ctx *const ctx, const u32 paddr,
+			   const uint width, const u32 val)
+{
+	struct psycho_lockstep_tap *const tap = &ctx->lockstep;
+
+	tap->write_hash = hash_mix(hash_mix(tap->write_hash, paddr),
+				   ((u64)width << 32) | val);
+
+	// No instruction writes more than once, so a unit never runs out of
+	// room; a host poking the bus from a hook simply can't be undone.
+	if (tap->writes_num == PSYCHO_LOCKSTEP_UNIT_INSTRS_MAX)
+		return;
+
+	u8 old[sizeof(u32)] = { 0 };
+	psycho_bus_peek(ctx, paddr, old, width);
+
+	u32 old_val = 0;
+
+	for (uint i = 0; i < width; ++i)
+		old_val |= (u32)old[i] << (i * 8);
+
+	tap->writes[tap->writes_num++] = (struct psycho_lockstep_write){
+		// clang-format off
+
+		.paddr		= paddr,
+		.old_val	= old_val,
+		.width		= (u8)width
+
+		// clang-format on
+	};
+}
+
+// Writes back what the bus held before the unit, last write first; only RAM
+// and the scratchpad can be written back.
+static void writes_undo(struct psycho_ctx *const ctx)
+{
+	struct psycho_lockstep_tap *const tap = &ctx->lockstep;
+
+	while (tap->writes_num) {
+		const struct psycho_lockstep_write *const write =
+			&tap->writes[--tap->writes_num];
+
+		u8 old[sizeof(u32)];
+
+		for (uint i = 0; i < write->width; ++i)
+			old[i] = (u8)(write->old_val >> (i * 8));
+
+		psycho_bus_poke(ctx, write->paddr, old, write->width);
+	}
+}
+
+static void checkpoint_take(struct psycho_lockstep *const ls)
+{
+	ls->ref_cpu = ls->ref->cpu;
+	ls->cand_cpu = ls->cand->cpu;
+	ls->ref_write_hash = ls->ref->lockstep.write_hash;
+	ls->cand_write_hash = ls->cand->lockstep.write_hash;
+
+	ls->ref->lockstep.writes_num = 0;
+	ls->cand->lockstep.writes_num = 0;
+}
+
+static void checkpoint_restore(struct psycho_lockstep *const ls)
+{
+	writes_undo(ls->ref);
+	writes_undo(ls->cand);
+
+	ls->ref->cpu = ls->ref_cpu;
+	ls->cand->cpu = ls->cand_cpu;
+	ls->ref->lockstep.write_hash = ls->ref_write_hash;
+	ls->cand->lockstep.write_hash = ls->cand_write_hash;
+}
+
+static bool states_match(struct psycho_lockstep *const ls)
+{
+	struct psycho_cpu_sample ref;
+	psycho_cpu_sample_take(ls->ref, &ref);
+
+	ls->compares++;
+
+	return (ls->ref->lockstep.write_hash ==
+		ls->cand->lockstep.write_hash) &&
+	       psycho_cpu_sample_matches(ls->cand, &ref);
+}
+
+// Steps through at most @p num_instrs instructions, stopping early only if a
+// hook stops a step; returns the number executed.
+static u64 steps_run(struct psycho_ctx *const ctx, const u64 num_instrs)
+{
+	u64 i = 0;
+
+	while ((i < num_instrs) && psycho_step(ctx))
+		++i;
+
+	return i;
+}
+
+// The candidate has already gone past whatever a hook might stop the reference
+// at, so a stopped step is simply resumed.
+static void ref_run(struct psycho_lockstep *const ls, const u64 num_instrs)
+{
+	for (u64 i = 0; i < num_instrs; ++i) {
+		while (!psycho_step(ls->ref))
+			;
+	}
+}
+
+// Executes the instructions the candidate is next compared after, no more than
+// @p budget of them; returns the number executed.
+static u64 unit_run(struct psycho_lockstep *const ls, const u64 budget)
+{
+	struct psycho_ctx *const cand = ls->cand;
+
+	if (ls->granularity == PSYCHO_LOCKSTEP_INSTR) {
+		const u64 ran = psycho_ir_step_uncached(cand, &ls->block, 1);
+		return ran ? ran : steps_run(cand, 1);
+	}
+
+	const u64 ran = psycho_ir_step(cand, budget);
+
+	if (ran)
+		return ran;
+
+	// The IR takes over again as soon as it can, as in psycho_run().
+	if (cand->ir.enable)
+		return steps_run(cand, 1);
+
+	const u64 max = (budget < PSYCHO_LOCKSTEP_UNIT_INSTRS_MAX) ?
+				budget :
+				PSYCHO_LOCKSTEP_UNIT_INSTRS_MAX;
+	u64 i = 0;
+
+	while ((i < max) && psycho_step(cand)) {
+		++i;
+
+		if (cand->cpu.in_branch_delay_slot)
+			break;
+	}
+	return i;
+}
+
+// Runs the unit of @p unit_instrs instructions the two diverged in again from
+// its start, one instruction longer at a time, and leaves both just after the
+// first instruction they differ after; returns the number of instructions of
+// the unit executed up to and including it. Units of more than one
+// instruction are either blocks of the IR, whose prefixes are translated as
+// blocks of their own, or runs of steps.
+static u64 divergence_find(struct psycho_lockstep *const ls,
+			   const u64 unit_instrs)
+{
+	struct psycho_ctx *const cand = ls->cand;
+	const bool ir = cand->ir.enable;
+
+	for (u64 num = 1; num < unit_instrs; ++num) {
+		checkpoint_restore(ls);
+
+		const u64 ran = ir ? psycho_ir_step_uncached(cand, &ls->block,
+							     num) :
+				     steps_run(cand, num);
+
+		// The prefix would split a branch from its delay slot.
+		if (ran != num)
+			continue;
+
+		ref_run(ls, num);
+
+		if (!states_match(ls))
+			return num;
+	}
+
+	// Only the unit as a whole differs, as it was run the first time.
+	checkpoint_restore(ls);
+
+	if (ir)
+		psycho_ir_step(cand, unit_instrs);
+	else
+		steps_run(cand, unit_instrs);
+
+	ref_run(ls, unit_instrs);
+	return unit_instrs;
+}
+
+static void divergence_record(struct psycho_lockstep *const ls)
+{
+	struct psycho_lockstep_divergence *const div = &ls->divergence;
+	struct psycho_ctx *const ref = ls->ref;
+
+	div->instrs = ls->instrs;
+	div->pc = ref->cpu.curr_pc;
+	div->instr = ref->cpu.instr;
+
+	psycho_disasm_instr(ref, div->instr, div->pc);
+	memcpy(div->disasm, ref->disasm.result.str, sizeof(div->disasm));
+
+	psycho_cpu_sample_take(ref, &div->ref);
+	psycho_cpu_sample_take(ls->cand, &div->cand);
+
+	div->ref_write_hash = ref->lockstep.write_hash;
+	div->cand_write_hash = ls->cand->lockstep.write_hash;
+
+	ls->diverged = true;
+}
+
+void psycho_lockstep_init(struct psycho_lockstep *const ls,
+			  struct psycho_ctx *const ref,
+			  struct psycho_ctx *const cand,
+			  const enum psycho_lockstep_granularity granularity)
+{
+	memset(ls, 0, sizeof(*ls));
+
+	ls->ref = ref;
+	ls->cand = cand;
+	ls->granularity = (u8)granularity;
+
+	tap_start(ref);
+	tap_start(cand);
+}
+
+u64 psycho_lockstep_run(struct psycho_lockstep *const ls, const u64 num_instrs)
+{
+	u64 i = 0;
+
+	while (!ls->diverged && (i < num_instrs)) {
+		checkpoint_take(ls);
+
+		u64 ran = unit_run(ls, num_instrs - i);
+
+		if (!ran)
+			break;
+
+		ref_run(ls, ran);
+
+		if (!states_match(ls)) {
+			if (ran > 1)
+				ran = divergence_find(ls, ran);
+
+			ls->instrs += ran;
+			divergence_record(ls);
+
+			return i + ran;
+		}
+
+		ls->instrs += ran;
+		i += ran;
+	}
+	return i;
+}
+
+void psycho_lockstep_end(struct psycho_lockstep *const ls)
+{
+	psycho_bus_page_flags_clear(ls->ref, PSYCHO_BUS_PAGE_LOCKSTEP);
+	psycho_bus_page_flags_clear(ls->cand, PSYCHO_BUS_PAGE_LOCKSTEP);
+}
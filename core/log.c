@@ -27,7 +27,9 @@
 #include <string.h>
 
 #include "core/ctx.h"
+#include "event.h"
 #include "log.h"
+#include "timers.h"
 
 static const char *const log_level_name[PSYCHO_LOG_LEVEL_NUM] = {
 	// clang-format off
@@ -73,6 +75,8 @@ void psycho_log_message_dispatch(struct psycho_ctx *const ctx,
 				 const enum psycho_log_level level,
 				 const char *const str, ...)
 {
+	psycho_timer_begin(ctx, PSYCHO_TIMER_ZONE_LOG);
+
 	struct psycho_log_msg msg;
 
 	msg.msg_len = sprintf(msg.msg, "[%s/%s] ", log_level_name[level],
@@ -93,5 +97,6 @@ void psycho_log_message_dispatch(struct psycho_ctx *const ctx,
 	msg.id = id;
 	msg.level = level;
 
-	ctx->event_cb(ctx, PSYCHO_EVENT_LOG_MESSAGE, &msg);
+	psycho_event_raise(ctx, PSYCHO_EVENT_LOG_MESSAGE, &msg);
+	psycho_timer_end(ctx);
 }
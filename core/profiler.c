@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "cpu.h"
+#include "event.h"
+#include "profiler.h"
+
+void psycho_profiler_enable(struct psycho_ctx *const ctx, const bool enable,
+			    const u64 interval)
+{
+	memset(&ctx->profiler, 0, sizeof(ctx->profiler));
+
+	ctx->profiler.interval = interval ? interval : 1;
+	ctx->profiler.countdown = ctx->profiler.interval;
+	ctx->profiler.enable = enable;
+
+	psycho_cpu_step_select(ctx);
+}
+
+void psycho_profiler_tick(struct psycho_ctx *const ctx)
+{
+	if (--ctx->profiler.countdown)
+		return;
+
+	ctx->profiler.countdown = ctx->profiler.interval;
+
+	struct psycho_profiler_sample sample = {
+		// clang-format off
+
+		.pc	= ctx->cpu.pc,
+		.stack	= ctx->profiler.stack,
+		.depth	= ctx->profiler.depth
+
+		// clang-format on
+	};
+
+	if (sample.depth > PSYCHO_PROFILER_STACK_DEPTH_MAX)
+		sample.depth = PSYCHO_PROFILER_STACK_DEPTH_MAX;
+
+	psycho_event_raise(ctx, PSYCHO_EVENT_PROFILER_SAMPLE, &sample);
+}
+
+void psycho_profiler_call(struct psycho_ctx *const ctx, const u32 func,
+			  const u32 ret_addr)
+{
+	const uint depth = ctx->profiler.depth++;
+
+	if (depth < PSYCHO_PROFILER_STACK_DEPTH_MAX) {
+		ctx->profiler.stack[depth].func = func;
+		ctx->profiler.stack[depth].ret_addr = ret_addr;
+	}
+}
+
+void psycho_profiler_return(struct psycho_ctx *const ctx, const u32 ret_addr)
+{
+	uint depth = ctx->profiler.depth;
+
+	// Frames deeper than we can record can't be matched against, so just
+	// assume the return belongs to the innermost one.
+	if (depth > PSYCHO_PROFILER_STACK_DEPTH_MAX) {
+		ctx->profiler.depth--;
+		return;
+	}
+
+	// Unwind to the frame which expects to return here; this also copes
+	// with frames abandoned by longjmp() style control flow. A return
+	// which matches no frame at all belongs to a call made before the
+	// profiler was enabled, and is ignored.
+	while (depth--) {
+		if (ctx->profiler.stack[depth].ret_addr == ret_addr) {
+			ctx->profiler.depth = depth;
+			return;
+		}
+	}
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "core/compiler.h"
+#include "core/ctx.h"
+#include "core/profiler.h"
+
+void psycho_profiler_tick(struct psycho_ctx *ctx);
+void psycho_profiler_call(struct psycho_ctx *ctx, u32 func, u32 ret_addr);
+void psycho_profiler_return(struct psycho_ctx *ctx, u32 ret_addr);
+
+ALWAYS_INLINE void psycho_profiler_on_step(struct psycho_ctx *const ctx)
+{
+	if (unlikely(ctx->profiler.enable))
+		psycho_profiler_tick(ctx);
+}
+
+ALWAYS_INLINE void psycho_profiler_on_call(struct psycho_ctx *const ctx,
+					   const u32 func, const u32 ret_addr)
+{
+	if (unlikely(ctx->profiler.enable))
+		psycho_profiler_call(ctx, func, ret_addr);
+}
+
+ALWAYS_INLINE void psycho_profiler_on_return(struct psycho_ctx *const ctx,
+					     const u32 ret_addr)
+{
+	if (unlikely(ctx->profiler.enable))
+		psycho_profiler_return(ctx, ret_addr);
+}
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "core/snapshot.h"
+#include "bus.h"
+
+void psycho_snapshot_save(struct psycho_ctx *const ctx,
+			  struct psycho_snapshot *const snap)
+{
+	memset(ctx->bus.ram_dirty, 0, sizeof(ctx->bus.ram_dirty));
+
+	memcpy(&snap->ctx, ctx, sizeof(*ctx));
+	memcpy(snap->ram, ctx->bus.ram, RAM_SIZE);
+}
+
+uint psycho_snapshot_restore(struct psycho_ctx *const ctx,
+			     const struct psycho_snapshot *const snap)
+{
+	uint num_pages = 0;
+
+	for (uint i = 0; i < (RAM_PAGE_NUM / 64); ++i) {
+		u64 dirty = ctx->bus.ram_dirty[i];
+
+		while (dirty) {
+			const uint page = (i * 64) + __builtin_ctzll(dirty);
+			const size_t off = (size_t)page << RAM_PAGE_SHIFT;
+
+			memcpy(&ctx->bus.ram[off], &snap->ram[off],
+			       RAM_PAGE_SIZE);
+
+			dirty &= dirty - 1;
+			num_pages++;
+		}
+	}
+
+	// The snapshot's dirty bitmap was cleared when it was taken, so this
+	// also starts tracking afresh.
+	memcpy(ctx, &snap->ctx, sizeof(*ctx));
+	return num_pages;
+}
+
+void psycho_snapshot_ram_write(struct psycho_ctx *const ctx, const u32 paddr,
+			       const void *const data, size_t size)
+{
+	if (paddr >= RAM_SIZE)
+		return;
+
+	if (size > (RAM_SIZE - paddr))
+		size = RAM_SIZE - paddr;
+
+	memcpy(&ctx->bus.ram[paddr], data, size);
+	psycho_bus_ram_dirty_range(ctx, paddr, size);
+}
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "cpu-defs.h"
+#include "stats.h"
+
+bool psycho_stats_get(const struct psycho_ctx *const ctx,
+		      struct psycho_stats *const stats)
+{
+#ifdef PSYCHO_ENABLE_STATS
+	memcpy(stats, &ctx->stats, sizeof(*stats));
+	return true;
+#else
+	(void)ctx;
+
+	memset(stats, 0, sizeof(*stats));
+	return false;
+#endif // PSYCHO_ENABLE_STATS
+}
+
+void psycho_stats_reset(struct psycho_ctx *const ctx)
+{
+#ifdef PSYCHO_ENABLE_STATS
+	memset(&ctx->stats, 0, sizeof(ctx->stats));
+#else
+	(void)ctx;
+#endif // PSYCHO_ENABLE_STATS
+}
+
+const char *psycho_stats_op_name(const uint op)
+{
+	static const char *const names[PSYCHO_STATS_OP_NUM] = {
+		// clang-format off
+
+		[INSTR_GROUP_SPECIAL]	= "special",
+		[INSTR_GROUP_BCOND]	= "bcond",
+		[INSTR_GROUP_COP0]	= "cop0",
+		[INSTR_J]		= "j",
+		[INSTR_JAL]		= "jal",
+		[INSTR_BEQ]		= "beq",
+		[INSTR_BNE]		= "bne",
+		[INSTR_BLEZ]		= "blez",
+		[INSTR_BGTZ]		= "bgtz",
+		[INSTR_ADDI]		= "addi",
+		[INSTR_ADDIU]		= "addiu",
+		[INSTR_SLTI]		= "slti",
+		[INSTR_SLTIU]		= "sltiu",
+		[INSTR_ANDI]		= "andi",
+		[INSTR_ORI]		= "ori",
+		[INSTR_XORI]		= "xori",
+		[INSTR_LUI]		= "lui",
+		[INSTR_LB]		= "lb",
+		[INSTR_LH]		= "lh",
+		[INSTR_LWL]		= "lwl",
+		[INSTR_LW]		= "lw",
+		[INSTR_LBU]		= "lbu",
+		[INSTR_LHU]		= "lhu",
+		[INSTR_LWR]		= "lwr",
+		[INSTR_SB]		= "sb",
+		[INSTR_SH]		= "sh",
+		[INSTR_SWL]		= "swl",
+		[INSTR_SW]		= "sw",
+		[INSTR_SWR]		= "swr"
+
+		// clang-format on
+	};
+
+	return (op < PSYCHO_STATS_OP_NUM) ? names[op] : NULL;
+}
+
+const char *psycho_stats_special_name(const uint funct)
+{
+	static const char *const names[PSYCHO_STATS_OP_NUM] = {
+		// clang-format off
+
+		[INSTR_SLL]	= "sll",
+		[INSTR_SRL]	= "srl",
+		[INSTR_SRA]	= "sra",
+		[INSTR_SLLV]	= "sllv",
+		[INSTR_SRLV]	= "srlv",
+		[INSTR_SRAV]	= "srav",
+		[INSTR_JR]	= "jr",
+		[INSTR_JALR]	= "jalr",
+		[INSTR_SYSCALL]	= "syscall",
+		[INSTR_BREAK]	= "break",
+		[INSTR_MFHI]	= "mfhi",
+		[INSTR_MTHI]	= "mthi",
+		[INSTR_MFLO]	= "mflo",
+		[INSTR_MTLO]	= "mtlo",
+		[INSTR_MULT]	= "mult",
+		[INSTR_MULTU]	= "multu",
+		[INSTR_DIV]	= "div",
+		[INSTR_DIVU]	= "divu",
+		[INSTR_ADD]	= "add",
+		[INSTR_ADDU]	= "addu",
+		[INSTR_SUB]	= "sub",
+		[INSTR_SUBU]	= "subu",
+		[INSTR_AND]	= "and",
+		[INSTR_OR]	= "or",
+		[INSTR_XOR]	= "xor",
+		[INSTR_NOR]	= "nor",
+		[INSTR_SLT]	= "slt",
+		[INSTR_SLTU]	= "sltu"
+
+		// clang-format on
+	};
+
+	return (funct < PSYCHO_STATS_OP_NUM) ? names[funct] : NULL;
+}
+
+const char *psycho_stats_region_name(const enum psycho_stats_region region)
+{
+	static const char *const names[PSYCHO_STATS_REGION_NUM] = {
+		// clang-format off
+
+		[PSYCHO_STATS_REGION_RAM]		= "ram",
+		[PSYCHO_STATS_REGION_SCRATCHPAD]	= "scratchpad",
+		[PSYCHO_STATS_REGION_BIOS]		= "bios",
+		[PSYCHO_STATS_REGION_MMIO]		= "mmio",
+		[PSYCHO_STATS_REGION_UNMAPPED]		= "unmapped"
+
+		// clang-format on
+	};
+
+	return names[region];
+}
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "core/bus.h"
+#include "core/compiler.h"
+#include "core/ctx.h"
+#include "core/stats.h"
+#include "cpu-defs.h"
+
+#ifdef PSYCHO_ENABLE_STATS
+
+ALWAYS_INLINE enum psycho_stats_region psycho_stats_region(const u32 paddr)
+{
+	switch (paddr) {
+	case RAM_ADDR_START ... RAM_ADDR_END - 1:
+		return PSYCHO_STATS_REGION_RAM;
+
+	case SCRATCHPAD_ADDR_START ... SCRATCHPAD_ADDR_END:
+		return PSYCHO_STATS_REGION_SCRATCHPAD;
+
+	case BIOS_ADDR_START ... BIOS_ADDR_END:
+		return PSYCHO_STATS_REGION_BIOS;
+
+	case IO_ADDR_START ... IO_ADDR_END:
+	case CACHE_CONTROL_ADDR:
+		return PSYCHO_STATS_REGION_MMIO;
+
+	default:
+		return PSYCHO_STATS_REGION_UNMAPPED;
+	}
+}
+
+#endif // PSYCHO_ENABLE_STATS
+
+// Every hook below compiles to nothing unless PSYCHO_ENABLE_STATS is defined,
+// so they may be called unconditionally from the hot paths.
+
+ALWAYS_INLINE void psycho_stats_on_instr(struct psycho_ctx *const ctx,
+					 const uint op, const uint funct)
+{
+#ifdef PSYCHO_ENABLE_STATS
+	ctx->stats.op[op]++;
+
+	if (op == INSTR_GROUP_SPECIAL)
+		ctx->stats.special[funct]++;
+#else
+	(void)ctx;
+	(void)op;
+	(void)funct;
+#endif // PSYCHO_ENABLE_STATS
+}
+
+ALWAYS_INLINE void psycho_stats_on_fetch(struct psycho_ctx *const ctx,
+					 const u32 paddr)
+{
+#ifdef PSYCHO_ENABLE_STATS
+	ctx->stats.fetches[psycho_stats_region(paddr)]++;
+#else
+	(void)ctx;
+	(void)paddr;
+#endif // PSYCHO_ENABLE_STATS
+}
+
+ALWAYS_INLINE void psycho_stats_on_load(struct psycho_ctx *const ctx,
+					const u32 paddr)
+{
+#ifdef PSYCHO_ENABLE_STATS
+	ctx->stats.loads[psycho_stats_region(paddr)]++;
+#else
+	(void)ctx;
+	(void)paddr;
+#endif // PSYCHO_ENABLE_STATS
+}
+
+ALWAYS_INLINE void psycho_stats_on_store(struct psycho_ctx *const ctx,
+					 const u32 paddr)
+{
+#ifdef PSYCHO_ENABLE_STATS
+	ctx->stats.stores[psycho_stats_region(paddr)]++;
+#else
+	(void)ctx;
+	(void)paddr;
+#endif // PSYCHO_ENABLE_STATS
+}
+
+ALWAYS_INLINE void psycho_stats_on_exception(struct psycho_ctx *const ctx,
+					     const uint exc)
+{
+#ifdef PSYCHO_ENABLE_STATS
+	ctx->stats.exceptions[exc & (PSYCHO_STATS_EXC_NUM - 1)]++;
+#else
+	(void)ctx;
+	(void)exc;
+#endif // PSYCHO_ENABLE_STATS
+}
+
+ALWAYS_INLINE void
+psycho_stats_on_load_delay_cancel(struct psycho_ctx *const ctx)
+{
+#ifdef PSYCHO_ENABLE_STATS
+	ctx->stats.load_delay_cancels++;
+#else
+	(void)ctx;
+#endif // PSYCHO_ENABLE_STATS
+}
+
+ALWAYS_INLINE void
+psycho_stats_on_branch_in_delay_slot(struct psycho_ctx *const ctx)
+{
+#ifdef PSYCHO_ENABLE_STATS
+	ctx->stats.branch_in_delay_slot++;
+#else
+	(void)ctx;
+#endif // PSYCHO_ENABLE_STATS
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "timers.h"
+
+u64 psycho_timers_now(void)
+{
+	return psycho_timers_ticks();
+}
+
+bool psycho_timers_get(const struct psycho_ctx *const ctx,
+		       struct psycho_timer_totals *const totals)
+{
+#ifdef PSYCHO_ENABLE_TIMERS
+	memcpy(totals, ctx->timers.zones, sizeof(ctx->timers.zones));
+	return true;
+#else
+	(void)ctx;
+
+	memset(totals, 0, sizeof(*totals) * PSYCHO_TIMER_ZONE_NUM);
+	return false;
+#endif // PSYCHO_ENABLE_TIMERS
+}
+
+void psycho_timers_reset(struct psycho_ctx *const ctx)
+{
+#ifdef PSYCHO_ENABLE_TIMERS
+	memset(ctx->timers.zones, 0, sizeof(ctx->timers.zones));
+#else
+	(void)ctx;
+#endif // PSYCHO_ENABLE_TIMERS
+}
+
+void psycho_timers_record(struct psycho_ctx *const ctx,
+			  struct psycho_timer_event *const events,
+			  const size_t capacity)
+{
+#ifdef PSYCHO_ENABLE_TIMERS
+	ctx->timers.events = events;
+	ctx->timers.events_num = 0;
+	ctx->timers.events_capacity = events ? capacity : 0;
+	ctx->timers.events_dropped = 0;
+#else
+	(void)ctx;
+	(void)events;
+	(void)capacity;
+#endif // PSYCHO_ENABLE_TIMERS
+}
+
+size_t psycho_timers_recorded(const struct psycho_ctx *const ctx,
+			      u64 *const dropped)
+{
+#ifdef PSYCHO_ENABLE_TIMERS
+	if (dropped)
+		*dropped = ctx->timers.events_dropped;
+
+	return ctx->timers.events_num;
+#else
+	(void)ctx;
+
+	if (dropped)
+		*dropped = 0;
+
+	return 0;
+#endif // PSYCHO_ENABLE_TIMERS
+}
+
+const char *psycho_timer_zone_name(const enum psycho_timer_zone zone)
+{
+	static const char *const names[PSYCHO_TIMER_ZONE_NUM] = {
+		// clang-format off
+
+		[PSYCHO_TIMER_ZONE_STEP]	= "step",
+		[PSYCHO_TIMER_ZONE_CPU]		= "cpu",
+		[PSYCHO_TIMER_ZONE_BUS]		= "bus",
+		[PSYCHO_TIMER_ZONE_LOG]		= "log",
+		[PSYCHO_TIMER_ZONE_DISASM]	= "disasm",
+		[PSYCHO_TIMER_ZONE_HOOKS]	= "hooks",
+		[PSYCHO_TIMER_ZONE_CALLBACK]	= "callback"
+
+		// clang-format on
+	};
+
+	return names[zone];
+}
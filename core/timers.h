@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <time.h>
+
+#include "core/compiler.h"
+#include "core/ctx.h"
+#include "core/timers.h"
+
+ALWAYS_INLINE u64 psycho_timers_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((u64)ts.tv_sec * 1000000000) + (u64)ts.tv_nsec;
+#endif
+}
+
+// Both hooks compile to nothing unless PSYCHO_ENABLE_TIMERS is defined, so
+// they may be called unconditionally from the hot paths. Every call to
+// psycho_timer_begin() must be paired with a call to psycho_timer_end().
+
+ALWAYS_INLINE void psycho_timer_begin(struct psycho_ctx *const ctx,
+				      const enum psycho_timer_zone zone)
+{
+#ifdef PSYCHO_ENABLE_TIMERS
+	const uint depth = ctx->timers.depth++;
+
+	if (unlikely(depth >= PSYCHO_TIMER_DEPTH_MAX))
+		return;
+
+	ctx->timers.stack[depth].zone = zone;
+	ctx->timers.stack[depth].child_ticks = 0;
+	ctx->timers.stack[depth].begin = psycho_timers_ticks();
+#else
+	(void)ctx;
+	(void)zone;
+#endif // PSYCHO_ENABLE_TIMERS
+}
+
+ALWAYS_INLINE void psycho_timer_end(struct psycho_ctx *const ctx)
+{
+#ifdef PSYCHO_ENABLE_TIMERS
+	const u64 end = psycho_timers_ticks();
+	const uint depth = --ctx->timers.depth;
+
+	if (unlikely(depth >= PSYCHO_TIMER_DEPTH_MAX))
+		return;
+
+	const u64 begin = ctx->timers.stack[depth].begin;
+	const u64 ticks = end - begin;
+	const enum psycho_timer_zone zone = ctx->timers.stack[depth].zone;
+
+	struct psycho_timer_totals *const totals = &ctx->timers.zones[zone];
+
+	totals->count++;
+	totals->ticks += ticks;
+	totals->self_ticks += ticks - ctx->timers.stack[depth].child_ticks;
+
+	if (depth)
+		ctx->timers.stack[depth - 1].child_ticks += ticks;
+
+	if (unlikely(ctx->timers.events)) {
+		if (ctx->timers.events_num < ctx->timers.events_capacity) {
+			struct psycho_timer_event *const event =
+				&ctx->timers.events[ctx->timers.events_num++];
+
+			event->begin = begin;
+			event->end = end;
+			event->zone = zone;
+			event->depth = depth;
+		} else {
+			ctx->timers.events_dropped++;
+		}
+	}
+#else
+	(void)ctx;
+#endif // PSYCHO_ENABLE_TIMERS
+}
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "cpu-defs.h"
+#include "event.h"
+#include "watch.h"
+
+// Flags every page of every watchpoint; pages no longer watched lose theirs.
+static void flags_update(struct psycho_ctx *const ctx)
+{
+	psycho_bus_page_flags_clear(ctx, PSYCHO_BUS_PAGE_WATCH_READ |
+						 PSYCHO_BUS_PAGE_WATCH_WRITE);
+
+	for (uint i = 0; i < PSYCHO_WATCHPOINTS_MAX; ++i) {
+		if (!(ctx->watch.used & (UINT32_C(1) << i)))
+			continue;
+
+		const struct psycho_watchpoint *const wp =
+			&ctx->watch.points[i];
+
+		u8 flag = 0;
+
+		if (wp->access & PSYCHO_WATCH_READ)
+			flag |= PSYCHO_BUS_PAGE_WATCH_READ;
+
+		if (wp->access & PSYCHO_WATCH_WRITE)
+			flag |= PSYCHO_BUS_PAGE_WATCH_WRITE;
+
+		const u32 first = wp->start >> BUS_PAGE_SHIFT;
+		const u32 last = (wp->end - 1) >> BUS_PAGE_SHIFT;
+
+		if ((last - first) >= BUS_PAGE_SLOTS) {
+			for (uint slot = 0; slot < BUS_PAGE_SLOTS; ++slot)
+				ctx->bus.page_flags[slot] |= flag;
+
+			continue;
+		}
+
+		for (u32 page = first; page <= last; ++page) {
+			const u32 addr = page << BUS_PAGE_SHIFT;
+			ctx->bus.page_flags[psycho_bus_page_slot(addr)] |= flag;
+		}
+	}
+}
+
+static void hit_raise(struct psycho_ctx *const ctx, const u32 paddr,
+		      const uint width, const u32 old_val, const u32 new_val,
+		      const u8 access)
+{
+	for (uint i = 0; i < PSYCHO_WATCHPOINTS_MAX; ++i) {
+		const struct psycho_watchpoint *const wp =
+			&ctx->watch.points[i];
+
+		if (!(ctx->watch.used & (UINT32_C(1) << i)) ||
+		    !(wp->access & access) || (paddr >= wp->end) ||
+		    ((paddr + width) <= wp->start))
+			continue;
+
+		struct psycho_watch_hit hit = {
+			// clang-format off
+
+			.id		= i + 1,
+			.pc		= ctx->cpu.curr_pc,
+			.addr		= paddr,
+			.old_val	= old_val,
+			.new_val	= new_val,
+			.width		= (u8)width,
+			.access		= access
+
+			// clang-format on
+		};
+
+		psycho_event_raise(ctx, PSYCHO_EVENT_WATCHPOINT, &hit);
+	}
+}
+
+void psycho_watch_reset(struct psycho_ctx *const ctx)
+{
+	memset(&ctx->watch, 0, sizeof(ctx->watch));
+	flags_update(ctx);
+}
+
+void psycho_watch_load(struct psycho_ctx *const ctx, const u32 paddr,
+		       const uint width, const u32 val)
+{
+	hit_raise(ctx, paddr, width, val, val, PSYCHO_WATCH_READ);
+}
+
+void psycho_watch_store(struct psycho_ctx *const ctx, const u32 paddr,
+			const uint width, const u32 val)
+{
+	u8 old[sizeof(u32)] = { 0 };
+	psycho_bus_peek(ctx, paddr, old, width);
+
+	u32 old_val = 0;
+
+	for (uint i = 0; i < width; ++i)
+		old_val |= (u32)old[i] << (i * 8);
+
+	hit_raise(ctx, paddr, width, old_val, val, PSYCHO_WATCH_WRITE);
+}
+
+u32 psycho_watch_add(struct psycho_ctx *const ctx, const u32 addr,
+		     const u32 size, const u8 access)
+{
+	const u32 all = (UINT32_C(1) << PSYCHO_WATCHPOINTS_MAX) - 1;
+
+	if (!size || !access || (ctx->watch.used == all))
+		return 0;
+
+	const uint i = __builtin_ctz(~ctx->watch.used);
+	const u32 start = vaddr_to_paddr(addr);
+	const u32 end = (start + size < start) ? UINT32_MAX : start + size;
+
+	ctx->watch.points[i] = (struct psycho_watchpoint){
+		// clang-format off
+
+		.start	= start,
+		.end	= end,
+		.access	= access
+
+		// clang-format on
+	};
+
+	ctx->watch.used |= UINT32_C(1) << i;
+	flags_update(ctx);
+
+	return i + 1;
+}
+
+bool psycho_watch_remove(struct psycho_ctx *const ctx, const u32 id)
+{
+	if (!id || (id > PSYCHO_WATCHPOINTS_MAX) ||
+	    !(ctx->watch.used & (UINT32_C(1) << (id - 1))))
+		return false;
+
+	ctx->watch.used &= ~(UINT32_C(1) << (id - 1));
+	flags_update(ctx);
+
+	return true;
+}
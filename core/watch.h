@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "core/compiler.h"
+#include "core/ctx.h"
+#include "core/watch.h"
+#include "bus.h"
+
+void psycho_watch_reset(struct psycho_ctx *ctx);
+void psycho_watch_load(struct psycho_ctx *ctx, u32 paddr, uint width, u32 val);
+void psycho_watch_store(struct psycho_ctx *ctx, u32 paddr, uint width,
+			u32 val);
+
+ALWAYS_INLINE void psycho_watch_on_load(struct psycho_ctx *const ctx,
+					const u32 paddr, const uint width,
+					const u32 val)
+{
+	if (unlikely(psycho_bus_page_flagged(ctx, paddr,
+					     PSYCHO_BUS_PAGE_WATCH_READ)))
+		psycho_watch_load(ctx, paddr, width, val);
+}
+
+ALWAYS_INLINE void psycho_watch_on_store(struct psycho_ctx *const ctx,
+					 const u32 paddr, const uint width,
+					 const u32 val)
+{
+	if (unlikely(psycho_bus_page_flagged(ctx, paddr,
+					     PSYCHO_BUS_PAGE_WATCH_WRITE)))
+		psycho_watch_store(ctx, paddr, width, val);
+}
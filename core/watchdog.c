@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+#include "cpu-defs.h"
+#include "cpu.h"
+#include "event.h"
+#include "watchdog.h"
+
+void psycho_watchdog_enable(struct psycho_ctx *const ctx, const bool enable,
+			    const u64 interval, const u64 timeout)
+{
+	memset(&ctx->watchdog, 0, sizeof(ctx->watchdog));
+
+	ctx->watchdog.interval = interval ? interval : 1;
+	ctx->watchdog.countdown = ctx->watchdog.interval;
+	ctx->watchdog.timeout = timeout;
+	ctx->watchdog.enable = enable;
+}
+
+static void hang_raise(struct psycho_ctx *const ctx,
+		       const enum psycho_watchdog_reason reason,
+		       const u32 period)
+{
+	struct psycho_watchdog_hang hang = {
+		// clang-format off
+
+		.reason	= reason,
+		.pc	= ctx->cpu.pc,
+		.period	= period,
+		.idle	= ctx->watchdog.idle
+
+		// clang-format on
+	};
+
+	psycho_event_raise(ctx, PSYCHO_EVENT_HANG, &hang);
+}
+
+static bool instr_is_store(const u32 instr)
+{
+	switch (instr_op(instr)) {
+	case INSTR_SB:
+	case INSTR_SH:
+	case INSTR_SWL:
+	case INSTR_SW:
+	case INSTR_SWR:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+// Follows the guest for one instruction after a sample has been taken. Any
+// store gives up on the sample, as memory could now differ even if the CPU
+// state ends up identical.
+static void follow(struct psycho_ctx *const ctx)
+{
+	struct psycho_watchdog *const wd = &ctx->watchdog;
+
+	if (instr_is_store(ctx->cpu.instr)) {
+		wd->remaining = 0;
+		return;
+	}
+
+	const u32 period = PSYCHO_WATCHDOG_PERIOD_MAX - --wd->remaining;
+
+	if (psycho_cpu_sample_matches(ctx, &wd->sample)) {
+		wd->remaining = 0;
+		hang_raise(ctx, PSYCHO_WATCHDOG_REASON_LOOP, period);
+	}
+}
+
+void psycho_watchdog_tick(struct psycho_ctx *const ctx)
+{
+	struct psycho_watchdog *const wd = &ctx->watchdog;
+
+	if (wd->remaining)
+		follow(ctx);
+
+	if (--wd->countdown)
+		return;
+
+	wd->countdown = wd->interval;
+	wd->idle += wd->interval;
+
+	if (wd->timeout && (wd->idle >= wd->timeout)) {
+		hang_raise(ctx, PSYCHO_WATCHDOG_REASON_NO_PROGRESS, 0);
+		wd->idle = 0;
+	}
+
+	if (!wd->remaining) {
+		psycho_cpu_sample_take(ctx, &wd->sample);
+		wd->remaining = PSYCHO_WATCHDOG_PERIOD_MAX;
+	}
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <dlfcn.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "frontend/aot.h"
+
+bool aot_module_open(struct aot_module *const mod, const char *const path)
+{
+	mod->native = NULL;
+	mod->error = NULL;
+
+	// A bare file name would send dlopen() searching the library path
+	// rather than looking in the current directory.
+	char file[PATH_MAX];
+
+	if (!strchr(path, '/'))
+		snprintf(file, sizeof(file), "./%s", path);
+	else
+		snprintf(file, sizeof(file), "%s", path);
+
+	// Every block is needed sooner or later, and resolving them all now
+	// keeps symbol lookups out of the measured runs.
+	mod->handle = dlopen(file, RTLD_NOW | RTLD_LOCAL);
+
+	if (!mod->handle) {
+		mod->error = dlerror();
+		return false;
+	}
+
+	mod->native = dlsym(mod->handle, PSYCHO_IR_NATIVE_MODULE_SYMBOL);
+
+	if (!mod->native) {
+		mod->error = "not a native module";
+	} else if (mod->native->abi_version != PSYCHO_IR_NATIVE_ABI_VERSION) {
+		mod->error = "built by a different version of psycho-aot";
+	} else
+		return true;
+
+	dlclose(mod->handle);
+
+	mod->handle = NULL;
+	mod->native = NULL;
+
+	return false;
+}
+
+void aot_module_close(struct aot_module *const mod)
+{
+	if (mod->handle)
+		dlclose(mod->handle);
+
+	mod->handle = NULL;
+	mod->native = NULL;
+}
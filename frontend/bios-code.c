@@ -0,0 +1,307 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/ctx.h"
+#include "frontend/bios-code.h"
+
+enum {
+	BIOS_CODE_SEALS =
+		F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE,
+
+	/** @brief The most blocks translated; far more than any BIOS has. */
+	BIOS_CODE_BLOCKS_MAX = 16384
+};
+
+#define BIOS_CODE_MAGIC "PSXBIOSC"
+
+// The blocks follow the header directly, which keeps them aligned.
+struct bios_code_header {
+	char magic[8];
+	u64 bios_hash;
+	u32 abi_version;
+	u32 block_size;
+	u64 blocks_num;
+};
+
+static void ctx_event_handle(struct psycho_ctx *const ctx,
+			     const enum psycho_event event, void *const data)
+{
+	(void)ctx;
+	(void)event;
+	(void)data;
+}
+
+static bool write_all(const int fd, const void *const buf, size_t size)
+{
+	const u8 *data = buf;
+
+	while (size) {
+		const ssize_t num_written = write(fd, data, size);
+
+		if (num_written < 0) {
+			if (errno == EINTR)
+				continue;
+
+			return false;
+		}
+		data += num_written;
+		size -= num_written;
+	}
+	return true;
+}
+
+static bool header_valid(const struct bios_code_header *const hdr,
+			 const size_t size, const struct bios_image *const img)
+{
+	return (memcmp(hdr->magic, BIOS_CODE_MAGIC, sizeof(hdr->magic)) ==
+		0) &&
+	       (hdr->bios_hash == img->hash) &&
+	       (hdr->abi_version == PSYCHO_IR_NATIVE_ABI_VERSION) &&
+	       (hdr->block_size == sizeof(struct psycho_ir_block)) &&
+	       (hdr->blocks_num <= BIOS_CODE_BLOCKS_MAX) &&
+	       (size == (sizeof(*hdr) +
+			 (hdr->blocks_num * sizeof(struct psycho_ir_block))));
+}
+
+static bool map_fd(struct bios_code *const code, const int fd,
+		   const struct bios_image *const img)
+{
+	struct stat st;
+
+	if (fstat(fd, &st) < 0)
+		return false;
+
+	if ((size_t)st.st_size < sizeof(struct bios_code_header)) {
+		errno = ESTALE;
+		return false;
+	}
+
+	void *const map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+	if (map == MAP_FAILED)
+		return false;
+
+	const struct bios_code_header *const hdr = map;
+
+	if (!header_valid(hdr, st.st_size, img)) {
+		munmap(map, st.st_size);
+
+		errno = ESTALE;
+		return false;
+	}
+
+	code->map = map;
+	code->map_size = st.st_size;
+	code->fd = fd;
+
+	code->blocks.blocks = (const void *)&hdr[1];
+	code->blocks.blocks_num = hdr->blocks_num;
+
+	return true;
+}
+
+// Maps @p fd into @p code, closing it on failure.
+static bool map_fd_or_close(struct bios_code *const code, const int fd,
+			    const struct bios_image *const img)
+{
+	if (map_fd(code, fd, img))
+		return true;
+
+	const int err = errno;
+
+	close(fd);
+	errno = err;
+
+	return false;
+}
+
+bool bios_code_build(struct bios_code *const code,
+		     const struct bios_image *const img)
+{
+	struct psycho_ctx *const ctx = calloc(1, sizeof(*ctx));
+	struct psycho_ir_block *const blocks =
+		calloc(BIOS_CODE_BLOCKS_MAX, sizeof(*blocks));
+
+	if (!ctx || !blocks) {
+		free(ctx);
+		free(blocks);
+
+		errno = ENOMEM;
+		return false;
+	}
+
+	const struct psycho_ctx_cfg cfg = {
+		// clang-format off
+
+		.event_cb	= ctx_event_handle,
+		.bios_data	= img->data
+
+		// clang-format on
+	};
+
+	psycho_init(ctx, &cfg);
+
+	const struct bios_code_header hdr = {
+		// clang-format off
+
+		.magic		= BIOS_CODE_MAGIC,
+		.bios_hash	= img->hash,
+		.abi_version	= PSYCHO_IR_NATIVE_ABI_VERSION,
+		.block_size	= sizeof(*blocks),
+		.blocks_num	= psycho_ir_bios_translate(ctx, blocks,
+							   BIOS_CODE_BLOCKS_MAX)
+
+		// clang-format on
+	};
+
+	// The descriptor is deliberately not close-on-exec, so that it can be
+	// handed down to children.
+	const int fd = memfd_create("psycho-bios-code", MFD_ALLOW_SEALING);
+
+	const bool written =
+		(fd >= 0) && write_all(fd, &hdr, sizeof(hdr)) &&
+		write_all(fd, blocks, hdr.blocks_num * sizeof(*blocks)) &&
+		(fcntl(fd, F_ADD_SEALS, BIOS_CODE_SEALS) == 0);
+
+	const int err = errno;
+
+	free(ctx);
+	free(blocks);
+
+	if (!written) {
+		if (fd >= 0)
+			close(fd);
+
+		errno = err;
+		return false;
+	}
+	return map_fd_or_close(code, fd, img);
+}
+
+bool bios_code_open(struct bios_code *const code, const char *const path,
+		    const struct bios_image *const img)
+{
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+		return false;
+
+	return map_fd_or_close(code, fd, img);
+}
+
+bool bios_code_save(const struct bios_code *const code, const char *const path)
+{
+	char tmp_path[PATH_MAX];
+
+	if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >=
+	    (int)sizeof(tmp_path)) {
+		errno = ENAMETOOLONG;
+		return false;
+	}
+
+	const int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+			    0644);
+
+	if (fd < 0)
+		return false;
+
+	// Whoever maps the file meanwhile still sees the old one in full.
+	bool ok = write_all(fd, code->map, code->map_size) && (fsync(fd) == 0);
+	ok &= close(fd) == 0;
+
+	if (!ok || (rename(tmp_path, path) < 0)) {
+		const int err = errno;
+		unlink(tmp_path);
+
+		errno = err;
+		return false;
+	}
+	return true;
+}
+
+bool bios_code_inherited(void)
+{
+	return getenv(BIOS_CODE_ENV_FD) != NULL;
+}
+
+bool bios_code_open_inherited(struct bios_code *const code,
+			      const struct bios_image *const img)
+{
+	const char *const fd_str = getenv(BIOS_CODE_ENV_FD);
+
+	if (!fd_str) {
+		errno = ENOENT;
+		return false;
+	}
+
+	char *end;
+	const long fd = strtol(fd_str, &end, 10);
+
+	if ((*end != '\0') || (fd < 0) || (fd > INT32_MAX)) {
+		errno = EBADF;
+		return false;
+	}
+
+	// Without every seal in place, the blocks could still be modified
+	// after they were translated.
+	const int seals = fcntl((int)fd, F_GET_SEALS);
+
+	if (seals < 0)
+		return false;
+
+	if ((seals & BIOS_CODE_SEALS) != BIOS_CODE_SEALS) {
+		errno = EPERM;
+		return false;
+	}
+	return map_fd(code, (int)fd, img);
+}
+
+bool bios_code_share(const struct bios_code *const code)
+{
+	char fd_str[16];
+	snprintf(fd_str, sizeof(fd_str), "%d", code->fd);
+
+	return setenv(BIOS_CODE_ENV_FD, fd_str, true) == 0;
+}
+
+void bios_code_close(struct bios_code *const code)
+{
+	if (code->map) {
+		munmap((void *)(uintptr_t)code->map, code->map_size);
+		close(code->fd);
+	}
+
+	code->map = NULL;
+	code->fd = -1;
+	code->blocks.blocks = NULL;
+	code->blocks.blocks_num = 0;
+}
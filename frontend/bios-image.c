@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/bus.h"
+#include "frontend/bios-image.h"
+
+enum {
+	BIOS_IMAGE_SEALS =
+		F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE
+};
+
+static u64 bios_hash(const u8 *const data)
+{
+	u64 hash = UINT64_C(0xCBF29CE484222325);
+
+	for (size_t i = 0; i < BIOS_SIZE; ++i) {
+		hash ^= data[i];
+		hash *= UINT64_C(0x00000100000001B3);
+	}
+	return hash;
+}
+
+static bool map_fd(struct bios_image *const img, const int fd)
+{
+	struct stat st;
+
+	if (fstat(fd, &st) < 0)
+		return false;
+
+	if (st.st_size != BIOS_SIZE) {
+		errno = EINVAL;
+		return false;
+	}
+
+	void *const data = mmap(NULL, BIOS_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	img->data = data;
+	img->fd = fd;
+
+	return true;
+}
+
+static bool write_all(const int fd, const u8 *data, size_t size)
+{
+	while (size) {
+		const ssize_t num_written = write(fd, data, size);
+
+		if (num_written < 0) {
+			if (errno == EINTR)
+				continue;
+
+			return false;
+		}
+		data += num_written;
+		size -= num_written;
+	}
+	return true;
+}
+
+bool bios_image_open(struct bios_image *const img, const char *const path)
+{
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+		return false;
+
+	if (!map_fd(img, fd)) {
+		const int err = errno;
+
+		close(fd);
+		errno = err;
+
+		return false;
+	}
+
+	img->hash = bios_hash(img->data);
+	img->sealed = false;
+
+	return true;
+}
+
+bool bios_image_inherited(void)
+{
+	return getenv(BIOS_IMAGE_ENV_FD) && getenv(BIOS_IMAGE_ENV_HASH);
+}
+
+bool bios_image_open_inherited(struct bios_image *const img)
+{
+	const char *const fd_str = getenv(BIOS_IMAGE_ENV_FD);
+	const char *const hash_str = getenv(BIOS_IMAGE_ENV_HASH);
+
+	if (!fd_str || !hash_str) {
+		errno = ENOENT;
+		return false;
+	}
+
+	char *end;
+	const long fd = strtol(fd_str, &end, 10);
+
+	if ((*end != '\0') || (fd < 0) || (fd > INT32_MAX)) {
+		errno = EBADF;
+		return false;
+	}
+
+	const u64 hash = strtoull(hash_str, &end, 16);
+
+	if (*end != '\0') {
+		errno = EINVAL;
+		return false;
+	}
+
+	// Without every seal in place, the parent (or anybody else holding the
+	// descriptor) could still modify the image after it was validated.
+	const int seals = fcntl((int)fd, F_GET_SEALS);
+
+	if (seals < 0)
+		return false;
+
+	if ((seals & BIOS_IMAGE_SEALS) != BIOS_IMAGE_SEALS) {
+		errno = EPERM;
+		return false;
+	}
+
+	// The parent validated the contents before sealing them, so beyond the
+	// size check in map_fd() they are taken as they are, and so is the hash
+	// it exported.
+	if (!map_fd(img, (int)fd))
+		return false;
+
+	img->hash = hash;
+	img->sealed = true;
+
+	return true;
+}
+
+bool bios_image_expect(const struct bios_image *const img,
+		       const char *const hash)
+{
+	char *end;
+	const u64 expect = strtoull(hash, &end, 16);
+
+	return (*hash != '\0') && (*end == '\0') && (img->hash == expect);
+}
+
+bool bios_image_share(struct bios_image *const img)
+{
+	if (!img->sealed) {
+		// The descriptor is deliberately not close-on-exec; handing it
+		// down to children is the whole point.
+		const int fd = memfd_create("psycho-bios", MFD_ALLOW_SEALING);
+
+		if (fd < 0)
+			return false;
+
+		if (!write_all(fd, img->data, BIOS_SIZE) ||
+		    (fcntl(fd, F_ADD_SEALS, BIOS_IMAGE_SEALS) < 0)) {
+			const int err = errno;
+
+			close(fd);
+			errno = err;
+
+			return false;
+		}
+
+		// Switch over to the sealed copy so that the parent shares the
+		// same pages as its children.
+		const u64 hash = img->hash;
+		bios_image_close(img);
+
+		if (!map_fd(img, fd)) {
+			const int err = errno;
+
+			close(fd);
+			errno = err;
+
+			return false;
+		}
+
+		img->hash = hash;
+		img->sealed = true;
+	}
+
+	char fd_str[16];
+	char hash_str[17];
+
+	snprintf(fd_str, sizeof(fd_str), "%d", img->fd);
+	snprintf(hash_str, sizeof(hash_str), "%016" PRIX64, img->hash);
+
+	return (setenv(BIOS_IMAGE_ENV_FD, fd_str, true) == 0) &&
+	       (setenv(BIOS_IMAGE_ENV_HASH, hash_str, true) == 0);
+}
+
+void bios_image_close(struct bios_image *const img)
+{
+	if (img->data) {
+		munmap((void *)(uintptr_t)img->data, BIOS_SIZE);
+		close(img->fd);
+	}
+
+	img->data = NULL;
+	img->fd = -1;
+}
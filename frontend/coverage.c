@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "frontend/coverage.h"
+
+enum {
+	/** @brief Instructions per line of the annotated disassembly. */
+	COVERAGE_CHUNK_INSTRS = 16
+};
+
+struct coverage_region {
+	const char *name;
+	const u8 *bitmap;
+	size_t size;
+	u32 paddr;
+	u32 vaddr;
+};
+
+bool coverage_alloc(struct psycho_coverage_cfg *const cov)
+{
+	// clang-format off
+
+	*cov = (struct psycho_coverage_cfg) {
+		.edges		= calloc(1, PSYCHO_COVERAGE_EDGES_SIZE_DEFAULT),
+		.edges_size	= PSYCHO_COVERAGE_EDGES_SIZE_DEFAULT,
+		.exec_ram	= calloc(1, PSYCHO_COVERAGE_EXEC_RAM_SIZE),
+		.exec_bios	= calloc(1, PSYCHO_COVERAGE_EXEC_BIOS_SIZE)
+	};
+
+	// clang-format on
+
+	if (!cov->edges || !cov->exec_ram || !cov->exec_bios) {
+		coverage_free(cov);
+		return false;
+	}
+	return true;
+}
+
+void coverage_clear(struct psycho_coverage_cfg *const cov)
+{
+	memset(cov->edges, 0, cov->edges_size);
+	memset(cov->exec_ram, 0, PSYCHO_COVERAGE_EXEC_RAM_SIZE);
+	memset(cov->exec_bios, 0, PSYCHO_COVERAGE_EXEC_BIOS_SIZE);
+}
+
+void coverage_merge(struct psycho_coverage_cfg *const dst,
+		    const struct psycho_coverage_cfg *const src)
+{
+	for (size_t i = 0; i < dst->edges_size; ++i) {
+		const uint sum = dst->edges[i] + src->edges[i];
+		dst->edges[i] = (sum > UINT8_MAX) ? UINT8_MAX : sum;
+	}
+
+	for (size_t i = 0; i < PSYCHO_COVERAGE_EXEC_RAM_SIZE; ++i)
+		dst->exec_ram[i] |= src->exec_ram[i];
+
+	for (size_t i = 0; i < PSYCHO_COVERAGE_EXEC_BIOS_SIZE; ++i)
+		dst->exec_bios[i] |= src->exec_bios[i];
+}
+
+bool coverage_write_edges(const struct psycho_coverage_cfg *const cov,
+			  FILE *const out)
+{
+	return fwrite(cov->edges, 1, cov->edges_size, out) == cov->edges_size;
+}
+
+bool coverage_write_exec(const struct psycho_coverage_cfg *const cov,
+			 FILE *const out)
+{
+	return (fwrite(cov->exec_ram, 1, PSYCHO_COVERAGE_EXEC_RAM_SIZE, out) ==
+		PSYCHO_COVERAGE_EXEC_RAM_SIZE) &&
+	       (fwrite(cov->exec_bios, 1, PSYCHO_COVERAGE_EXEC_BIOS_SIZE,
+		       out) == PSYCHO_COVERAGE_EXEC_BIOS_SIZE);
+}
+
+static bool word_executed(const u8 *const bitmap, const size_t word)
+{
+	return bitmap[word / 8] & (1 << (word % 8));
+}
+
+static size_t bits_count(const u8 *const bitmap, const size_t size)
+{
+	size_t num = 0;
+
+	for (size_t i = 0; i < size; ++i)
+		num += __builtin_popcount(bitmap[i]);
+
+	return num;
+}
+
+static void region_write(struct psycho_ctx *const ctx,
+			 const struct coverage_region *const region,
+			 FILE *const out)
+{
+	const size_t num_words = region->size * 8;
+	bool gap = false;
+
+	for (size_t chunk = 0; chunk < num_words;
+	     chunk += COVERAGE_CHUNK_INSTRS) {
+		// Each chunk covers exactly two bytes of the bitmap, so a chunk
+		// with nothing executed can be skipped without testing each
+		// bit.
+		if (!region->bitmap[chunk / 8] &&
+		    !region->bitmap[(chunk / 8) + 1]) {
+			gap = true;
+			continue;
+		}
+
+		if (gap)
+			fputs("\t...\n", out);
+
+		gap = false;
+
+		const size_t end = chunk + COVERAGE_CHUNK_INSTRS;
+
+		for (size_t word = chunk; word < end; ++word) {
+			const u32 off = word * sizeof(u32);
+			const u32 pc = region->vaddr + off;
+			const u32 instr =
+				psycho_bus_peek_word(ctx, region->paddr + off);
+
+			psycho_disasm_instr(ctx, instr, pc);
+
+			fprintf(out, "%c 0x%08X: %08X  %s\n",
+				word_executed(region->bitmap, word) ? '+' : ' ',
+				pc, instr, ctx->disasm.result.str);
+		}
+	}
+}
+
+void coverage_write_annotated(struct psycho_ctx *const ctx,
+			      const struct psycho_coverage_cfg *const cov,
+			      FILE *const out)
+{
+	const struct coverage_region regions[] = {
+		// clang-format off
+
+		{
+			.name	= "ram",
+			.bitmap	= cov->exec_ram,
+			.size	= PSYCHO_COVERAGE_EXEC_RAM_SIZE,
+			.paddr	= RAM_ADDR_START,
+			.vaddr	= 0x80000000 | RAM_ADDR_START
+		},
+		{
+			.name	= "bios",
+			.bitmap	= cov->exec_bios,
+			.size	= PSYCHO_COVERAGE_EXEC_BIOS_SIZE,
+			.paddr	= BIOS_ADDR_START,
+			.vaddr	= 0xA0000000 | BIOS_ADDR_START
+		}
+
+		// clang-format on
+	};
+
+	size_t num_edges = 0;
+
+	for (size_t i = 0; i < cov->edges_size; ++i)
+		num_edges += cov->edges[i] != 0;
+
+	fprintf(out, "# edges: %zu of %zu map entries hit\n", num_edges,
+		cov->edges_size);
+
+	for (size_t i = 0; i < (sizeof(regions) / sizeof(regions[0])); ++i)
+		fprintf(out, "# %s: %zu instructions executed\n",
+			regions[i].name,
+			bits_count(regions[i].bitmap, regions[i].size));
+
+	for (size_t i = 0; i < (sizeof(regions) / sizeof(regions[0])); ++i) {
+		fprintf(out, "\n[%s]\n", regions[i].name);
+		region_write(ctx, &regions[i], out);
+	}
+}
+
+void coverage_free(struct psycho_coverage_cfg *const cov)
+{
+	free(cov->edges);
+	free(cov->exec_ram);
+	free(cov->exec_bios);
+
+	memset(cov, 0, sizeof(*cov));
+}
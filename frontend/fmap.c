@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "frontend/fmap.h"
+
+enum {
+	FMAP_STREAM_CHUNK_SIZE = 64 * 1024,
+};
+
+static bool map_regular(struct fmap *const map, const int fd, const size_t size)
+{
+	void *const data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	// Inputs are consumed front to back exactly once, so read ahead as
+	// aggressively as the kernel allows and drop pages behind us. Neither
+	// hint is required for correctness.
+	madvise(data, size, MADV_SEQUENTIAL);
+	madvise(data, size, MADV_WILLNEED);
+
+	map->data = data;
+	map->size = size;
+	map->mapped = true;
+
+	return true;
+}
+
+static bool stream(struct fmap *const map, const int fd)
+{
+	u8 *buf = NULL;
+	size_t size = 0;
+	size_t capacity = 0;
+
+	for (;;) {
+		if ((capacity - size) < FMAP_STREAM_CHUNK_SIZE) {
+			const size_t new_capacity =
+				capacity ? (capacity * 2) :
+					   FMAP_STREAM_CHUNK_SIZE;
+
+			u8 *const new_buf = realloc(buf, new_capacity);
+
+			if (!new_buf) {
+				free(buf);
+				return false;
+			}
+			buf = new_buf;
+			capacity = new_capacity;
+		}
+
+		const ssize_t num_read = read(fd, &buf[size], capacity - size);
+
+		if (num_read < 0) {
+			if (errno == EINTR)
+				continue;
+
+			const int err = errno;
+
+			free(buf);
+			errno = err;
+
+			return false;
+		}
+
+		if (num_read == 0)
+			break;
+
+		size += num_read;
+	}
+
+	map->data = buf;
+	map->size = size;
+	map->mapped = false;
+
+	return true;
+}
+
+bool fmap_open_fd(struct fmap *const map, const int fd)
+{
+	struct stat st;
+
+	if (fstat(fd, &st) < 0)
+		return false;
+
+	// Empty regular files can't be mapped, and files like those in /proc
+	// report a size of zero anyway; let the streaming path sort them out.
+	if (S_ISREG(st.st_mode) && (st.st_size > 0) &&
+	    map_regular(map, fd, st.st_size))
+		return true;
+
+	return stream(map, fd);
+}
+
+bool fmap_open(struct fmap *const map, const char *const path)
+{
+	if (strcmp(path, FMAP_PATH_STDIN) == 0)
+		return fmap_open_fd(map, STDIN_FILENO);
+
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+		return false;
+
+	const bool ret = fmap_open_fd(map, fd);
+	const int err = errno;
+
+	close(fd);
+	errno = err;
+
+	return ret;
+}
+
+void fmap_close(struct fmap *const map)
+{
+	void *const data = (void *)(uintptr_t)map->data;
+
+	if (map->mapped)
+		munmap(data, map->size);
+	else
+		free(data);
+
+	map->data = NULL;
+	map->size = 0;
+	map->mapped = false;
+}
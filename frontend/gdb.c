@@ -0,0 +1,960 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <errno.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "core/hooks.h"
+#include "frontend/gdb.h"
+
+enum {
+	// The number of instructions run between checks for an interrupt from
+	// the debugger while continuing.
+	GDB_RUN_SLICE = 65536,
+
+	// GDB's numbering of the MIPS registers, as given by target.xml.
+	GDB_REG_GPR = 0,
+	GDB_REG_SR = 32,
+	GDB_REG_LO = 33,
+	GDB_REG_HI = 34,
+	GDB_REG_BADVADDR = 35,
+	GDB_REG_CAUSE = 36,
+	GDB_REG_PC = 37,
+	GDB_REG_FPR = 38,
+	GDB_REG_FCSR = 70,
+	GDB_REG_FIR = 71,
+	GDB_REG_COP0 = 72,
+	GDB_REG_NUM = GDB_REG_COP0 + 8,
+
+	GDB_SIGINT = 2,
+	GDB_SIGTRAP = 5
+};
+
+// The COP0 registers GDB knows nothing about, exposed from GDB_REG_COP0 on.
+static const struct {
+	const char *name;
+	uint reg;
+} cop0_regs[GDB_REG_NUM - GDB_REG_COP0] = {
+	// clang-format off
+
+	{ "bpc",	CPU_COP0_BPC	},
+	{ "bda",	CPU_COP0_BDA	},
+	{ "tar",	CPU_COP0_TAR	},
+	{ "dcic",	CPU_COP0_DCIC	},
+	{ "bdam",	CPU_COP0_BDAM	},
+	{ "bpcm",	CPU_COP0_BPCM	},
+	{ "epc",	CPU_COP0_EPC	},
+	{ "prid",	CPU_COP0_PRID	}
+
+	// clang-format on
+};
+
+static const char hex_digits[] = "0123456789abcdef";
+
+static int hex_value(const char c)
+{
+	if ((c >= '0') && (c <= '9'))
+		return c - '0';
+
+	if ((c >= 'a') && (c <= 'f'))
+		return c - 'a' + 10;
+
+	if ((c >= 'A') && (c <= 'F'))
+		return c - 'A' + 10;
+
+	return -1;
+}
+
+static char *hex_put_u8(char *dst, const u8 byte)
+{
+	*dst++ = hex_digits[byte >> 4];
+	*dst++ = hex_digits[byte & 0x0F];
+
+	return dst;
+}
+
+// Registers are sent in target byte order, which is little endian.
+static char *hex_put_u32(char *dst, const u32 word)
+{
+	for (uint i = 0; i < sizeof(u32); ++i)
+		dst = hex_put_u8(dst, (u8)(word >> (i * 8)));
+
+	return dst;
+}
+
+static bool hex_get_u8(const char **const src, u8 *const byte)
+{
+	const int hi = hex_value((*src)[0]);
+
+	if (hi < 0)
+		return false;
+
+	const int lo = hex_value((*src)[1]);
+
+	if (lo < 0)
+		return false;
+
+	*byte = (u8)((hi << 4) | lo);
+	*src += 2;
+
+	return true;
+}
+
+static bool hex_get_u32(const char **const src, u32 *const word)
+{
+	*word = 0;
+
+	for (uint i = 0; i < sizeof(u32); ++i) {
+		u8 byte;
+
+		if (!hex_get_u8(src, &byte))
+			return false;
+
+		*word |= (u32)byte << (i * 8);
+	}
+	return true;
+}
+
+// Parses a big endian hex number, as used for addresses and lengths.
+static bool hex_get_num(const char **const src, u32 *const num)
+{
+	const char *p = *src;
+	*num = 0;
+
+	while (hex_value(*p) >= 0)
+		*num = (*num << 4) | (u32)hex_value(*p++);
+
+	if (p == *src)
+		return false;
+
+	*src = p;
+	return true;
+}
+
+static bool conn_write(struct gdb *const gdb, const void *const data,
+		       const size_t size)
+{
+	const char *p = data;
+	size_t left = size;
+
+	while (left) {
+		const ssize_t n = send(gdb->fd, p, left, MSG_NOSIGNAL);
+
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+
+			return false;
+		}
+
+		p += n;
+		left -= (size_t)n;
+	}
+	return true;
+}
+
+// Returns the next byte received, or -1 if the connection was lost.
+static int conn_getc(struct gdb *const gdb)
+{
+	if (gdb->recv_pos == gdb->recv_len) {
+		ssize_t n;
+
+		do
+			n = recv(gdb->fd, gdb->recv_buf, sizeof(gdb->recv_buf),
+				 0);
+		while ((n < 0) && (errno == EINTR));
+
+		if (n <= 0)
+			return -1;
+
+		gdb->recv_pos = 0;
+		gdb->recv_len = (size_t)n;
+	}
+	return (u8)gdb->recv_buf[gdb->recv_pos++];
+}
+
+// Returns whether a byte can be read without blocking.
+static bool conn_pending(struct gdb *const gdb)
+{
+	if (gdb->recv_pos != gdb->recv_len)
+		return true;
+
+	struct pollfd pfd = { .fd = gdb->fd, .events = POLLIN };
+	return poll(&pfd, 1, 0) > 0;
+}
+
+static bool packet_send(struct gdb *const gdb, const char *const data)
+{
+	const size_t len = strlen(data);
+	u8 checksum = 0;
+
+	for (size_t i = 0; i < len; ++i)
+		checksum += (u8)data[i];
+
+	char trailer[3] = { '#' };
+	hex_put_u8(&trailer[1], checksum);
+
+	for (;;) {
+		if (!conn_write(gdb, "$", 1) || !conn_write(gdb, data, len) ||
+		    !conn_write(gdb, trailer, sizeof(trailer)))
+			return false;
+
+		if (gdb->no_ack)
+			return true;
+
+		int c;
+
+		do
+			c = conn_getc(gdb);
+		while ((c != '+') && (c != '-') && (c != -1));
+
+		if (c == '+')
+			return true;
+
+		if (c == -1)
+			return false;
+	}
+}
+
+// Receives a packet into @p buf, NUL-terminated; returns false if the
+// connection was lost.
+static bool packet_recv(struct gdb *const gdb, char *const buf)
+{
+	for (;;) {
+		int c;
+
+		// Anything outside of a packet, such as an interrupt request
+		// while already stopped or a stray acknowledgement, is moot.
+		do
+			c = conn_getc(gdb);
+		while ((c != '$') && (c != -1));
+
+		if (c == -1)
+			return false;
+
+		size_t len = 0;
+		u8 checksum = 0;
+		bool overflow = false;
+
+		while (((c = conn_getc(gdb)) != '#') && (c != -1)) {
+			checksum += (u8)c;
+
+			if (len < GDB_PACKET_SIZE_MAX)
+				buf[len++] = (char)c;
+			else
+				overflow = true;
+		}
+
+		if (c == -1)
+			return false;
+
+		const int hi = conn_getc(gdb);
+		const int lo = conn_getc(gdb);
+
+		if ((hi == -1) || (lo == -1))
+			return false;
+
+		buf[len] = '\0';
+
+		if (gdb->no_ack)
+			return true;
+
+		const bool valid = !overflow &&
+				   (hex_value((char)hi) == (checksum >> 4)) &&
+				   (hex_value((char)lo) == (checksum & 0x0F));
+
+		if (!conn_write(gdb, valid ? "+" : "-", 1))
+			return false;
+
+		if (valid)
+			return true;
+	}
+}
+
+static bool reply_stop(struct gdb *const gdb, const uint signal)
+{
+	char buf[4] = { 'S' };
+	hex_put_u8(&buf[1], (u8)signal);
+
+	return packet_send(gdb, buf);
+}
+
+static bool reply_error(struct gdb *const gdb)
+{
+	return packet_send(gdb, "E01");
+}
+
+static u32 reg_get(const struct psycho_cpu *const cpu, const uint reg)
+{
+	switch (reg) {
+	case GDB_REG_GPR ... GDB_REG_GPR + CPU_GPR_NUM - 1:
+		return cpu->gpr[reg - GDB_REG_GPR];
+
+	case GDB_REG_SR:
+		return cpu->cop0[CPU_COP0_SR];
+
+	case GDB_REG_LO:
+		return cpu->lo;
+
+	case GDB_REG_HI:
+		return cpu->hi;
+
+	case GDB_REG_BADVADDR:
+		return cpu->cop0[CPU_COP0_BADA];
+
+	case GDB_REG_CAUSE:
+		return cpu->cop0[CPU_COP0_CAUSE];
+
+	case GDB_REG_PC:
+		return cpu->pc;
+
+	case GDB_REG_COP0 ... GDB_REG_NUM - 1:
+		return cpu->cop0[cop0_regs[reg - GDB_REG_COP0].reg];
+
+	// The R3000A has no FPU; GDB insists on one regardless.
+	default:
+		return 0;
+	}
+}
+
+static void pc_set(struct psycho_cpu *const cpu, const u32 pc)
+{
+	cpu->pc = pc;
+	cpu->next_pc = pc + sizeof(u32);
+	cpu->in_branch_delay_slot = false;
+	cpu->next_in_branch_delay_slot = false;
+}
+
+static void reg_set(struct psycho_ctx *const ctx, const uint reg,
+		    const u32 val)
+{
+	struct psycho_cpu *const cpu = &ctx->cpu;
+
+	switch (reg) {
+	case GDB_REG_GPR + 1 ... GDB_REG_GPR + CPU_GPR_NUM - 1:
+		cpu->gpr[reg - GDB_REG_GPR] = val;
+		return;
+
+	case GDB_REG_SR:
+		psycho_cpu_cop0_set(ctx, CPU_COP0_SR, val);
+		return;
+
+	case GDB_REG_LO:
+		cpu->lo = val;
+		return;
+
+	case GDB_REG_HI:
+		cpu->hi = val;
+		return;
+
+	case GDB_REG_BADVADDR:
+		cpu->cop0[CPU_COP0_BADA] = val;
+		return;
+
+	case GDB_REG_CAUSE:
+		cpu->cop0[CPU_COP0_CAUSE] = val;
+		return;
+
+	case GDB_REG_PC:
+		pc_set(cpu, val);
+		return;
+
+	case GDB_REG_COP0 ... GDB_REG_NUM - 1:
+		psycho_cpu_cop0_set(ctx, cop0_regs[reg - GDB_REG_COP0].reg,
+				    val);
+		return;
+
+	default:
+		return;
+	}
+}
+
+static bool handle_regs_read(struct gdb *const gdb)
+{
+	char buf[(GDB_REG_NUM * sizeof(u32) * 2) + 1];
+	char *p = buf;
+
+	for (uint reg = 0; reg < GDB_REG_NUM; ++reg)
+		p = hex_put_u32(p, reg_get(&gdb->ctx->cpu, reg));
+
+	*p = '\0';
+	return packet_send(gdb, buf);
+}
+
+static bool handle_regs_write(struct gdb *const gdb, const char *args)
+{
+	for (uint reg = 0; (reg < GDB_REG_NUM) && *args; ++reg) {
+		u32 val;
+
+		if (!hex_get_u32(&args, &val))
+			return reply_error(gdb);
+
+		reg_set(gdb->ctx, reg, val);
+	}
+	return packet_send(gdb, "OK");
+}
+
+static bool handle_reg_read(struct gdb *const gdb, const char *args)
+{
+	u32 reg;
+
+	if (!hex_get_num(&args, &reg) || (reg >= GDB_REG_NUM))
+		return reply_error(gdb);
+
+	char buf[(sizeof(u32) * 2) + 1];
+	*hex_put_u32(buf, reg_get(&gdb->ctx->cpu, reg)) = '\0';
+
+	return packet_send(gdb, buf);
+}
+
+static bool handle_reg_write(struct gdb *const gdb, const char *args)
+{
+	u32 reg;
+	u32 val;
+
+	if (!hex_get_num(&args, &reg) || (reg >= GDB_REG_NUM) ||
+	    (*args++ != '=') || !hex_get_u32(&args, &val))
+		return reply_error(gdb);
+
+	reg_set(gdb->ctx, reg, val);
+	return packet_send(gdb, "OK");
+}
+
+static bool handle_mem_read(struct gdb *const gdb, const char *args)
+{
+	u32 addr;
+	u32 len;
+
+	if (!hex_get_num(&args, &addr) || (*args++ != ',') ||
+	    !hex_get_num(&args, &len))
+		return reply_error(gdb);
+
+	if (len > (GDB_PACKET_SIZE_MAX / 2))
+		len = GDB_PACKET_SIZE_MAX / 2;
+
+	u8 data[GDB_PACKET_SIZE_MAX / 2];
+
+	if (!psycho_bus_peek(gdb->ctx, addr, data, len))
+		return reply_error(gdb);
+
+	char buf[GDB_PACKET_SIZE_MAX + 1];
+	char *p = buf;
+
+	for (u32 i = 0; i < len; ++i)
+		p = hex_put_u8(p, data[i]);
+
+	*p = '\0';
+	return packet_send(gdb, buf);
+}
+
+static bool handle_mem_write(struct gdb *const gdb, const char *args)
+{
+	u32 addr;
+	u32 len;
+
+	if (!hex_get_num(&args, &addr) || (*args++ != ',') ||
+	    !hex_get_num(&args, &len) || (*args++ != ':') ||
+	    (len > (GDB_PACKET_SIZE_MAX / 2)))
+		return reply_error(gdb);
+
+	u8 data[GDB_PACKET_SIZE_MAX / 2];
+
+	for (u32 i = 0; i < len; ++i) {
+		if (!hex_get_u8(&args, &data[i]))
+			return reply_error(gdb);
+	}
+
+	if (!psycho_bus_poke(gdb->ctx, addr, data, len))
+		return reply_error(gdb);
+
+	return packet_send(gdb, "OK");
+}
+
+static void breakpoint_hook(struct psycho_ctx *const ctx, const u32 pc,
+			    void *const udata)
+{
+	(void)pc;
+	(void)udata;
+
+	psycho_hook_stop(ctx);
+}
+
+static struct gdb_breakpoint *breakpoint_find(struct gdb *const gdb,
+					      const u32 addr)
+{
+	for (uint i = 0; i < gdb->num_bps; ++i) {
+		if (gdb->bps[i].addr == addr)
+			return &gdb->bps[i];
+	}
+	return NULL;
+}
+
+static void breakpoint_remove(struct gdb *const gdb,
+			      struct gdb_breakpoint *const bp)
+{
+	psycho_hook_remove(gdb->ctx, bp->hook);
+	*bp = gdb->bps[--gdb->num_bps];
+}
+
+// Software and hardware breakpoints are one and the same, since neither
+// touches guest memory.
+static bool handle_breakpoint(struct gdb *const gdb, const char *args,
+			      const bool insert)
+{
+	u32 addr;
+
+	if ((*args != '0') && (*args != '1'))
+		return packet_send(gdb, "");
+
+	args++;
+
+	if ((*args++ != ',') || !hex_get_num(&args, &addr))
+		return reply_error(gdb);
+
+	struct gdb_breakpoint *const bp = breakpoint_find(gdb, addr);
+
+	if (!insert) {
+		if (bp)
+			breakpoint_remove(gdb, bp);
+
+		return packet_send(gdb, "OK");
+	}
+
+	if (bp)
+		return packet_send(gdb, "OK");
+
+	if (gdb->num_bps >= GDB_BREAKPOINTS_MAX)
+		return reply_error(gdb);
+
+	const u32 hook = psycho_hook_add(gdb->ctx, addr, breakpoint_hook, NULL);
+
+	if (!hook)
+		return reply_error(gdb);
+
+	gdb->bps[gdb->num_bps++] = (struct gdb_breakpoint){
+		// clang-format off
+
+		.addr	= addr,
+		.hook	= hook
+
+		// clang-format on
+	};
+
+	return packet_send(gdb, "OK");
+}
+
+static bool handle_step(struct gdb *const gdb, const char *args)
+{
+	u32 addr;
+
+	if (hex_get_num(&args, &addr))
+		pc_set(&gdb->ctx->cpu, addr);
+
+	// A breakpoint on the instruction being stepped over has already been
+	// reported, so step past it.
+	if (!psycho_step(gdb->ctx))
+		psycho_step(gdb->ctx);
+
+	return reply_stop(gdb, GDB_SIGTRAP);
+}
+
+// Runs until a breakpoint is hit or the debugger interrupts; returns false if
+// the connection was lost.
+static bool handle_continue(struct gdb *const gdb, const char *args)
+{
+	u32 addr;
+
+	if (hex_get_num(&args, &addr))
+		pc_set(&gdb->ctx->cpu, addr);
+
+	for (;;) {
+		if (psycho_run(gdb->ctx, GDB_RUN_SLICE) != GDB_RUN_SLICE)
+			return reply_stop(gdb, GDB_SIGTRAP);
+
+		if (!conn_pending(gdb))
+			continue;
+
+		const int c = conn_getc(gdb);
+
+		if (c == -1)
+			return false;
+
+		if (c == 0x03)
+			return reply_stop(gdb, GDB_SIGINT);
+	}
+}
+
+// Builds the target description on first use; it names the registers that
+// GDB doesn't know an R3000A has.
+static const char *target_xml(void)
+{
+	static char xml[8192];
+
+	if (xml[0])
+		return xml;
+
+	char *p = xml;
+	char *const end = &xml[sizeof(xml)];
+
+#define XML(...) (p += snprintf(p, (size_t)(end - p), __VA_ARGS__))
+
+	XML("<?xml version=\"1.0\"?>"
+	    "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+	    "<target version=\"1.0\">"
+	    "<architecture>mips:3000</architecture>"
+	    "<feature name=\"org.gnu.gdb.mips.cpu\">");
+
+	for (uint i = 0; i < CPU_GPR_NUM; ++i)
+		XML("<reg name=\"r%u\" bitsize=\"32\" regnum=\"%u\"/>", i,
+		    GDB_REG_GPR + i);
+
+	XML("<reg name=\"lo\" bitsize=\"32\" regnum=\"%d\"/>"
+	    "<reg name=\"hi\" bitsize=\"32\" regnum=\"%d\"/>"
+	    "<reg name=\"pc\" bitsize=\"32\" regnum=\"%d\"/>"
+	    "</feature>"
+	    "<feature name=\"org.gnu.gdb.mips.cp0\">"
+	    "<reg name=\"status\" bitsize=\"32\" regnum=\"%d\"/>"
+	    "<reg name=\"badvaddr\" bitsize=\"32\" regnum=\"%d\"/>"
+	    "<reg name=\"cause\" bitsize=\"32\" regnum=\"%d\"/>"
+	    "</feature>"
+	    "<feature name=\"org.gnu.gdb.mips.fpu\">",
+	    GDB_REG_LO, GDB_REG_HI, GDB_REG_PC, GDB_REG_SR, GDB_REG_BADVADDR,
+	    GDB_REG_CAUSE);
+
+	for (uint i = 0; i < 32; ++i)
+		XML("<reg name=\"f%u\" bitsize=\"32\" type=\"ieee_single\" "
+		    "regnum=\"%u\"/>",
+		    i, GDB_REG_FPR + i);
+
+	XML("<reg name=\"fcsr\" bitsize=\"32\" group=\"float\" regnum=\"%d\"/>"
+	    "<reg name=\"fir\" bitsize=\"32\" group=\"float\" regnum=\"%d\"/>"
+	    "</feature>"
+	    "<feature name=\"org.psycho.cop0\">",
+	    GDB_REG_FCSR, GDB_REG_FIR);
+
+	for (uint i = 0; i < (GDB_REG_NUM - GDB_REG_COP0); ++i)
+		XML("<reg name=\"%s\" bitsize=\"32\" group=\"system\" "
+		    "regnum=\"%u\"/>",
+		    cop0_regs[i].name, GDB_REG_COP0 + i);
+
+	XML("</feature></target>");
+
+#undef XML
+
+	return xml;
+}
+
+// qXfer:features:read:target.xml:OFFSET,LENGTH
+static bool handle_features_read(struct gdb *const gdb, const char *args)
+{
+	static const char annex[] = "target.xml:";
+	u32 offset;
+	u32 len;
+
+	if (strncmp(args, annex, sizeof(annex) - 1) != 0)
+		return packet_send(gdb, "E00");
+
+	args += sizeof(annex) - 1;
+
+	if (!hex_get_num(&args, &offset) || (*args++ != ',') ||
+	    !hex_get_num(&args, &len))
+		return reply_error(gdb);
+
+	const char *const xml = target_xml();
+	const size_t xml_len = strlen(xml);
+
+	if (offset > xml_len)
+		return reply_error(gdb);
+
+	if (len > (GDB_PACKET_SIZE_MAX - 1))
+		len = GDB_PACKET_SIZE_MAX - 1;
+
+	const size_t left = xml_len - offset;
+	const size_t chunk = (left < len) ? left : len;
+
+	// The description has none of the characters which would need
+	// escaping in a binary reply.
+	char buf[GDB_PACKET_SIZE_MAX + 1];
+
+	buf[0] = (chunk == left) ? 'l' : 'm';
+	memcpy(&buf[1], &xml[offset], chunk);
+	buf[chunk + 1] = '\0';
+
+	return packet_send(gdb, buf);
+}
+
+static bool handle_query(struct gdb *const gdb, const char *const packet)
+{
+	static const char xfer[] = "qXfer:features:read:";
+
+	if (strncmp(packet, "qSupported", sizeof("qSupported") - 1) == 0) {
+		char buf[96];
+
+		snprintf(buf, sizeof(buf),
+			 "PacketSize=%X;qXfer:features:read+;"
+			 "QStartNoAckMode+",
+			 (uint)GDB_PACKET_SIZE_MAX);
+
+		return packet_send(gdb, buf);
+	}
+
+	if (strncmp(packet, xfer, sizeof(xfer) - 1) == 0)
+		return handle_features_read(gdb, &packet[sizeof(xfer) - 1]);
+
+	if (strcmp(packet, "qAttached") == 0)
+		return packet_send(gdb, "1");
+
+	if (strcmp(packet, "qC") == 0)
+		return packet_send(gdb, "QC1");
+
+	if (strcmp(packet, "qfThreadInfo") == 0)
+		return packet_send(gdb, "m1");
+
+	if (strcmp(packet, "qsThreadInfo") == 0)
+		return packet_send(gdb, "l");
+
+	if (strcmp(packet, "QStartNoAckMode") == 0) {
+		if (!packet_send(gdb, "OK"))
+			return false;
+
+		gdb->no_ack = true;
+		return true;
+	}
+
+	return packet_send(gdb, "");
+}
+
+static void breakpoints_clear(struct gdb *const gdb)
+{
+	while (gdb->num_bps)
+		breakpoint_remove(gdb, &gdb->bps[0]);
+}
+
+bool gdb_listen(struct gdb *const gdb, struct psycho_ctx *const ctx,
+		const char *const addr)
+{
+	memset(gdb, 0, sizeof(*gdb));
+
+	gdb->ctx = ctx;
+	gdb->fd = -1;
+
+	char *end;
+	const unsigned long port = strtoul(addr, &end, 10);
+
+	if ((*addr != '\0') && (*end == '\0')) {
+		if (port > UINT16_MAX) {
+			errno = EINVAL;
+			return false;
+		}
+
+		const struct sockaddr_in sin = {
+			// clang-format off
+
+			.sin_family	= AF_INET,
+			.sin_port	= htons((u16)port),
+			.sin_addr	= { htonl(INADDR_LOOPBACK) }
+
+			// clang-format on
+		};
+
+		gdb->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+		if (gdb->listen_fd < 0)
+			return false;
+
+		const int one = 1;
+		setsockopt(gdb->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one,
+			   sizeof(one));
+
+		if (bind(gdb->listen_fd, (const struct sockaddr *)&sin,
+			 sizeof(sin)) < 0)
+			goto err;
+	} else {
+		struct sockaddr_un sun = { .sun_family = AF_UNIX };
+
+		if (strlen(addr) >= sizeof(sun.sun_path)) {
+			errno = ENAMETOOLONG;
+			return false;
+		}
+		strcpy(sun.sun_path, addr);
+
+		gdb->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+		if (gdb->listen_fd < 0)
+			return false;
+
+		unlink(addr);
+
+		if (bind(gdb->listen_fd, (const struct sockaddr *)&sun,
+			 sizeof(sun)) < 0)
+			goto err;
+
+		gdb->unix_path = addr;
+	}
+
+	if (listen(gdb->listen_fd, 1) < 0)
+		goto err;
+
+	return true;
+
+err:;
+	const int err = errno;
+
+	gdb_close(gdb);
+	errno = err;
+
+	return false;
+}
+
+bool gdb_accept(struct gdb *const gdb)
+{
+	do
+		gdb->fd = accept(gdb->listen_fd, NULL, NULL);
+	while ((gdb->fd < 0) && (errno == EINTR));
+
+	if (gdb->fd < 0)
+		return false;
+
+	// Packets are small and strictly request/response.
+	const int one = 1;
+	setsockopt(gdb->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	gdb->recv_pos = 0;
+	gdb->recv_len = 0;
+	gdb->no_ack = false;
+
+	return true;
+}
+
+enum gdb_result gdb_serve(struct gdb *const gdb)
+{
+	static char packet[GDB_PACKET_SIZE_MAX + 1];
+	enum gdb_result result = GDB_RESULT_DISCONNECTED;
+
+	while (packet_recv(gdb, packet)) {
+		const char *const args = &packet[1];
+		bool connected;
+
+		switch (packet[0]) {
+		case '?':
+			connected = reply_stop(gdb, GDB_SIGTRAP);
+			break;
+
+		case 'g':
+			connected = handle_regs_read(gdb);
+			break;
+
+		case 'G':
+			connected = handle_regs_write(gdb, args);
+			break;
+
+		case 'p':
+			connected = handle_reg_read(gdb, args);
+			break;
+
+		case 'P':
+			connected = handle_reg_write(gdb, args);
+			break;
+
+		case 'm':
+			connected = handle_mem_read(gdb, args);
+			break;
+
+		case 'M':
+			connected = handle_mem_write(gdb, args);
+			break;
+
+		case 'Z':
+		case 'z':
+			connected = handle_breakpoint(gdb, args,
+						      packet[0] == 'Z');
+			break;
+
+		case 's':
+			connected = handle_step(gdb, args);
+			break;
+
+		case 'c':
+			connected = handle_continue(gdb, args);
+			break;
+
+		case 'H':
+		case 'T':
+			connected = packet_send(gdb, "OK");
+			break;
+
+		case 'q':
+		case 'Q':
+			connected = handle_query(gdb, packet);
+			break;
+
+		case 'D':
+			packet_send(gdb, "OK");
+			result = GDB_RESULT_DETACHED;
+			goto done;
+
+		case 'k':
+			result = GDB_RESULT_KILLED;
+			goto done;
+
+		default:
+			connected = packet_send(gdb, "");
+			break;
+		}
+
+		if (!connected)
+			break;
+	}
+
+done:
+	breakpoints_clear(gdb);
+
+	close(gdb->fd);
+	gdb->fd = -1;
+
+	return result;
+}
+
+void gdb_close(struct gdb *const gdb)
+{
+	if (gdb->fd >= 0)
+		close(gdb->fd);
+
+	if (gdb->listen_fd >= 0)
+		close(gdb->listen_fd);
+
+	if (gdb->unix_path)
+		unlink(gdb->unix_path);
+
+	gdb->fd = -1;
+	gdb->listen_fd = -1;
+	gdb->unix_path = NULL;
+}
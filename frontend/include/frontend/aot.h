@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file aot.h Defines the loader for native modules built by psycho-aot.
+ *
+ * A native module is a shared object exporting a struct
+ * psycho_ir_native_module under @ref PSYCHO_IR_NATIVE_MODULE_SYMBOL. Once
+ * loaded, it is handed to the core through struct psycho_ir_cfg.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "core/ir.h"
+
+struct aot_module {
+	/** @brief The native blocks of the module. */
+	const struct psycho_ir_native_module *native;
+
+	/** @brief Why the module could not be loaded, if it could not. */
+	const char *error;
+
+	void *handle;
+};
+
+/**
+ * @brief Loads a native module.
+ *
+ * @param mod The module to initialize.
+ * @param path The path to the shared object.
+ * @returns true on success, or false with @ref aot_module.error set on
+ * failure.
+ */
+bool aot_module_open(struct aot_module *mod, const char *path);
+
+/**
+ * @brief Unloads a module loaded by @ref aot_module_open.
+ *
+ * The core must no longer be using it.
+ *
+ * @param mod The module to unload.
+ */
+void aot_module_close(struct aot_module *mod);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file bios-code.h Defines BIOS code translated once and shared between
+ * contexts.
+ *
+ * Translating the BIOS into IR blocks gives the same result every time, so
+ * it is done once and the blocks are kept in a sealed memory file, which is
+ * mapped read-only by every context running that BIOS and may be handed down
+ * to child processes much like the BIOS image itself. The blocks may also be
+ * saved to a file, so that they outlive the process which translated them.
+ *
+ * The blocks are tied to the hash of the BIOS image they were translated
+ * from, and to the revision of the translation, and are refused for anything
+ * else.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "core/ir.h"
+#include "frontend/bios-image.h"
+
+/** Environment variable holding the inherited BIOS code file descriptor. */
+#define BIOS_CODE_ENV_FD "PSYCHO_BIOS_CODE_FD"
+
+struct bios_code {
+	/** @brief The blocks, to be handed to the core in psycho_ir_cfg. */
+	struct psycho_ir_bios_blocks blocks;
+
+	/** @brief The mapping holding the blocks. */
+	const void *map;
+	size_t map_size;
+
+	/** @brief The file descriptor backing the mapping. */
+	int fd;
+};
+
+/**
+ * @brief Translates the code of a BIOS image into a sealed memory file.
+ *
+ * @param code The BIOS code to initialize.
+ * @param img The BIOS image to translate.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool bios_code_build(struct bios_code *code, const struct bios_image *img);
+
+/**
+ * @brief Maps BIOS code saved by @ref bios_code_save.
+ *
+ * @param code The BIOS code to initialize.
+ * @param path The path to the file.
+ * @param img The BIOS image the code has to have been translated from.
+ * @returns true on success, or false with `errno` set on failure; `ESTALE` if
+ * the file was translated from another BIOS or by another version.
+ */
+bool bios_code_open(struct bios_code *code, const char *path,
+		    const struct bios_image *img);
+
+/**
+ * @brief Saves BIOS code to a file, replacing it atomically.
+ *
+ * @param code The BIOS code to save.
+ * @param path The path to the file.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool bios_code_save(const struct bios_code *code, const char *path);
+
+/**
+ * @brief Determines whether or not BIOS code was handed down by a parent.
+ */
+bool bios_code_inherited(void);
+
+/**
+ * @brief Maps the BIOS code handed down by a parent process.
+ *
+ * @param code The BIOS code to initialize.
+ * @param img The BIOS image the code has to have been translated from.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool bios_code_open_inherited(struct bios_code *code,
+			      const struct bios_image *img);
+
+/**
+ * @brief Makes BIOS code built by @ref bios_code_build available to child
+ * processes.
+ *
+ * The sealed memory file is left open across `exec`, and its descriptor is
+ * exported to the environment for @ref bios_code_open_inherited.
+ *
+ * @param code The BIOS code to share.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool bios_code_share(const struct bios_code *code);
+
+/**
+ * @brief Unmaps BIOS code and releases its file descriptor.
+ *
+ * The core must no longer be using it.
+ *
+ * @param code The BIOS code to close.
+ */
+void bios_code_close(struct bios_code *code);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
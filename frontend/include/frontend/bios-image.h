@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file bios-image.h Defines a read-only BIOS image shared between contexts.
+ *
+ * The BIOS ROM is immutable and identical for every context, so rather than
+ * copying it into each process it is mapped read-only and shared. A supervisor
+ * process may also hand a sealed memory file descriptor down to its workers,
+ * in which case the image is read and validated once by the supervisor, and
+ * each worker maps the sealed copy and takes the hash the supervisor exported.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+
+#include "core/types.h"
+
+/** Environment variable holding the inherited BIOS file descriptor. */
+#define BIOS_IMAGE_ENV_FD "PSYCHO_BIOS_FD"
+
+/** Environment variable holding the hash of the inherited BIOS image. */
+#define BIOS_IMAGE_ENV_HASH "PSYCHO_BIOS_HASH"
+
+struct bios_image {
+	/** @brief The mapped BIOS image; always exactly `BIOS_SIZE` bytes. */
+	const u8 *data;
+
+	/** @brief FNV-1a hash of the BIOS image. */
+	u64 hash;
+
+	/** @brief The file descriptor backing the mapping. */
+	int fd;
+
+	/** @brief Whether or not @ref fd is a sealed memory file. */
+	bool sealed;
+};
+
+/**
+ * @brief Maps a BIOS image from a file and computes its hash.
+ *
+ * @param img The BIOS image to initialize.
+ * @param path The path to the BIOS file.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool bios_image_open(struct bios_image *img, const char *path);
+
+/**
+ * @brief Determines whether or not a BIOS image was handed down by a parent.
+ */
+bool bios_image_inherited(void);
+
+/**
+ * @brief Maps the BIOS image handed down by a parent process.
+ *
+ * The file descriptor must refer to a sealed memory file of exactly
+ * `BIOS_SIZE` bytes, so the image cannot change once mapped. Its contents are
+ * not hashed again; @ref bios_image.hash is the value exported by the parent.
+ *
+ * @param img The BIOS image to initialize.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool bios_image_open_inherited(struct bios_image *img);
+
+/**
+ * @brief Checks that a BIOS image is the one the user asked for.
+ *
+ * @param img The BIOS image to check.
+ * @param hash The expected hash, in hexadecimal.
+ * @returns true if @p img has the hash @p hash, or false if it does not or
+ * @p hash is not a hash at all.
+ */
+bool bios_image_expect(const struct bios_image *img, const char *hash);
+
+/**
+ * @brief Makes a BIOS image available to child processes.
+ *
+ * The image is copied once into a sealed memory file which is left open
+ * across `exec`, and its descriptor and hash are exported to the environment
+ * for @ref bios_image_open_inherited.
+ *
+ * @param img The BIOS image to share.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool bios_image_share(struct bios_image *img);
+
+/**
+ * @brief Unmaps a BIOS image and releases its file descriptor.
+ *
+ * @param img The BIOS image to close.
+ */
+void bios_image_close(struct bios_image *img);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/** @file clock.h Defines a monotonic clock for timing runs. */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "core/compiler.h"
+#include "core/types.h"
+
+enum { NSEC_PER_SEC = 1000000000 };
+
+/**
+ * @brief Returns the current time of the monotonic clock in nanoseconds.
+ */
+u64 clock_ns(void);
+
+/**
+ * @brief Converts a duration in nanoseconds to seconds.
+ *
+ * @param ns The duration in nanoseconds.
+ */
+ALWAYS_INLINE double clock_ns_to_secs(const u64 ns)
+{
+	return (double)ns / NSEC_PER_SEC;
+}
+
+/**
+ * @brief Computes a rate in millions of instructions per second.
+ *
+ * @param instructions The number of instructions executed.
+ * @param ns The time taken to execute them in nanoseconds.
+ */
+ALWAYS_INLINE double clock_mips(const u64 instructions, const u64 ns)
+{
+	if (!ns)
+		return 0;
+
+	// Instructions per nanosecond * 1000 = millions per second.
+	return ((double)instructions * 1000) / (double)ns;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
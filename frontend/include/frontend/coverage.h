@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file coverage.h Defines the host side of guest code coverage.
+ *
+ * Coverage buffers can be merged across runs, written as raw bitmaps, or
+ * written as a disassembly of every executed region annotated with which
+ * instructions were executed.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "core/coverage.h"
+#include "core/ctx.h"
+
+/**
+ * @brief Allocates zeroed coverage buffers, with an edge map of
+ * PSYCHO_COVERAGE_EDGES_SIZE_DEFAULT bytes.
+ *
+ * @returns false if out of memory.
+ */
+bool coverage_alloc(struct psycho_coverage_cfg *cov);
+
+void coverage_clear(struct psycho_coverage_cfg *cov);
+
+/**
+ * @brief Adds the coverage in @p src to @p dst.
+ *
+ * Edge counters saturate rather than wrap; executed bitmaps are combined.
+ * Both must have been allocated by coverage_alloc().
+ */
+void coverage_merge(struct psycho_coverage_cfg *dst,
+		    const struct psycho_coverage_cfg *src);
+
+/**
+ * @brief Writes the raw edge map.
+ *
+ * @returns false on a write error.
+ */
+bool coverage_write_edges(const struct psycho_coverage_cfg *cov, FILE *out);
+
+/**
+ * @brief Writes the RAM executed bitmap followed by the BIOS executed
+ * bitmap.
+ *
+ * @returns false on a write error.
+ */
+bool coverage_write_exec(const struct psycho_coverage_cfg *cov, FILE *out);
+
+/**
+ * @brief Writes a disassembly of each executed region of RAM and BIOS.
+ *
+ * Executed instructions are marked with `+`. The instructions are read from
+ * the memory of @p ctx, so for RAM this should be the context the coverage
+ * was collected from.
+ *
+ * @param ctx The psycho_ctx emulator context to disassemble with.
+ * @param cov The coverage to annotate with.
+ * @param out The file to write to.
+ */
+void coverage_write_annotated(struct psycho_ctx *ctx,
+			      const struct psycho_coverage_cfg *cov, FILE *out);
+
+void coverage_free(struct psycho_coverage_cfg *cov);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file fmap.h Defines a read-only file mapping layer for frontends.
+ *
+ * Regular files are mapped directly into memory so that their contents can be
+ * handed to the core without being copied. Anything which cannot be mapped,
+ * such as a pipe or a terminal, is streamed into a heap buffer instead.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "core/types.h"
+
+/** The path which refers to standard input. */
+#define FMAP_PATH_STDIN "-"
+
+struct fmap {
+	/** @brief The contents of the file. */
+	const u8 *data;
+
+	/** @brief The size of the file in bytes. */
+	size_t size;
+
+	/** @brief Whether @ref data is a mapping or a heap buffer. */
+	bool mapped;
+};
+
+/**
+ * @brief Opens a file read-only.
+ *
+ * @param map The file mapping to initialize.
+ * @param path The path to the file, or @ref FMAP_PATH_STDIN.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool fmap_open(struct fmap *map, const char *path);
+
+/**
+ * @brief Opens an already open file descriptor read-only.
+ *
+ * The file descriptor is not retained and may be closed once this returns.
+ *
+ * @param map The file mapping to initialize.
+ * @param fd The file descriptor to read from.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool fmap_open_fd(struct fmap *map, int fd);
+
+/**
+ * @brief Releases a file opened by @ref fmap_open or @ref fmap_open_fd.
+ *
+ * @param map The file mapping to close.
+ */
+void fmap_close(struct fmap *map);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file gdb.h Defines a GDB remote serial protocol stub.
+ *
+ * The stub listens on a TCP port of the loopback interface or on a Unix
+ * domain socket, and lets a single `gdb-multiarch` session inspect and drive
+ * an emulator context: registers (including the COP0 debug registers),
+ * memory, breakpoints, single-stepping and continuing.
+ *
+ * Breakpoints are core PC hooks, so a continued run which hits none of them
+ * executes at full psycho_run() speed.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "core/ctx.h"
+#include "core/types.h"
+
+enum {
+	/** @brief The maximum number of breakpoints set at once. */
+	GDB_BREAKPOINTS_MAX = 32,
+
+	/** @brief The largest packet accepted or sent, excluding framing. */
+	GDB_PACKET_SIZE_MAX = 4096,
+
+	/** @brief The size of the socket receive buffer. */
+	GDB_RECV_BUF_SIZE = 4096
+};
+
+enum gdb_result {
+	/** @brief The debugger detached; the emulator may keep running. */
+	GDB_RESULT_DETACHED,
+
+	/** @brief The debugger asked for the emulator to be killed. */
+	GDB_RESULT_KILLED,
+
+	/** @brief The connection was lost. */
+	GDB_RESULT_DISCONNECTED
+};
+
+struct gdb_breakpoint {
+	u32 addr;
+	u32 hook;
+};
+
+struct gdb {
+	struct psycho_ctx *ctx;
+	const char *unix_path;
+	int listen_fd;
+	int fd;
+
+	struct gdb_breakpoint bps[GDB_BREAKPOINTS_MAX];
+	uint num_bps;
+
+	char recv_buf[GDB_RECV_BUF_SIZE];
+	size_t recv_pos;
+	size_t recv_len;
+
+	bool no_ack;
+};
+
+/**
+ * @brief Starts listening for a debugger.
+ *
+ * @param gdb The stub to initialize.
+ * @param ctx The emulator context to debug.
+ * @param addr A TCP port number to listen on the loopback interface, or the
+ * path of a Unix domain socket to create.
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool gdb_listen(struct gdb *gdb, struct psycho_ctx *ctx, const char *addr);
+
+/**
+ * @brief Waits for a debugger to connect.
+ *
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool gdb_accept(struct gdb *gdb);
+
+/**
+ * @brief Serves the connected debugger until it goes away.
+ *
+ * The emulator only runs when the debugger asks it to; every breakpoint is
+ * removed before this returns.
+ */
+enum gdb_result gdb_serve(struct gdb *gdb);
+
+/**
+ * @brief Closes every socket of the stub.
+ */
+void gdb_close(struct gdb *gdb);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file profile.h Defines the host side of the guest sampling profiler.
+ *
+ * Samples raised by the core are aggregated by unique call stack, and can then
+ * be exported in the collapsed stack format understood by flamegraph.pl and
+ * speedscope, or as a flat per-function report.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "core/profiler.h"
+#include "core/types.h"
+
+struct profile_stack;
+struct profile_symbol;
+
+struct profile {
+	/** @brief Open addressing hash table of unique call stacks. */
+	struct profile_stack *stacks;
+	size_t stacks_capacity;
+	size_t stacks_num;
+
+	/** @brief The total number of samples taken. */
+	u64 num_samples;
+};
+
+struct profile_symbols {
+	/** @brief Function names, sorted by address. */
+	struct profile_symbol *symbols;
+	size_t num;
+};
+
+/**
+ * @brief Records a sample raised by @ref PSYCHO_EVENT_PROFILER_SAMPLE.
+ *
+ * @returns false if out of memory, in which case the sample is dropped.
+ */
+bool profile_sample_add(struct profile *prof,
+			const struct psycho_profiler_sample *sample);
+
+/**
+ * @brief Loads function names from a file.
+ *
+ * Each line consists of an address and a name, e.g. `0x80010000 main`, as
+ * produced by `nm` after dropping the type column.
+ *
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool profile_symbols_load(struct profile_symbols *syms, const char *path);
+
+void profile_symbols_free(struct profile_symbols *syms);
+
+/**
+ * @brief Writes every unique call stack and its sample count, one per line.
+ *
+ * @param prof The profile to write.
+ * @param syms The function names to use, or NULL to only use addresses.
+ * @param out The file to write to.
+ */
+void profile_write_collapsed(const struct profile *prof,
+			     const struct profile_symbols *syms, FILE *out);
+
+/**
+ * @brief Writes a flat report of self and total samples per function.
+ *
+ * @param prof The profile to write.
+ * @param syms The function names to use, or NULL to only use addresses.
+ * @param out The file to write to.
+ * @returns false if out of memory.
+ */
+bool profile_write_flat(const struct profile *prof,
+			const struct profile_symbols *syms, FILE *out);
+
+void profile_free(struct profile *prof);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file timeline.h Defines the host timer exporters.
+ *
+ * Scopes recorded by the core's host timers can be written as Chrome trace
+ * event JSON, which both Perfetto (ui.perfetto.dev) and chrome://tracing
+ * display as a timeline; per-zone totals can be written as a text table.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "core/timers.h"
+#include "core/types.h"
+
+/**
+ * @brief Pairs a tick count with the monotonic clock, so that ticks can be
+ * converted to time afterwards.
+ */
+struct timeline_calib {
+	u64 ticks;
+	u64 ns;
+};
+
+struct timeline {
+	FILE *out;
+
+	/** @brief The tick count which maps to a timestamp of zero. */
+	u64 origin;
+
+	bool origin_set;
+	bool events_written;
+};
+
+/**
+ * @brief Marks the start of a calibration interval.
+ */
+void timeline_calib_begin(struct timeline_calib *calib);
+
+/**
+ * @brief Ends a calibration interval.
+ *
+ * The longer the interval, the more accurate the result.
+ *
+ * @returns The number of ticks per nanosecond.
+ */
+double timeline_calib_end(const struct timeline_calib *calib);
+
+/**
+ * @brief Creates a trace event JSON file.
+ *
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool timeline_open(struct timeline *tl, const char *path);
+
+/**
+ * @brief Names a track of the timeline.
+ *
+ * @param tl The timeline to write to.
+ * @param tid The track to name.
+ * @param name The name of the track.
+ */
+void timeline_track_name(struct timeline *tl, uint tid, const char *name);
+
+/**
+ * @brief Writes recorded scopes to a track of the timeline.
+ *
+ * @param tl The timeline to write to.
+ * @param tid The track to write the scopes to.
+ * @param events The scopes recorded by the core.
+ * @param num The number of scopes in @p events.
+ * @param ticks_per_ns The result of timeline_calib_end().
+ */
+void timeline_write(struct timeline *tl, uint tid,
+		    const struct psycho_timer_event *events, size_t num,
+		    double ticks_per_ns);
+
+/**
+ * @brief Finishes and closes the trace event JSON file.
+ *
+ * @returns true on success, or false with `errno` set on failure.
+ */
+bool timeline_close(struct timeline *tl);
+
+/**
+ * @brief Writes per-zone totals as a text table.
+ *
+ * @param out The file to write to.
+ * @param totals The totals, as returned by psycho_timers_get().
+ * @param ticks_per_ns The result of timeline_calib_end().
+ */
+void timeline_write_totals(FILE *out, const struct psycho_timer_totals *totals,
+			   double ticks_per_ns);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
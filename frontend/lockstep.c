@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <inttypes.h>
+
+#include "frontend/lockstep.h"
+
+static void diff_write(FILE *const out, const char *const name,
+		       const u32 ref, const u32 cand)
+{
+	if (ref != cand)
+		fprintf(out, "  %-12s reference %08X candidate %08X\n", name,
+			ref, cand);
+}
+
+void lockstep_report(const struct psycho_lockstep_divergence *const div,
+		     FILE *const out)
+{
+	const struct psycho_cpu_sample *const ref = &div->ref;
+	const struct psycho_cpu_sample *const cand = &div->cand;
+
+	fprintf(out,
+		"diverged after %" PRIu64 " instructions, at %08X (%08X): "
+		"%s\n",
+		div->instrs, div->pc, div->instr, div->disasm);
+
+	char name[16];
+
+	for (uint i = 0; i < CPU_GPR_NUM; ++i) {
+		snprintf(name, sizeof(name), "r%u", i);
+		diff_write(out, name, ref->gpr[i], cand->gpr[i]);
+	}
+
+	diff_write(out, "hi", ref->hi, cand->hi);
+	diff_write(out, "lo", ref->lo, cand->lo);
+
+	for (uint i = 0; i < CPU_COP0_NUM; ++i) {
+		snprintf(name, sizeof(name), "cop0r%u", i);
+		diff_write(out, name, ref->cop0[i], cand->cop0[i]);
+	}
+
+	diff_write(out, "pc", ref->pc, cand->pc);
+	diff_write(out, "next_pc", ref->next_pc, cand->next_pc);
+	diff_write(out, "ld_next.dst", (u32)ref->ld_next_dst,
+		   (u32)cand->ld_next_dst);
+	diff_write(out, "ld_next.val", ref->ld_next_val, cand->ld_next_val);
+	diff_write(out, "ld_pend.dst", (u32)ref->ld_pend_dst,
+		   (u32)cand->ld_pend_dst);
+	diff_write(out, "ld_pend.val", ref->ld_pend_val, cand->ld_pend_val);
+	diff_write(out, "bds", ref->in_branch_delay_slot,
+		   cand->in_branch_delay_slot);
+	diff_write(out, "next_bds", ref->next_in_branch_delay_slot,
+		   cand->next_in_branch_delay_slot);
+
+	if (div->ref_write_hash != div->cand_write_hash)
+		fprintf(out,
+			"  %-12s reference %016" PRIX64
+			" candidate %016" PRIX64 "\n",
+			"writes", div->ref_write_hash, div->cand_write_hash);
+}
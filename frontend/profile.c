@@ -0,0 +1,393 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "frontend/profile.h"
+
+struct profile_stack {
+	/** @brief Function addresses, outermost first; NULL if unused. */
+	u32 *funcs;
+	uint depth;
+	u64 hash;
+	u64 count;
+};
+
+struct profile_symbol {
+	u32 addr;
+	char *name;
+};
+
+struct profile_func {
+	u32 addr;
+	u64 self;
+	u64 total;
+};
+
+static bool stack_eq(const struct profile_stack *const stack,
+		     const struct psycho_profiler_sample *const sample)
+{
+	if (stack->depth != sample->depth)
+		return false;
+
+	for (uint i = 0; i < sample->depth; ++i) {
+		if (stack->funcs[i] != sample->stack[i].func)
+			return false;
+	}
+	return true;
+}
+
+static bool stacks_grow(struct profile *const prof)
+{
+	const size_t capacity =
+		prof->stacks_capacity ? (prof->stacks_capacity * 2) : 256;
+
+	struct profile_stack *const stacks =
+		calloc(capacity, sizeof(*stacks));
+
+	if (!stacks)
+		return false;
+
+	for (size_t i = 0; i < prof->stacks_capacity; ++i) {
+		const struct profile_stack *const old = &prof->stacks[i];
+
+		if (!old->funcs)
+			continue;
+
+		size_t slot = old->hash & (capacity - 1);
+
+		while (stacks[slot].funcs)
+			slot = (slot + 1) & (capacity - 1);
+
+		stacks[slot] = *old;
+	}
+
+	free(prof->stacks);
+
+	prof->stacks = stacks;
+	prof->stacks_capacity = capacity;
+
+	return true;
+}
+
+bool profile_sample_add(struct profile *const prof,
+			const struct psycho_profiler_sample *const sample)
+{
+	// Keep the load factor below 3/4.
+	if (((prof->stacks_num + 1) * 4) >= (prof->stacks_capacity * 3)) {
+		if (!stacks_grow(prof))
+			return false;
+	}
+
+	u64 hash = UINT64_C(0xCBF29CE484222325);
+
+	for (uint i = 0; i < sample->depth; ++i) {
+		hash ^= sample->stack[i].func;
+		hash *= UINT64_C(0x00000100000001B3);
+	}
+
+	size_t slot = hash & (prof->stacks_capacity - 1);
+
+	for (;;) {
+		struct profile_stack *const stack = &prof->stacks[slot];
+
+		if (!stack->funcs)
+			break;
+
+		if ((stack->hash == hash) && stack_eq(stack, sample)) {
+			stack->count++;
+			prof->num_samples++;
+
+			return true;
+		}
+		slot = (slot + 1) & (prof->stacks_capacity - 1);
+	}
+
+	struct profile_stack *const stack = &prof->stacks[slot];
+
+	// Always allocate at least one element, so that an empty stack can
+	// still be told apart from an unused slot.
+	stack->funcs = malloc((sample->depth + 1) * sizeof(u32));
+
+	if (!stack->funcs)
+		return false;
+
+	for (uint i = 0; i < sample->depth; ++i)
+		stack->funcs[i] = sample->stack[i].func;
+
+	stack->depth = sample->depth;
+	stack->hash = hash;
+	stack->count = 1;
+
+	prof->stacks_num++;
+	prof->num_samples++;
+
+	return true;
+}
+
+static int symbol_cmp(const void *const a, const void *const b)
+{
+	const u32 lhs = ((const struct profile_symbol *)a)->addr;
+	const u32 rhs = ((const struct profile_symbol *)b)->addr;
+
+	return (lhs > rhs) - (lhs < rhs);
+}
+
+bool profile_symbols_load(struct profile_symbols *const syms,
+			  const char *const path)
+{
+	FILE *const file = fopen(path, "r");
+
+	if (!file)
+		return false;
+
+	char *line = NULL;
+	size_t line_size = 0;
+	bool ret = true;
+
+	while (ret && (getline(&line, &line_size, file) >= 0)) {
+		char *end;
+		const u32 addr = strtoul(line, &end, 16);
+
+		if (end == line)
+			continue;
+
+		end += strspn(end, " \t");
+		end[strcspn(end, "\r\n")] = '\0';
+
+		if (*end == '\0')
+			continue;
+
+		struct profile_symbol *const symbols = realloc(
+			syms->symbols, (syms->num + 1) * sizeof(*symbols));
+
+		if (!symbols) {
+			ret = false;
+			break;
+		}
+		syms->symbols = symbols;
+
+		char *const name = strdup(end);
+
+		if (!name) {
+			ret = false;
+			break;
+		}
+
+		symbols[syms->num].addr = addr;
+		symbols[syms->num].name = name;
+		syms->num++;
+	}
+
+	free(line);
+	fclose(file);
+
+	qsort(syms->symbols, syms->num, sizeof(*syms->symbols), symbol_cmp);
+	return ret;
+}
+
+void profile_symbols_free(struct profile_symbols *const syms)
+{
+	for (size_t i = 0; i < syms->num; ++i)
+		free(syms->symbols[i].name);
+
+	free(syms->symbols);
+
+	syms->symbols = NULL;
+	syms->num = 0;
+}
+
+static void func_name_write(const struct profile_symbols *const syms,
+			    FILE *const out, const u32 addr)
+{
+	const struct profile_symbol key = { .addr = addr };
+	const struct profile_symbol *const sym =
+		(syms && syms->num) ? bsearch(&key, syms->symbols, syms->num,
+					      sizeof(*syms->symbols),
+					      symbol_cmp) :
+				      NULL;
+
+	if (sym) {
+		fputs(sym->name, out);
+		return;
+	}
+
+	// The BIOS function tables are always entered through these vectors.
+	switch (addr) {
+	case 0x000000A0:
+	case 0x000000B0:
+	case 0x000000C0:
+		fprintf(out, "bios_%02X", addr);
+		return;
+
+	default:
+		fprintf(out, "0x%08X", addr);
+		return;
+	}
+}
+
+void profile_write_collapsed(const struct profile *const prof,
+			     const struct profile_symbols *const syms,
+			     FILE *const out)
+{
+	for (size_t i = 0; i < prof->stacks_capacity; ++i) {
+		const struct profile_stack *const stack = &prof->stacks[i];
+
+		if (!stack->funcs)
+			continue;
+
+		if (!stack->depth)
+			fputs("[unknown]", out);
+
+		for (uint j = 0; j < stack->depth; ++j) {
+			if (j)
+				fputc(';', out);
+
+			func_name_write(syms, out, stack->funcs[j]);
+		}
+		fprintf(out, " %" PRIu64 "\n", stack->count);
+	}
+}
+
+static struct profile_func *func_get(struct profile_func *const funcs,
+				     const size_t capacity, const u32 addr)
+{
+	size_t slot = (addr * UINT32_C(0x9E3779B1)) & (capacity - 1);
+
+	while (funcs[slot].total && (funcs[slot].addr != addr))
+		slot = (slot + 1) & (capacity - 1);
+
+	funcs[slot].addr = addr;
+	return &funcs[slot];
+}
+
+static int func_cmp(const void *const a, const void *const b)
+{
+	const struct profile_func *const lhs = a;
+	const struct profile_func *const rhs = b;
+
+	if (lhs->self != rhs->self)
+		return (lhs->self < rhs->self) - (lhs->self > rhs->self);
+
+	return (lhs->total < rhs->total) - (lhs->total > rhs->total);
+}
+
+bool profile_write_flat(const struct profile *const prof,
+			const struct profile_symbols *const syms,
+			FILE *const out)
+{
+	// There can't be more unique functions than frames across all stacks,
+	// plus the pseudo-function for samples outside of any known call.
+	size_t num_frames = 1;
+
+	for (size_t i = 0; i < prof->stacks_capacity; ++i)
+		num_frames += prof->stacks[i].depth;
+
+	size_t capacity = 16;
+
+	while (capacity < (num_frames * 2))
+		capacity *= 2;
+
+	struct profile_func *const funcs = calloc(capacity, sizeof(*funcs));
+
+	if (!funcs)
+		return false;
+
+	for (size_t i = 0; i < prof->stacks_capacity; ++i) {
+		const struct profile_stack *const stack = &prof->stacks[i];
+
+		if (!stack->funcs)
+			continue;
+
+		if (!stack->depth) {
+			struct profile_func *const func =
+				func_get(funcs, capacity, UINT32_MAX);
+
+			func->self += stack->count;
+			func->total += stack->count;
+
+			continue;
+		}
+
+		for (uint j = 0; j < stack->depth; ++j) {
+			const u32 addr = stack->funcs[j];
+			bool seen = false;
+
+			// Recursive functions only count once towards their
+			// total per sample.
+			for (uint k = 0; (k < j) && !seen; ++k)
+				seen = stack->funcs[k] == addr;
+
+			if (!seen)
+				func_get(funcs, capacity, addr)->total +=
+					stack->count;
+		}
+		func_get(funcs, capacity, stack->funcs[stack->depth - 1])
+			->self += stack->count;
+	}
+
+	size_t num_funcs = 0;
+
+	for (size_t i = 0; i < capacity; ++i) {
+		if (funcs[i].total)
+			funcs[num_funcs++] = funcs[i];
+	}
+
+	qsort(funcs, num_funcs, sizeof(*funcs), func_cmp);
+
+	const double total = prof->num_samples ? (double)prof->num_samples : 1;
+
+	fprintf(out, "%" PRIu64 " samples\n\n", prof->num_samples);
+	fprintf(out, "%8s %8s %12s %12s  %s\n", "self%", "total%", "self",
+		"total", "function");
+
+	for (size_t i = 0; i < num_funcs; ++i) {
+		const struct profile_func *const func = &funcs[i];
+
+		fprintf(out, "%8.2f %8.2f %12" PRIu64 " %12" PRIu64 "  ",
+			((double)func->self * 100) / total,
+			((double)func->total * 100) / total, func->self,
+			func->total);
+
+		if (func->addr == UINT32_MAX)
+			fputs("[unknown]", out);
+		else
+			func_name_write(syms, out, func->addr);
+
+		fputc('\n', out);
+	}
+
+	free(funcs);
+	return true;
+}
+
+void profile_free(struct profile *const prof)
+{
+	for (size_t i = 0; i < prof->stacks_capacity; ++i)
+		free(prof->stacks[i].funcs);
+
+	free(prof->stacks);
+
+	memset(prof, 0, sizeof(*prof));
+}
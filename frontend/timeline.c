@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <errno.h>
+#include <inttypes.h>
+
+#include "frontend/clock.h"
+#include "frontend/timeline.h"
+
+void timeline_calib_begin(struct timeline_calib *const calib)
+{
+	calib->ns = clock_ns();
+	calib->ticks = psycho_timers_now();
+}
+
+double timeline_calib_end(const struct timeline_calib *const calib)
+{
+	const u64 ticks = psycho_timers_now() - calib->ticks;
+	const u64 ns = clock_ns() - calib->ns;
+
+	return ns ? ((double)ticks / (double)ns) : 1;
+}
+
+bool timeline_open(struct timeline *const tl, const char *const path)
+{
+	tl->out = fopen(path, "w");
+
+	if (!tl->out)
+		return false;
+
+	tl->origin_set = false;
+	tl->events_written = false;
+
+	fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", tl->out);
+	return true;
+}
+
+static void event_sep(struct timeline *const tl)
+{
+	fputs(tl->events_written ? ",\n" : "\n", tl->out);
+	tl->events_written = true;
+}
+
+void timeline_track_name(struct timeline *const tl, const uint tid,
+			 const char *const name)
+{
+	event_sep(tl);
+	fprintf(tl->out,
+		"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+		"\"args\":{\"name\":\"%s\"}}",
+		tid, name);
+}
+
+void timeline_write(struct timeline *const tl, const uint tid,
+		    const struct psycho_timer_event *const events,
+		    const size_t num, const double ticks_per_ns)
+{
+	// Scopes are recorded in the order they end, so the earliest one isn't
+	// necessarily first.
+	if (!tl->origin_set && num) {
+		tl->origin = events[0].begin;
+
+		for (size_t i = 1; i < num; ++i) {
+			if (events[i].begin < tl->origin)
+				tl->origin = events[i].begin;
+		}
+		tl->origin_set = true;
+	}
+
+	const double ticks_per_us = ticks_per_ns * 1000;
+
+	for (size_t i = 0; i < num; ++i) {
+		const struct psycho_timer_event *const event = &events[i];
+
+		// Anything recorded before the origin was written belongs to
+		// an earlier batch; clamp it rather than emit negative times.
+		const u64 begin = (event->begin > tl->origin) ?
+					  (event->begin - tl->origin) :
+					  0;
+
+		event_sep(tl);
+		fprintf(tl->out,
+			"{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+			"\"ts\":%.3f,\"dur\":%.3f}",
+			psycho_timer_zone_name(event->zone), tid,
+			(double)begin / ticks_per_us,
+			(double)(event->end - event->begin) / ticks_per_us);
+	}
+}
+
+bool timeline_close(struct timeline *const tl)
+{
+	fputs("\n]}\n", tl->out);
+
+	const bool failed = ferror(tl->out);
+
+	if ((fclose(tl->out) != 0) || failed) {
+		if (!errno)
+			errno = EIO;
+
+		return false;
+	}
+	return true;
+}
+
+void timeline_write_totals(FILE *const out,
+			   const struct psycho_timer_totals *const totals,
+			   const double ticks_per_ns)
+{
+	u64 self_sum = 0;
+
+	for (uint zone = 0; zone < PSYCHO_TIMER_ZONE_NUM; ++zone)
+		self_sum += totals[zone].self_ticks;
+
+	fprintf(out, "  %-12s %12s %12s %12s %8s %10s\n", "zone", "calls",
+		"total ms", "self ms", "self%", "ns/call");
+
+	for (uint zone = 0; zone < PSYCHO_TIMER_ZONE_NUM; ++zone) {
+		const struct psycho_timer_totals *const t = &totals[zone];
+
+		if (!t->count)
+			continue;
+
+		const double total_ns = (double)t->ticks / ticks_per_ns;
+		const double self_ns = (double)t->self_ticks / ticks_per_ns;
+		const double self_pct =
+			self_sum ? ((double)t->self_ticks * 100) /
+					   (double)self_sum :
+				   0;
+
+		fprintf(out,
+			"  %-12s %12" PRIu64 " %12.3f %12.3f %8.2f %10.2f\n",
+			psycho_timer_zone_name(zone), t->count,
+			total_ns / 1000000, self_ns / 1000000, self_pct,
+			total_ns / (double)t->count);
+	}
+}
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file driver.c Runs inputs through the harness without libFuzzer.
+ *
+ * This is used when libFuzzer isn't available, to reproduce crashes found
+ * elsewhere, and to measure how quickly inputs can be run.
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/bus.h"
+#include "frontend/clock.h"
+#include "frontend/fmap.h"
+#include "fuzz.h"
+
+static u64 num_repeats = 1;
+
+static bool input_run(const char *const path)
+{
+	struct fmap input;
+
+	if (!fmap_open(&input, path)) {
+		fprintf(stderr, "psycho-fuzz: unable to read %s: %s\n", path,
+			strerror(errno));
+		return false;
+	}
+
+	for (u64 i = 0; i < num_repeats; ++i)
+		LLVMFuzzerTestOneInput(input.data, input.size);
+
+	fmap_close(&input);
+	return true;
+}
+
+static bool dir_run(const char *const dir)
+{
+	DIR *const d = opendir(dir);
+
+	if (!d) {
+		fprintf(stderr, "psycho-fuzz: unable to open %s: %s\n", dir,
+			strerror(errno));
+		return false;
+	}
+
+	bool ok = true;
+	const struct dirent *entry;
+
+	while ((entry = readdir(d)) != NULL) {
+		if (entry->d_name[0] == '.')
+			continue;
+
+		char path[PATH_MAX];
+		const int len = snprintf(path, sizeof(path), "%s/%s", dir,
+					 entry->d_name);
+
+		if ((len < 0) || (len >= (int)sizeof(path)))
+			continue;
+
+		ok &= input_run(path);
+	}
+
+	closedir(d);
+	return ok;
+}
+
+static void summary(const u64 elapsed_ns)
+{
+	struct fuzz_stats stats;
+	fuzz_stats_get(&stats);
+
+	size_t num_edges = 0;
+
+	for (size_t i = 0; i < stats.edges_size; ++i)
+		num_edges += stats.edges[i] != 0;
+
+	const double execs = stats.execs ? (double)stats.execs : 1;
+
+	fprintf(stderr,
+		"execs: %" PRIu64 " (%.0f/s)\n"
+		"instructions per exec: %.1f\n"
+		"pages restored per exec: %.2f of %u\n"
+		"illegal instructions: %" PRIu64 "\n"
+		"edges: %zu\n",
+		stats.execs,
+		elapsed_ns ? ((double)stats.execs * NSEC_PER_SEC) /
+				     (double)elapsed_ns :
+			     0,
+		(double)stats.instructions / execs,
+		(double)stats.pages_restored / execs, (uint)RAM_PAGE_NUM,
+		stats.illegal, num_edges);
+}
+
+int main(int argc, char **argv)
+{
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			num_repeats = strtoull(optarg, NULL, 0);
+			break;
+
+		default:
+			fprintf(stderr,
+				"syntax: %s [-n repeats] <input|dir>...\n",
+				argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	LLVMFuzzerInitialize(&argc, &argv);
+
+	bool ok = true;
+	const u64 start = clock_ns();
+
+	for (int i = optind; i < argc; ++i) {
+		struct stat st;
+
+		if ((stat(argv[i], &st) == 0) && S_ISDIR(st.st_mode))
+			ok &= dir_run(argv[i]);
+		else
+			ok &= input_run(argv[i]);
+	}
+
+	summary(clock_ns() - start);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
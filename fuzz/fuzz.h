@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/types.h"
+
+struct fuzz_stats {
+	/** @brief The number of inputs run. */
+	u64 execs;
+
+	/** @brief The number of guest instructions executed. */
+	u64 instructions;
+
+	/** @brief The number of pages of RAM restored between inputs. */
+	u64 pages_restored;
+
+	/** @brief The number of inputs which hit an illegal instruction. */
+	u64 illegal;
+
+	/** @brief The guest edge map, also exposed to libFuzzer. */
+	const u8 *edges;
+	size_t edges_size;
+};
+
+/**
+ * @brief Retrieves the statistics gathered across every input so far.
+ */
+void fuzz_stats_get(struct fuzz_stats *stats);
+
+// The libFuzzer entry points; when not linking against libFuzzer, driver.c
+// calls these itself.
+int LLVMFuzzerInitialize(int *argc, char ***argv);
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
@@ -0,0 +1,315 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file harness.c A libFuzzer compatible harness for guest code.
+ *
+ * The harness is configured through the environment, since libFuzzer owns
+ * the command line:
+ *
+ * - PSYCHO_FUZZ_EXE: the EXE containing the code under test (required).
+ * - PSYCHO_FUZZ_BIOS: a BIOS to boot before side-loading the EXE; without
+ *   one, the EXE is loaded straight away. The image is handed down to any
+ *   child processes libFuzzer spawns, which map it instead of this file.
+ * - PSYCHO_FUZZ_BIOS_HASH: if set, the hash PSYCHO_FUZZ_BIOS must have; it
+ *   is checked once, before the image is handed down.
+ * - PSYCHO_FUZZ_ENTRY: where to start each input; defaults to the entry
+ *   point of the EXE.
+ * - PSYCHO_FUZZ_INPUT_ADDR: where to place each input in guest memory.
+ * - PSYCHO_FUZZ_INPUT_MAX: the most bytes of an input to place.
+ * - PSYCHO_FUZZ_BUDGET: the most instructions to run per input.
+ * - PSYCHO_FUZZ_TRAP_ILLEGAL: if set, an illegal instruction is reported to
+ *   libFuzzer as a crash rather than just ending the input.
+ *
+ * Each input starts from a snapshot taken at the entry point, with $a0
+ * holding the address of the input, $a1 its size, and $ra an unmapped address
+ * at which the input ends; a target function can therefore simply return.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/ctx.h"
+#include "core/snapshot.h"
+#include "frontend/bios-image.h"
+#include "frontend/fmap.h"
+#include "fuzz.h"
+
+enum {
+	FUZZ_INPUT_ADDR_DEFAULT = 0x80100000,
+	FUZZ_INPUT_SIZE_MAX_DEFAULT = 64 * 1024,
+	FUZZ_BUDGET_DEFAULT = 1000000,
+	FUZZ_BOOT_BUDGET = 500000000,
+
+	/** @brief Where the code under test returns to; nothing lives here. */
+	FUZZ_RETURN_PC = 0xFFFFFFF0
+};
+
+// libFuzzer treats every counter in this section as additional coverage, so
+// the guest edge map doubles as libFuzzer's feedback without any copying.
+static u8 fuzz_edges[PSYCHO_COVERAGE_EDGES_SIZE_DEFAULT]
+	__attribute__((section("__libfuzzer_extra_counters")));
+
+static struct {
+	u8 ram[RAM_SIZE];
+	u8 snap_ram[RAM_SIZE];
+
+	struct psycho_ctx ctx;
+	struct psycho_snapshot snap;
+
+	struct bios_image bios;
+	u8 *bios_blank;
+	struct fmap exe;
+
+	u32 input_addr;
+	size_t input_size_max;
+	u64 budget;
+	u32 sideload_hook;
+	bool at_shell;
+	bool trap_on_illegal;
+	bool illegal;
+
+	struct fuzz_stats stats;
+} fuzz;
+
+static void ctx_event_handle(struct psycho_ctx *const ctx,
+			     const enum psycho_event event, void *const data)
+{
+	(void)ctx;
+	(void)data;
+
+	switch (event) {
+	case PSYCHO_EVENT_CPU_ILLEGAL:
+		fuzz.illegal = true;
+		return;
+
+	case PSYCHO_EVENT_LOG_MESSAGE:
+	case PSYCHO_EVENT_TTY_MESSAGE:
+	case PSYCHO_EVENT_PROFILER_SAMPLE:
+	case PSYCHO_EVENT_WATCHPOINT:
+	case PSYCHO_EVENT_HANG:
+		return;
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+static u64 env_u64(const char *const name, const u64 fallback)
+{
+	const char *const val = getenv(name);
+	return val ? strtoull(val, NULL, 0) : fallback;
+}
+
+__attribute__((noreturn, format(printf, 1, 2))) static void
+fail(const char *const fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+
+	fputs("psycho-fuzz: ", stderr);
+	vfprintf(stderr, fmt, args);
+	fputc('\n', stderr);
+
+	va_end(args);
+	exit(EXIT_FAILURE);
+}
+
+static const u8 *bios_load(void)
+{
+	if (bios_image_inherited()) {
+		if (!bios_image_open_inherited(&fuzz.bios))
+			fail("unable to map inherited BIOS: %s",
+			     strerror(errno));
+
+		return fuzz.bios.data;
+	}
+
+	const char *const path = getenv("PSYCHO_FUZZ_BIOS");
+
+	if (!path) {
+		fuzz.bios_blank = calloc(1, BIOS_SIZE);
+
+		if (!fuzz.bios_blank)
+			fail("out of memory");
+
+		return fuzz.bios_blank;
+	}
+
+	if (!bios_image_open(&fuzz.bios, path))
+		fail("unable to load BIOS: %s", strerror(errno));
+
+	const char *const hash = getenv("PSYCHO_FUZZ_BIOS_HASH");
+
+	if (hash && !bios_image_expect(&fuzz.bios, hash))
+		fail("BIOS has the hash %016" PRIX64 ", not %s", fuzz.bios.hash,
+		     hash);
+
+	// libFuzzer's -fork and -jobs modes run the fuzzer in child processes;
+	// they map this one copy rather than each reading the file again.
+	if (!bios_image_share(&fuzz.bios))
+		fail("unable to share BIOS: %s", strerror(errno));
+
+	return fuzz.bios.data;
+}
+
+static void sideload_hook(struct psycho_ctx *const ctx, const u32 pc,
+			  void *const udata)
+{
+	(void)pc;
+	(void)udata;
+
+	psycho_hook_remove(ctx, fuzz.sideload_hook);
+	psycho_hook_stop(ctx);
+
+	fuzz.at_shell = true;
+}
+
+static void boot(void)
+{
+	struct psycho_ctx *const ctx = &fuzz.ctx;
+
+	// Without a BIOS there's nothing to boot, so the EXE is simply loaded
+	// straight away.
+	if (!fuzz.bios_blank) {
+		fuzz.sideload_hook = psycho_hook_add(ctx, EXE_SIDELOAD_PC,
+						     sideload_hook, NULL);
+
+		for (u64 i = 0; (i < FUZZ_BOOT_BUDGET) && !fuzz.at_shell; ++i)
+			psycho_step(ctx);
+
+		if (!fuzz.at_shell)
+			fail("the BIOS never reached the shell");
+	}
+
+	if (psycho_exe_load(ctx, fuzz.exe.data, fuzz.exe.size) != PSYCHO_OK)
+		fail("invalid EXE");
+
+	const char *const entry = getenv("PSYCHO_FUZZ_ENTRY");
+
+	if (entry) {
+		ctx->cpu.pc = strtoul(entry, NULL, 0);
+		ctx->cpu.next_pc = ctx->cpu.pc + sizeof(u32);
+	}
+}
+
+int LLVMFuzzerInitialize(int *const argc, char ***const argv)
+{
+	(void)argc;
+	(void)argv;
+
+	const char *const exe = getenv("PSYCHO_FUZZ_EXE");
+
+	if (!exe)
+		fail("PSYCHO_FUZZ_EXE must name the EXE to fuzz");
+
+	if (!fmap_open(&fuzz.exe, exe))
+		fail("unable to load EXE: %s", strerror(errno));
+
+	fuzz.input_addr = env_u64("PSYCHO_FUZZ_INPUT_ADDR",
+				  FUZZ_INPUT_ADDR_DEFAULT);
+	fuzz.input_size_max = env_u64("PSYCHO_FUZZ_INPUT_MAX",
+				      FUZZ_INPUT_SIZE_MAX_DEFAULT);
+	fuzz.budget = env_u64("PSYCHO_FUZZ_BUDGET", FUZZ_BUDGET_DEFAULT);
+	fuzz.trap_on_illegal = getenv("PSYCHO_FUZZ_TRAP_ILLEGAL") != NULL;
+
+	const struct psycho_ctx_cfg cfg = {
+		// clang-format off
+
+		.event_cb	= ctx_event_handle,
+		.ram_data	= fuzz.ram,
+		.bios_data	= bios_load()
+
+		// clang-format on
+	};
+
+	psycho_init(&fuzz.ctx, &cfg);
+	boot();
+
+	const struct psycho_coverage_cfg coverage = {
+		// clang-format off
+
+		.edges		= fuzz_edges,
+		.edges_size	= sizeof(fuzz_edges)
+
+		// clang-format on
+	};
+
+	psycho_coverage_enable(&fuzz.ctx, &coverage);
+	fuzz.ctx.cpu.gpr[CPU_GPR_RA] = FUZZ_RETURN_PC;
+
+	fuzz.snap.ram = fuzz.snap_ram;
+	psycho_snapshot_save(&fuzz.ctx, &fuzz.snap);
+
+	fuzz.stats.edges = fuzz_edges;
+	fuzz.stats.edges_size = sizeof(fuzz_edges);
+
+	return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *const data, size_t size)
+{
+	struct psycho_ctx *const ctx = &fuzz.ctx;
+
+	fuzz.stats.pages_restored += psycho_snapshot_restore(ctx, &fuzz.snap);
+	fuzz.illegal = false;
+
+	if (size > fuzz.input_size_max)
+		size = fuzz.input_size_max;
+
+	psycho_snapshot_ram_write(ctx, fuzz.input_addr & (RAM_SIZE - 1), data,
+				  size);
+
+	ctx->cpu.gpr[CPU_GPR_A0] = fuzz.input_addr;
+	ctx->cpu.gpr[CPU_GPR_A1] = size;
+
+	u64 instructions = 0;
+
+	for (; instructions < fuzz.budget; ++instructions) {
+		if (ctx->cpu.pc == FUZZ_RETURN_PC)
+			break;
+
+		psycho_step(ctx);
+
+		if (unlikely(fuzz.illegal)) {
+			if (fuzz.trap_on_illegal)
+				__builtin_trap();
+
+			fuzz.stats.illegal++;
+			break;
+		}
+	}
+
+	fuzz.stats.execs++;
+	fuzz.stats.instructions += instructions;
+
+	return 0;
+}
+
+void fuzz_stats_get(struct fuzz_stats *const stats)
+{
+	*stats = fuzz.stats;
+}
@@ -0,0 +1,857 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <dirent.h>
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/ctx.h"
+#include "frontend/bios-image.h"
+#include "frontend/clock.h"
+#include "frontend/coverage.h"
+#include "frontend/fmap.h"
+#include "frontend/profile.h"
+#include "runner.h"
+
+enum {
+	/** The most TTY output retained for a single test. */
+	RUNNER_TTY_SIZE_MAX = 64 * 1024,
+};
+
+enum { RUNNER_BUDGET_DEFAULT = 100000000 };
+enum { RUNNER_WATCHDOG_INTERVAL_DEFAULT = 100000 };
+
+struct runner_worker {
+	struct psycho_ctx ctx;
+	struct profile profile;
+	struct psycho_coverage_cfg coverage;
+	struct runner_job *job;
+	struct fmap exe;
+	pthread_t thread;
+	u8 *ram;
+	u32 sideload_hook;
+};
+
+static struct {
+	struct bios_image bios;
+	const char *bios_hash;
+
+	struct runner_job *jobs;
+	size_t num_jobs;
+	atomic_size_t next_job;
+
+	enum runner_format format;
+	const char *output;
+	uint num_workers;
+
+	u64 budget;
+	u32 sentinel_pc;
+	bool has_sentinel_pc;
+	const char *expect_tty;
+
+	const char *profile_dir;
+	u64 profile_interval;
+	struct profile_symbols profile_syms;
+
+	const char *coverage_dir;
+
+	u64 watchdog_interval;
+	u64 hang_timeout;
+
+	/** @brief The coverage of every test combined. */
+	struct psycho_coverage_cfg coverage;
+	pthread_mutex_t coverage_lock;
+} runner = {
+	// clang-format off
+
+	.format			= RUNNER_FORMAT_JSON,
+	.budget			= RUNNER_BUDGET_DEFAULT,
+	.profile_interval	= 1000,
+	.watchdog_interval	= RUNNER_WATCHDOG_INTERVAL_DEFAULT,
+	.coverage_lock		= PTHREAD_MUTEX_INITIALIZER
+
+	// clang-format on
+};
+
+static void tty_append(struct runner_job *const job, const char *const data)
+{
+	const size_t len = strlen(data);
+
+	if ((job->tty_len + len) >= RUNNER_TTY_SIZE_MAX)
+		return;
+
+	if ((job->tty_len + len) >= job->tty_capacity) {
+		size_t capacity = job->tty_capacity ? job->tty_capacity : 256;
+
+		while (capacity <= (job->tty_len + len))
+			capacity *= 2;
+
+		char *const tty = realloc(job->tty, capacity);
+
+		if (!tty)
+			return;
+
+		job->tty = tty;
+		job->tty_capacity = capacity;
+	}
+
+	// Only search the region which could possibly contain a new match, so
+	// that a chatty test doesn't rescan its entire output on every line.
+	size_t search_from = 0;
+
+	if (job->expect_tty) {
+		const size_t expect_len = strlen(job->expect_tty);
+
+		if (job->tty_len >= expect_len)
+			search_from = job->tty_len - expect_len + 1;
+	}
+
+	memcpy(&job->tty[job->tty_len], data, len + 1);
+	job->tty_len += len;
+
+	if (job->expect_tty &&
+	    strstr(&job->tty[search_from], job->expect_tty)) {
+		job->status = RUNNER_STATUS_PASS;
+		job->reason = "expected TTY output seen";
+	}
+}
+
+static void hang_report(struct runner_job *const job,
+			const struct psycho_watchdog_hang *const hang)
+{
+	switch (hang->reason) {
+	case PSYCHO_WATCHDOG_REASON_LOOP:
+		job->status = RUNNER_STATUS_HANG;
+		job->reason = "stuck in a loop which can never exit";
+		return;
+
+	case PSYCHO_WATCHDOG_REASON_NO_PROGRESS:
+		job->status = RUNNER_STATUS_HANG;
+		job->reason = "no TTY output within the hang timeout";
+		return;
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+static void ctx_event_handle(struct psycho_ctx *const ctx,
+			     const enum psycho_event event, void *const data)
+{
+	struct runner_worker *const worker = ctx->udata;
+
+	switch (event) {
+	case PSYCHO_EVENT_CPU_ILLEGAL:
+		worker->job->status = RUNNER_STATUS_ILLEGAL;
+		worker->job->reason = "illegal instruction";
+		return;
+
+	case PSYCHO_EVENT_LOG_MESSAGE:
+		return;
+
+	case PSYCHO_EVENT_TTY_MESSAGE:
+		tty_append(worker->job, data);
+		return;
+
+	case PSYCHO_EVENT_PROFILER_SAMPLE:
+		profile_sample_add(&worker->profile, data);
+		return;
+
+	case PSYCHO_EVENT_WATCHPOINT:
+		return;
+
+	case PSYCHO_EVENT_HANG:
+		hang_report(worker->job, data);
+		return;
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+static FILE *job_file_open(const char *const dir,
+			   const struct runner_job *const job,
+			   const char *const ext)
+{
+	const char *const slash = strrchr(job->path, '/');
+	char path[PATH_MAX];
+
+	const int len = snprintf(path, sizeof(path), "%s/%s%s", dir,
+				 slash ? (slash + 1) : job->path, ext);
+
+	if ((len < 0) || (len >= (int)sizeof(path)))
+		return NULL;
+
+	return fopen(path, "w");
+}
+
+static void profile_write(struct runner_worker *const worker,
+			  const struct runner_job *const job)
+{
+	FILE *const collapsed =
+		job_file_open(runner.profile_dir, job, ".folded");
+
+	if (collapsed) {
+		profile_write_collapsed(&worker->profile, &runner.profile_syms,
+					collapsed);
+		fclose(collapsed);
+	}
+
+	FILE *const flat = job_file_open(runner.profile_dir, job, ".flat.txt");
+
+	if (flat) {
+		profile_write_flat(&worker->profile, &runner.profile_syms,
+				   flat);
+		fclose(flat);
+	}
+
+	if (!collapsed || !flat)
+		fprintf(stderr, "unable to write profile for %s\n", job->path);
+
+	profile_free(&worker->profile);
+}
+
+static void coverage_write(struct runner_worker *const worker,
+			   const struct runner_job *const job)
+{
+	FILE *const annotated =
+		job_file_open(runner.coverage_dir, job, ".cov.txt");
+
+	if (annotated) {
+		coverage_write_annotated(&worker->ctx, &worker->coverage,
+					 annotated);
+		fclose(annotated);
+	} else {
+		fprintf(stderr, "unable to write coverage for %s\n",
+			job->path);
+	}
+
+	pthread_mutex_lock(&runner.coverage_lock);
+	coverage_merge(&runner.coverage, &worker->coverage);
+	pthread_mutex_unlock(&runner.coverage_lock);
+}
+
+static void sentinel_hook(struct psycho_ctx *const ctx, const u32 pc,
+			  void *const udata)
+{
+	struct runner_worker *const worker = udata;
+	(void)pc;
+
+	worker->job->status = RUNNER_STATUS_PASS;
+	worker->job->reason = "sentinel PC reached";
+	psycho_hook_stop(ctx);
+}
+
+static void sideload_hook(struct psycho_ctx *const ctx, const u32 pc,
+			  void *const udata)
+{
+	struct runner_worker *const worker = udata;
+	(void)pc;
+
+	psycho_hook_remove(ctx, worker->sideload_hook);
+
+	if (psycho_exe_load(ctx, worker->exe.data, worker->exe.size) !=
+	    PSYCHO_OK) {
+		worker->job->status = RUNNER_STATUS_ERROR;
+		worker->job->reason = "invalid EXE";
+		return;
+	}
+
+	// The BIOS may well pass through the sentinel PC while booting, so it
+	// only counts once the EXE is in place.
+	if (worker->job->has_sentinel_pc &&
+	    !psycho_hook_add(ctx, worker->job->sentinel_pc, sentinel_hook,
+			     worker)) {
+		worker->job->status = RUNNER_STATUS_ERROR;
+		worker->job->reason = "unable to hook the sentinel PC";
+	}
+}
+
+static void job_run(struct runner_worker *const worker,
+		    struct runner_job *const job)
+{
+	job->status = RUNNER_STATUS_RUNNING;
+	worker->job = job;
+
+	if (!fmap_open(&worker->exe, job->path)) {
+		job->status = RUNNER_STATUS_ERROR;
+		job->reason = strerror_r(errno, job->error, sizeof(job->error));
+		return;
+	}
+
+	memset(&worker->ctx, 0, sizeof(worker->ctx));
+	memset(worker->ram, 0, RAM_SIZE);
+
+	const struct psycho_ctx_cfg cfg = {
+		// clang-format off
+
+		.event_cb	= ctx_event_handle,
+		.ram_data	= worker->ram,
+		.bios_data	= runner.bios.data,
+		.udata		= worker
+
+		// clang-format on
+	};
+
+	const u64 start = clock_ns();
+
+	psycho_init(&worker->ctx, &cfg);
+	psycho_tty_stdout_enable(&worker->ctx, true);
+
+	if (runner.profile_dir)
+		psycho_profiler_enable(&worker->ctx, true,
+				       runner.profile_interval);
+
+	if (runner.coverage_dir) {
+		coverage_clear(&worker->coverage);
+		psycho_coverage_enable(&worker->ctx, &worker->coverage);
+	}
+
+	if (runner.watchdog_interval)
+		psycho_watchdog_enable(&worker->ctx, true,
+				       runner.watchdog_interval,
+				       runner.hang_timeout);
+
+	struct psycho_ctx *const ctx = &worker->ctx;
+	u64 instructions = 0;
+
+	worker->sideload_hook = psycho_hook_add(ctx, EXE_SIDELOAD_PC,
+						sideload_hook, worker);
+
+	for (; instructions < job->budget; ++instructions) {
+		// Only the sentinel hook stops a step, before the instruction
+		// at the sentinel PC executes.
+		if (!psycho_step(ctx))
+			break;
+
+		if (unlikely(job->status != RUNNER_STATUS_RUNNING)) {
+			++instructions;
+			break;
+		}
+	}
+
+	job->wall_time_ns = clock_ns() - start;
+	job->instructions = instructions;
+
+	if (job->status == RUNNER_STATUS_RUNNING) {
+		// A test with no success criteria simply runs for its budget.
+		if (job->has_sentinel_pc || job->expect_tty) {
+			job->status = RUNNER_STATUS_TIMEOUT;
+			job->reason = "instruction budget exhausted";
+		} else {
+			job->status = RUNNER_STATUS_PASS;
+			job->reason = "instruction budget completed";
+		}
+	}
+
+	if (runner.profile_dir)
+		profile_write(worker, job);
+
+	if (runner.coverage_dir)
+		coverage_write(worker, job);
+
+	fmap_close(&worker->exe);
+}
+
+static void *worker_main(void *const arg)
+{
+	struct runner_worker *const worker = arg;
+
+	for (;;) {
+		const size_t i = atomic_fetch_add(&runner.next_job, 1);
+
+		if (i >= runner.num_jobs)
+			return NULL;
+
+		job_run(worker, &runner.jobs[i]);
+	}
+}
+
+static bool job_add(const char *const path)
+{
+	struct runner_job *const jobs =
+		realloc(runner.jobs, (runner.num_jobs + 1) * sizeof(*jobs));
+
+	if (!jobs)
+		return false;
+
+	runner.jobs = jobs;
+
+	struct runner_job *const job = &jobs[runner.num_jobs];
+	memset(job, 0, sizeof(*job));
+
+	job->path = strdup(path);
+
+	if (!job->path)
+		return false;
+
+	job->budget = runner.budget;
+	job->sentinel_pc = runner.sentinel_pc;
+	job->has_sentinel_pc = runner.has_sentinel_pc;
+
+	if (runner.expect_tty) {
+		job->expect_tty = strdup(runner.expect_tty);
+
+		if (!job->expect_tty)
+			return false;
+	}
+
+	++runner.num_jobs;
+	return true;
+}
+
+static bool path_join(char path[static PATH_MAX], const char *const dir,
+		      const char *const name)
+{
+	const int len = dir ? snprintf(path, PATH_MAX, "%s/%s", dir, name) :
+			      snprintf(path, PATH_MAX, "%s", name);
+
+	if ((len < 0) || (len >= PATH_MAX)) {
+		errno = ENAMETOOLONG;
+		return false;
+	}
+	return true;
+}
+
+static int dirent_cmp(const struct dirent **const a,
+		      const struct dirent **const b)
+{
+	return strcmp((*a)->d_name, (*b)->d_name);
+}
+
+static int dirent_is_exe(const struct dirent *const entry)
+{
+	const char *const ext = strrchr(entry->d_name, '.');
+	return ext && (strcasecmp(ext, ".exe") == 0);
+}
+
+static bool jobs_from_dir(const char *const dir)
+{
+	struct dirent **entries;
+	const int num_entries =
+		scandir(dir, &entries, dirent_is_exe, dirent_cmp);
+
+	if (num_entries < 0)
+		return false;
+
+	bool ret = true;
+
+	for (int i = 0; i < num_entries; ++i) {
+		char path[PATH_MAX];
+
+		if (ret)
+			ret = path_join(path, dir, entries[i]->d_name) &&
+			      job_add(path);
+		free(entries[i]);
+	}
+	free(entries);
+
+	return ret;
+}
+
+// Each line of a manifest names an EXE relative to the manifest, optionally
+// followed by per-test overrides:
+//
+//	path/to/test.exe [budget=N] [pc=0xADDR] [tty=expected output]
+//
+// `tty=` consumes the remainder of the line, so it must come last. Blank
+// lines and lines starting with '#' are ignored.
+static bool manifest_line_parse(const char *const base, char *line,
+				const char *const manifest, const uint line_num)
+{
+	line[strcspn(line, "\r\n")] = '\0';
+	line += strspn(line, " \t");
+
+	if ((*line == '\0') || (*line == '#'))
+		return true;
+
+	char *const name = line;
+	line += strcspn(line, " \t");
+
+	if (*line)
+		*line++ = '\0';
+
+	char path[PATH_MAX];
+
+	if (!path_join(path, (name[0] == '/') ? NULL : base, name) ||
+	    !job_add(path))
+		return false;
+
+	struct runner_job *const job = &runner.jobs[runner.num_jobs - 1];
+
+	while (*(line += strspn(line, " \t"))) {
+		if (strncmp(line, "tty=", 4) == 0) {
+			free(job->expect_tty);
+			job->expect_tty = strdup(&line[4]);
+
+			return job->expect_tty != NULL;
+		}
+
+		char *const opt = line;
+		line += strcspn(line, " \t");
+
+		if (*line)
+			*line++ = '\0';
+
+		char *end;
+
+		if (strncmp(opt, "budget=", 7) == 0) {
+			job->budget = strtoull(&opt[7], &end, 0);
+		} else if (strncmp(opt, "pc=", 3) == 0) {
+			job->sentinel_pc = strtoul(&opt[3], &end, 0);
+			job->has_sentinel_pc = true;
+		} else {
+			end = opt;
+		}
+
+		if (*end != '\0') {
+			fprintf(stderr, "%s:%u: invalid option '%s'\n",
+				manifest, line_num, opt);
+			errno = EINVAL;
+
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool jobs_from_manifest(const char *const manifest)
+{
+	FILE *const file = fopen(manifest, "r");
+
+	if (!file)
+		return false;
+
+	char base[PATH_MAX];
+
+	if (!path_join(base, NULL, manifest)) {
+		fclose(file);
+		return false;
+	}
+
+	char *const slash = strrchr(base, '/');
+
+	if (slash)
+		*slash = '\0';
+	else
+		strcpy(base, ".");
+
+	char *line = NULL;
+	size_t line_size = 0;
+	uint line_num = 0;
+	bool ret = true;
+
+	while (ret && (getline(&line, &line_size, file) >= 0))
+		ret = manifest_line_parse(base, line, manifest, ++line_num);
+
+	free(line);
+	fclose(file);
+
+	return ret;
+}
+
+static bool coverage_suite_file_write(
+	const char *const name,
+	bool (*const write)(const struct psycho_coverage_cfg *, FILE *))
+{
+	char path[PATH_MAX];
+
+	if (!path_join(path, runner.coverage_dir, name))
+		return false;
+
+	FILE *const out = fopen(path, "wb");
+
+	if (!out)
+		return false;
+
+	const bool written = write(&runner.coverage, out);
+	return (fclose(out) == 0) && written;
+}
+
+static bool coverage_suite_write(void)
+{
+	return coverage_suite_file_write("suite.edges",
+					 coverage_write_edges) &&
+	       coverage_suite_file_write("suite.exec", coverage_write_exec);
+}
+
+static void usage(const char *const argv0)
+{
+	fprintf(stderr,
+		"syntax: %s [options] <bios_file> <exe_dir|manifest>\n"
+		"\n"
+		"options:\n"
+		"  -j, --jobs N            number of worker threads\n"
+		"  -B, --bios-hash HASH    refuse a BIOS which does not have "
+		"the hash HASH\n"
+		"  -b, --budget N          instruction budget per test "
+		"(default %u)\n"
+		"  -p, --sentinel-pc ADDR  pass when the PC reaches ADDR\n"
+		"  -t, --expect-tty TEXT   pass when TEXT appears on the TTY\n"
+		"  -f, --format FORMAT     summary format: json or junit\n"
+		"  -o, --output FILE       write the summary to FILE\n"
+		"  -P, --profile DIR       write guest profiles to DIR\n"
+		"  -I, --profile-interval N\n"
+		"                          instructions between samples "
+		"(default 1000)\n"
+		"  -S, --profile-symbols FILE\n"
+		"                          function names for profiles\n"
+		"  -C, --coverage DIR      write guest code coverage to DIR\n"
+		"  -W, --watchdog-interval N\n"
+		"                          instructions between hang checks, "
+		"0 to disable\n"
+		"                          (default %u)\n"
+		"  -H, --hang-timeout N    fail a test which prints nothing "
+		"for N instructions\n",
+		argv0, (uint)RUNNER_BUDGET_DEFAULT,
+		(uint)RUNNER_WATCHDOG_INTERVAL_DEFAULT);
+}
+
+static bool args_parse(const int argc, char **const argv)
+{
+	static const struct option opts[] = {
+		// clang-format off
+
+		{ "jobs",		required_argument,	NULL, 'j' },
+		{ "bios-hash",		required_argument,	NULL, 'B' },
+		{ "budget",		required_argument,	NULL, 'b' },
+		{ "sentinel-pc",	required_argument,	NULL, 'p' },
+		{ "expect-tty",		required_argument,	NULL, 't' },
+		{ "format",		required_argument,	NULL, 'f' },
+		{ "output",		required_argument,	NULL, 'o' },
+		{ "profile",		required_argument,	NULL, 'P' },
+		{ "profile-interval",	required_argument,	NULL, 'I' },
+		{ "profile-symbols",	required_argument,	NULL, 'S' },
+		{ "coverage",		required_argument,	NULL, 'C' },
+		{ "watchdog-interval",	required_argument,	NULL, 'W' },
+		{ "hang-timeout",	required_argument,	NULL, 'H' },
+		{ NULL,			0,			NULL, 0 }
+
+		// clang-format on
+	};
+
+	int opt;
+
+	while ((opt = getopt_long(argc, argv, "j:B:b:p:t:f:o:P:I:S:C:W:H:",
+				  opts, NULL)) != -1) {
+		switch (opt) {
+		case 'j':
+			runner.num_workers = strtoul(optarg, NULL, 0);
+			break;
+
+		case 'B':
+			runner.bios_hash = optarg;
+			break;
+
+		case 'b':
+			runner.budget = strtoull(optarg, NULL, 0);
+			break;
+
+		case 'p':
+			runner.sentinel_pc = strtoul(optarg, NULL, 0);
+			runner.has_sentinel_pc = true;
+			break;
+
+		case 't':
+			runner.expect_tty = optarg;
+			break;
+
+		case 'f':
+			if (strcmp(optarg, "json") == 0)
+				runner.format = RUNNER_FORMAT_JSON;
+			else if (strcmp(optarg, "junit") == 0)
+				runner.format = RUNNER_FORMAT_JUNIT;
+			else
+				return false;
+			break;
+
+		case 'o':
+			runner.output = optarg;
+			break;
+
+		case 'P':
+			runner.profile_dir = optarg;
+			break;
+
+		case 'I':
+			runner.profile_interval = strtoull(optarg, NULL, 0);
+			break;
+
+		case 'S':
+			if (!profile_symbols_load(&runner.profile_syms,
+						  optarg)) {
+				fprintf(stderr, "unable to load %s: %s\n",
+					optarg, strerror(errno));
+				return false;
+			}
+			break;
+
+		case 'C':
+			runner.coverage_dir = optarg;
+			break;
+
+		case 'W':
+			runner.watchdog_interval = strtoull(optarg, NULL, 0);
+			break;
+
+		case 'H':
+			runner.hang_timeout = strtoull(optarg, NULL, 0);
+			break;
+
+		default:
+			return false;
+		}
+	}
+	return (argc - optind) == 2;
+}
+
+int main(int argc, char **argv)
+{
+	if (!args_parse(argc, argv)) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *const bios_file = argv[optind];
+	const char *const tests = argv[optind + 1];
+
+	const bool loaded = bios_image_inherited() ?
+				    bios_image_open_inherited(&runner.bios) :
+				    bios_image_open(&runner.bios, bios_file);
+
+	if (!loaded) {
+		fprintf(stderr,
+			"%s: error encountered loading bios file %s: %s\n",
+			argv[0], bios_file, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	if (runner.bios_hash &&
+	    !bios_image_expect(&runner.bios, runner.bios_hash)) {
+		fprintf(stderr, "%s: bios file %s has the hash %016" PRIX64
+				", not %s\n",
+			argv[0], bios_file, runner.bios.hash, runner.bios_hash);
+		return EXIT_FAILURE;
+	}
+
+	struct stat st;
+
+	if ((stat(tests, &st) < 0) ||
+	    !(S_ISDIR(st.st_mode) ? jobs_from_dir(tests) :
+				    jobs_from_manifest(tests))) {
+		fprintf(stderr,
+			"%s: error encountered loading tests from %s: %s\n",
+			argv[0], tests, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	if (!runner.num_workers) {
+		const long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		runner.num_workers = (num_cpus > 0) ? num_cpus : 1;
+	}
+
+	if (runner.num_workers > runner.num_jobs)
+		runner.num_workers = runner.num_jobs ? runner.num_jobs : 1;
+
+	struct runner_worker *const workers =
+		calloc(runner.num_workers, sizeof(*workers));
+
+	if (!workers) {
+		fprintf(stderr, "%s: out of memory\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (runner.coverage_dir && !coverage_alloc(&runner.coverage)) {
+		fprintf(stderr, "%s: out of memory\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const u64 start = clock_ns();
+	uint num_started = 0;
+
+	for (; num_started < runner.num_workers; ++num_started) {
+		struct runner_worker *const worker = &workers[num_started];
+		worker->ram = malloc(RAM_SIZE);
+
+		if (runner.coverage_dir &&
+		    !coverage_alloc(&worker->coverage)) {
+			free(worker->ram);
+			break;
+		}
+
+		if (!worker->ram || pthread_create(&worker->thread, NULL,
+						   worker_main, worker)) {
+			free(worker->ram);
+			coverage_free(&worker->coverage);
+			break;
+		}
+	}
+
+	if (!num_started) {
+		fprintf(stderr, "%s: unable to start any workers\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	for (uint i = 0; i < num_started; ++i) {
+		pthread_join(workers[i].thread, NULL);
+		free(workers[i].ram);
+		coverage_free(&workers[i].coverage);
+	}
+
+	if (runner.coverage_dir && !coverage_suite_write()) {
+		fprintf(stderr, "%s: unable to write coverage to %s: %s\n",
+			argv[0], runner.coverage_dir, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	const u64 wall_time_ns = clock_ns() - start;
+	FILE *const out = runner.output ? fopen(runner.output, "w") : stdout;
+
+	if (!out) {
+		fprintf(stderr, "%s: unable to open %s: %s\n", argv[0],
+			runner.output, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	runner_report(out, runner.format, runner.jobs, runner.num_jobs,
+		      wall_time_ns);
+
+	if (out != stdout)
+		fclose(out);
+
+	size_t num_passed = 0;
+
+	for (size_t i = 0; i < runner.num_jobs; ++i)
+		num_passed += runner.jobs[i].status == RUNNER_STATUS_PASS;
+
+	return (num_passed == runner.num_jobs) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
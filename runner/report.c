@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "frontend/clock.h"
+#include "runner.h"
+
+static void json_str(FILE *const out, const char *str)
+{
+	fputc('"', out);
+
+	for (; *str; ++str) {
+		const unsigned char c = *str;
+
+		switch (c) {
+		case '"':
+			fputs("\\\"", out);
+			break;
+
+		case '\\':
+			fputs("\\\\", out);
+			break;
+
+		case '\n':
+			fputs("\\n", out);
+			break;
+
+		case '\r':
+			fputs("\\r", out);
+			break;
+
+		case '\t':
+			fputs("\\t", out);
+			break;
+
+		default:
+			if (c < 0x20)
+				fprintf(out, "\\u%04X", c);
+			else
+				fputc(c, out);
+			break;
+		}
+	}
+	fputc('"', out);
+}
+
+static void xml_str(FILE *const out, const char *str)
+{
+	for (; *str; ++str) {
+		const unsigned char c = *str;
+
+		switch (c) {
+		case '<':
+			fputs("&lt;", out);
+			break;
+
+		case '>':
+			fputs("&gt;", out);
+			break;
+
+		case '&':
+			fputs("&amp;", out);
+			break;
+
+		case '"':
+			fputs("&quot;", out);
+			break;
+
+		default:
+			// XML 1.0 has no way of representing most control
+			// characters, not even as character references.
+			if ((c < 0x20) && (c != '\n') && (c != '\t'))
+				fputc('?', out);
+			else
+				fputc(c, out);
+			break;
+		}
+	}
+}
+
+static const char *runner_status_name(const enum runner_status status)
+{
+	switch (status) {
+	case RUNNER_STATUS_RUNNING:
+		return "running";
+
+	case RUNNER_STATUS_PASS:
+		return "pass";
+
+	case RUNNER_STATUS_TIMEOUT:
+		return "timeout";
+
+	case RUNNER_STATUS_HANG:
+		return "hang";
+
+	case RUNNER_STATUS_ILLEGAL:
+		return "illegal";
+
+	case RUNNER_STATUS_ERROR:
+		return "error";
+
+	default:
+		UNREACHABLE;
+	}
+}
+
+static void report_json(FILE *const out, const struct runner_job *const jobs,
+			const size_t num_jobs, const u64 wall_time_ns)
+{
+	u64 instructions = 0;
+	size_t passed = 0;
+
+	fputs("{\n\t\"tests\": [", out);
+
+	for (size_t i = 0; i < num_jobs; ++i) {
+		const struct runner_job *const job = &jobs[i];
+
+		instructions += job->instructions;
+		passed += job->status == RUNNER_STATUS_PASS;
+
+		fputs((i == 0) ? "\n\t\t{ \"name\": " : ",\n\t\t{ \"name\": ",
+		      out);
+		json_str(out, job->path);
+
+		fputs(", \"status\": ", out);
+		json_str(out, runner_status_name(job->status));
+
+		fputs(", \"reason\": ", out);
+		json_str(out, job->reason);
+
+		fprintf(out,
+			", \"instructions\": %" PRIu64
+			", \"wall_time_s\": %.6f, \"mips\": %.3f",
+			job->instructions, clock_ns_to_secs(job->wall_time_ns),
+			clock_mips(job->instructions, job->wall_time_ns));
+
+		fputs(", \"tty\": ", out);
+		json_str(out, job->tty ? job->tty : "");
+		fputs(" }", out);
+	}
+
+	fprintf(out,
+		"\n\t],\n\t\"summary\": { \"total\": %zu, \"passed\": %zu, "
+		"\"failed\": %zu, \"instructions\": %" PRIu64
+		", \"wall_time_s\": %.6f, \"mips\": %.3f }\n}\n",
+		num_jobs, passed, num_jobs - passed, instructions,
+		clock_ns_to_secs(wall_time_ns),
+		clock_mips(instructions, wall_time_ns));
+}
+
+static void report_junit(FILE *const out, const struct runner_job *const jobs,
+			 const size_t num_jobs, const u64 wall_time_ns)
+{
+	size_t failures = 0;
+	size_t errors = 0;
+
+	for (size_t i = 0; i < num_jobs; ++i) {
+		failures += (jobs[i].status == RUNNER_STATUS_TIMEOUT) ||
+			    (jobs[i].status == RUNNER_STATUS_HANG) ||
+			    (jobs[i].status == RUNNER_STATUS_ILLEGAL);
+		errors += jobs[i].status == RUNNER_STATUS_ERROR;
+	}
+
+	fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n", out);
+	fprintf(out,
+		"<testsuite name=\"psycho-runner\" tests=\"%zu\" "
+		"failures=\"%zu\" errors=\"%zu\" time=\"%.6f\">\n",
+		num_jobs, failures, errors, clock_ns_to_secs(wall_time_ns));
+
+	for (size_t i = 0; i < num_jobs; ++i) {
+		const struct runner_job *const job = &jobs[i];
+
+		fputs("\t<testcase classname=\"psycho\" name=\"", out);
+		xml_str(out, job->path);
+		fprintf(out, "\" time=\"%.6f\">\n",
+			clock_ns_to_secs(job->wall_time_ns));
+
+		fprintf(out,
+			"\t\t<properties>\n"
+			"\t\t\t<property name=\"instructions\" "
+			"value=\"%" PRIu64 "\"/>\n"
+			"\t\t\t<property name=\"mips\" value=\"%.3f\"/>\n"
+			"\t\t</properties>\n",
+			job->instructions,
+			clock_mips(job->instructions, job->wall_time_ns));
+
+		switch (job->status) {
+		case RUNNER_STATUS_PASS:
+			break;
+
+		case RUNNER_STATUS_TIMEOUT:
+		case RUNNER_STATUS_HANG:
+		case RUNNER_STATUS_ILLEGAL:
+			fputs("\t\t<failure message=\"", out);
+			xml_str(out, job->reason);
+			fprintf(out, "\" type=\"%s\"/>\n",
+				runner_status_name(job->status));
+			break;
+
+		case RUNNER_STATUS_RUNNING:
+		case RUNNER_STATUS_ERROR:
+		default:
+			fputs("\t\t<error message=\"", out);
+			xml_str(out, job->reason);
+			fputs("\"/>\n", out);
+			break;
+		}
+
+		if (job->tty_len) {
+			fputs("\t\t<system-out>", out);
+			xml_str(out, job->tty);
+			fputs("</system-out>\n", out);
+		}
+		fputs("\t</testcase>\n", out);
+	}
+	fputs("</testsuite>\n", out);
+}
+
+void runner_report(FILE *const out, const enum runner_format format,
+		   const struct runner_job *const jobs, const size_t num_jobs,
+		   const u64 wall_time_ns)
+{
+	switch (format) {
+	case RUNNER_FORMAT_JSON:
+		report_json(out, jobs, num_jobs, wall_time_ns);
+		return;
+
+	case RUNNER_FORMAT_JUNIT:
+		report_junit(out, jobs, num_jobs, wall_time_ns);
+		return;
+
+	default:
+		UNREACHABLE;
+	}
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright 2025 Michael Rodriguez
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "core/compiler.h"
+#include "core/types.h"
+
+enum runner_status {
+	/** @brief The test has not finished running yet. */
+	RUNNER_STATUS_RUNNING,
+
+	/** @brief The test reached its sentinel PC or expected TTY output. */
+	RUNNER_STATUS_PASS,
+
+	/** @brief The test exhausted its instruction budget. */
+	RUNNER_STATUS_TIMEOUT,
+
+	/** @brief The watchdog found the test to be hung. */
+	RUNNER_STATUS_HANG,
+
+	/** @brief The CPU executed an illegal instruction. */
+	RUNNER_STATUS_ILLEGAL,
+
+	/** @brief The test could not be loaded. */
+	RUNNER_STATUS_ERROR
+};
+
+struct runner_job {
+	/** @brief The path to the EXE file. */
+	char *path;
+
+	/** @brief The instruction budget, including booting the BIOS. */
+	u64 budget;
+
+	/** @brief The PC which ends the test successfully, if any. */
+	u32 sentinel_pc;
+	bool has_sentinel_pc;
+
+	/** @brief TTY output which ends the test successfully, if any. */
+	char *expect_tty;
+
+	/** @brief TTY output captured while the test ran. */
+	char *tty;
+	size_t tty_len;
+	size_t tty_capacity;
+
+	enum runner_status status;
+	const char *reason;
+
+	/**
+	 * @brief Backs @ref reason when it comes from `errno`, since workers
+	 * cannot share the buffer of strerror().
+	 */
+	char error[128];
+
+	u64 instructions;
+	u64 wall_time_ns;
+};
+
+enum runner_format {
+	RUNNER_FORMAT_JSON,
+	RUNNER_FORMAT_JUNIT
+};
+
+void runner_report(FILE *out, enum runner_format format,
+		   const struct runner_job *jobs, size_t num_jobs,
+		   u64 wall_time_ns);